@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <random>
 #include <set>
@@ -44,6 +45,8 @@ enum class Operation_t {
     LTE_OP = 14,
     EQ_OP = 15,
     NE_OP = 16,
+    CAS_OP = 17,
+    ANDN_OP = 18,
     MAX
 };
 
@@ -1,9 +1,11 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
 #include <csignal>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include "MAA.hpp"
 // #include "MAA_atomics.hpp"
@@ -91,13 +93,24 @@ template <class T1>
 inline volatile T1 get_reg(int reg_id) {
     return *((T1 *)(&(((volatile uint32_t *)REG_noncacheable)[reg_id])));
 }
+// Registers are written as whole words, sub-word values are zero-extended
 template <class T1>
-inline void set_reg(int reg_id, T1 data) {
+inline void write_reg(int reg_id, T1 data, std::true_type) {
+    uint32_t word = 0;
+    std::memcpy(&word, &data, sizeof(T1));
+    ((volatile uint32_t *)REG_noncacheable)[reg_id] = word;
+}
+template <class T1>
+inline void write_reg(int reg_id, T1 data, std::false_type) {
     *((T1 *)(&(((volatile uint32_t *)REG_noncacheable)[reg_id]))) = data;
 }
 template <class T1>
+inline void set_reg(int reg_id, T1 data) {
+    write_reg(reg_id, data, std::integral_constant<bool, (sizeof(T1) < sizeof(uint32_t))>());
+}
+template <class T1>
 inline int get_new_reg(T1 data) {
-    int num_regs_needed = sizeof(T1) / sizeof(uint32_t);
+    int num_regs_needed = sizeof(T1) <= sizeof(uint32_t) ? 1 : 2;
     assert(num_regs_needed == 1 || num_regs_needed == 2);
     int reg_id = REG_count;
     REG_count += num_regs_needed;
@@ -107,7 +120,7 @@ inline int get_new_reg(T1 data) {
 }
 template <class T1>
 inline int get_new_reg() {
-    int num_regs_needed = sizeof(T1) / sizeof(uint32_t);
+    int num_regs_needed = sizeof(T1) <= sizeof(uint32_t) ? 1 : 2;
     assert(num_regs_needed == 1 || num_regs_needed == 2);
     int reg_id = REG_count;
     REG_count += num_regs_needed;
@@ -116,7 +129,8 @@ inline int get_new_reg() {
 }
 template <class T1>
 inline int get_new_tile() {
-    int num_tiles_needed = sizeof(T1) / sizeof(uint32_t);
+    // Sub-word elements are packed in the low part of a single tile
+    int num_tiles_needed = sizeof(T1) <= sizeof(uint32_t) ? 1 : 2;
     assert(num_tiles_needed == 1 || num_tiles_needed == 2);
     int tile_id = SPD_count;
     SPD_count += num_tiles_needed;
@@ -125,7 +139,7 @@ inline int get_new_tile() {
 }
 template <class T1>
 void maa_const(T1 data, int dst_reg) {
-    *((T1 *)(&(((volatile uint32_t *)REG_noncacheable)[dst_reg]))) = data;
+    write_reg(dst_reg, data, std::integral_constant<bool, (sizeof(T1) < sizeof(uint32_t))>());
 }
 
 template <class T1>
@@ -228,6 +242,8 @@ uint32_t alu(uint32_t op1, uint32_t op2, Operation_t op) {
         return op1 | op2;
     case Operation_t::XOR_OP:
         return op1 ^ op2;
+    case Operation_t::ANDN_OP:
+        return op1 & ~op2;
     case Operation_t::SHL_OP:
         return op1 << op2;
     case Operation_t::SHR_OP:
@@ -268,6 +284,8 @@ uint64_t alu(uint64_t op1, uint64_t op2, Operation_t op) {
         return op1 | op2;
     case Operation_t::XOR_OP:
         return op1 ^ op2;
+    case Operation_t::ANDN_OP:
+        return op1 & ~op2;
     case Operation_t::SHL_OP:
         return op1 << op2;
     case Operation_t::SHR_OP:
@@ -308,6 +326,8 @@ int32_t alu(int32_t op1, int32_t op2, Operation_t op) {
         return op1 | op2;
     case Operation_t::XOR_OP:
         return op1 ^ op2;
+    case Operation_t::ANDN_OP:
+        return op1 & ~op2;
     case Operation_t::SHL_OP:
         return op1 << op2;
     case Operation_t::SHR_OP:
@@ -348,6 +368,8 @@ int64_t alu(int64_t op1, int64_t op2, Operation_t op) {
         return op1 | op2;
     case Operation_t::XOR_OP:
         return op1 ^ op2;
+    case Operation_t::ANDN_OP:
+        return op1 & ~op2;
     case Operation_t::SHL_OP:
         return op1 << op2;
     case Operation_t::SHR_OP:
@@ -390,6 +412,7 @@ inline void maa_alu_scalar(int src1_tile, int src2_reg, int dst_tile, Operation_
     case Operation_t::AND_OP:
     case Operation_t::OR_OP:
     case Operation_t::XOR_OP:
+    case Operation_t::ANDN_OP:
     case Operation_t::SHL_OP:
     case Operation_t::SHR_OP: {
 #pragma omp parallel for
@@ -431,7 +454,7 @@ inline void maa_alu_reduce(int src1_tile, int dst_reg, Operation_t op, int cond_
         break;
     }
     case Operation_t::MAX_OP: {
-        result = std::numeric_limits<T1>::min();
+        result = std::numeric_limits<T1>::lowest();
         break;
     }
     case Operation_t::AND_OP: {
@@ -458,6 +481,77 @@ inline void maa_alu_reduce(int src1_tile, int dst_reg, Operation_t op, int cond_
     set_tile_ready(src1_tile, 1);
 }
 template <class T1>
+inline void maa_alu_segmented_scan(int src1_tile, int flag_tile, int dst_tile, Operation_t op, bool exclusive = false, int carry_reg = -1, int cond_tile = -1) {
+    T1 identity;
+    switch (op) {
+    case Operation_t::ADD_OP: {
+        identity = 0;
+        break;
+    }
+    case Operation_t::MIN_OP: {
+        identity = std::numeric_limits<T1>::max();
+        break;
+    }
+    case Operation_t::MAX_OP: {
+        identity = std::numeric_limits<T1>::lowest();
+        break;
+    }
+    default:
+        assert(false);
+    }
+    T1 *dst = get_cacheable_tile_pointer<T1>(dst_tile);
+    T1 *src1 = get_cacheable_tile_pointer<T1>(src1_tile);
+    int src_size = get_tile_size(src1_tile);
+    uint32_t *flags = nullptr;
+    if (flag_tile != -1)
+        flags = get_cacheable_tile_pointer<uint32_t>(flag_tile);
+    uint32_t *cond_array = nullptr;
+    if (cond_tile != -1)
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+    T1 carry = carry_reg == -1 ? identity : get_reg<T1>(carry_reg);
+    for (int i = 0; i < src_size; i++) {
+        if (flag_tile != -1 && flags[i])
+            carry = identity;
+        if (exclusive)
+            dst[i] = carry;
+        if (cond_tile == -1 || cond_array[i])
+            carry = alu(src1[i], carry, op);
+        if (!exclusive)
+            dst[i] = carry;
+    }
+    if (carry_reg != -1)
+        maa_const<T1>(carry, carry_reg);
+    set_tile_size(dst_tile, src_size);
+    set_tile_ready(dst_tile, 1);
+}
+template <class T1>
+inline void maa_alu_scan(int src1_tile, int dst_tile, Operation_t op, bool exclusive = false, int carry_reg = -1, int cond_tile = -1) {
+    maa_alu_segmented_scan<T1>(src1_tile, -1, dst_tile, op, exclusive, carry_reg, cond_tile);
+}
+template <class T1>
+inline void maa_alu_histogram(int id_tile, int bounds_reg, int dst_tile, int weight_tile = -1, int cond_tile = -1) {
+    T1 *dst = get_cacheable_tile_pointer<T1>(dst_tile);
+    uint32_t *ids = get_cacheable_tile_pointer<uint32_t>(id_tile);
+    int id_size = get_tile_size(id_tile);
+    T1 *weights = nullptr;
+    if (weight_tile != -1)
+        weights = get_cacheable_tile_pointer<T1>(weight_tile);
+    uint32_t *cond_array = nullptr;
+    if (cond_tile != -1)
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+    int num_buckets = get_reg<int>(bounds_reg);
+    assert(num_buckets > 0 && num_buckets <= TILE_SIZE);
+    for (int b = 0; b < num_buckets; b++)
+        dst[b] = 0;
+    for (int i = 0; i < id_size; i++) {
+        if ((cond_tile == -1 || cond_array[i]) && ids[i] < (uint32_t)num_buckets) {
+            dst[ids[i]] += weight_tile == -1 ? (T1)1 : weights[i];
+        }
+    }
+    set_tile_size(dst_tile, num_buckets);
+    set_tile_ready(dst_tile, 1);
+}
+template <class T1>
 inline void maa_alu_vector(int src1_tile, int src2_tile, int dst_tile, Operation_t op, int cond_tile = -1) {
     T1 *dst_T = get_cacheable_tile_pointer<T1>(dst_tile);
     uint32_t *dst_u32 = get_cacheable_tile_pointer<uint32_t>(dst_tile);
@@ -490,6 +584,7 @@ inline void maa_alu_vector(int src1_tile, int src2_tile, int dst_tile, Operation
     case Operation_t::AND_OP:
     case Operation_t::OR_OP:
     case Operation_t::XOR_OP:
+    case Operation_t::ANDN_OP:
     case Operation_t::SHL_OP:
     case Operation_t::SHR_OP: {
 #pragma omp parallel for
@@ -506,6 +601,67 @@ inline void maa_alu_vector(int src1_tile, int src2_tile, int dst_tile, Operation
     set_tile_size(dst_tile, src_size);
     set_tile_ready(dst_tile, 1);
 }
+template <class T1>
+inline void maa_alu_compact(int src1_tile, int cond_tile, int dst_tile, int idx_tile = -1) {
+    T1 *dst = get_cacheable_tile_pointer<T1>(dst_tile);
+    T1 *src1 = get_cacheable_tile_pointer<T1>(src1_tile);
+    uint32_t *cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+    uint32_t *idx = nullptr;
+    if (idx_tile != -1)
+        idx = get_cacheable_tile_pointer<uint32_t>(idx_tile);
+    int src_size = get_tile_size(src1_tile);
+    int num_packed = 0;
+    for (int i = 0; i < src_size; i++) {
+        if (cond_array[i]) {
+            dst[num_packed] = src1[i];
+            if (idx_tile != -1)
+                idx[num_packed] = i;
+            num_packed++;
+        }
+    }
+    set_tile_size(dst_tile, num_packed);
+    set_tile_ready(dst_tile, 1);
+    if (idx_tile != -1) {
+        set_tile_size(idx_tile, num_packed);
+        set_tile_ready(idx_tile, 1);
+    }
+}
+// Floats saturate to the integer destination range and NaNs become zero
+template <class T2, class T1>
+inline T2 convert_element(T1 src, std::true_type) {
+    double value = (double)src;
+    if (value != value) {
+        return 0;
+    } else if (value <= (double)std::numeric_limits<T2>::min()) {
+        return std::numeric_limits<T2>::min();
+    } else if (value >= (double)std::numeric_limits<T2>::max()) {
+        return std::numeric_limits<T2>::max();
+    }
+    return (T2)value;
+}
+template <class T2, class T1>
+inline T2 convert_element(T1 src, std::false_type) {
+    return (T2)src;
+}
+template <class T1, class T2>
+inline void maa_alu_convert(int src1_tile, int dst_tile, int cond_tile = -1) {
+    T2 *dst = get_cacheable_tile_pointer<T2>(dst_tile);
+    T1 *src1 = get_cacheable_tile_pointer<T1>(src1_tile);
+    uint32_t *cond_array = nullptr;
+    if (cond_tile != -1)
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+    int src_size = get_tile_size(src1_tile);
+#pragma omp parallel for
+    for (int i = 0; i < src_size; i++) {
+        if (cond_tile != -1 && cond_array[i] == 0) {
+            dst[i] = T2(0);
+        } else {
+            dst[i] = convert_element<T2>(src1[i], std::integral_constant<bool, (std::is_integral<T2>::value && !std::is_integral<T1>::value)>());
+        }
+    }
+    set_tile_size(dst_tile, src_size);
+    set_tile_ready(dst_tile, 1);
+}
 int8_t get_region(void *data) {
     if (thread_id != pthread_self()) {
         return -1;
@@ -589,6 +745,67 @@ inline void maa_indirect_load(T1 *data, int idx_tile, int dst_tile, int cond_til
     set_tile_ready(dst_tile, 1);
 }
 template <class T1>
+inline void maa_indirect_load_chained(T1 *data, uint32_t *indices, int idx_tile, int dst_tile, int cond_tile = -1) {
+    T1 *dst = get_cacheable_tile_pointer<T1>(dst_tile);
+    int *idx_array = get_cacheable_tile_pointer<int>(idx_tile);
+    int index_size = get_tile_size(idx_tile);
+    uint32_t *cond_array = nullptr;
+    if (cond_tile != -1)
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+    int8_t indices_region = get_region(indices);
+    int8_t data_region = get_region(data);
+    for (int idx = 0; idx < index_size; idx++) {
+        if (cond_tile == -1 || cond_array[idx]) {
+            assert(check_region(indices_region, indices + idx_array[idx]));
+            assert(check_region(data_region, data + indices[idx_array[idx]]));
+            dst[idx] = data[indices[idx_array[idx]]];
+        }
+    }
+    set_tile_size(dst_tile, index_size);
+    set_tile_ready(dst_tile, 1);
+}
+template <class T1>
+inline void maa_hash_probe(void *buckets, int mask_reg, int skip_reg, int layout_reg, int key_tile, int payload_tile, int match_tile, int cond_tile = -1) {
+    static_assert(sizeof(T1) == 4, "probe supports only 4-byte keys");
+    T1 *payloads = get_cacheable_tile_pointer<T1>(payload_tile);
+    uint32_t *matches = get_cacheable_tile_pointer<uint32_t>(match_tile);
+    uint32_t *keys = get_cacheable_tile_pointer<uint32_t>(key_tile);
+    int key_size = get_tile_size(key_tile);
+    uint32_t *cond_array = nullptr;
+    if (cond_tile != -1)
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+    uint32_t mask = get_reg<uint32_t>(mask_reg);
+    uint32_t skip = get_reg<uint32_t>(skip_reg);
+    uint32_t layout = get_reg<uint32_t>(layout_reg);
+    uint32_t stride = layout & 0xFFFF;
+    uint32_t num_tuples = layout >> 16;
+    int8_t region = get_region(buckets);
+    for (int idx = 0; idx < key_size; idx++) {
+        matches[idx] = 0;
+        if (cond_tile == -1 || cond_array[idx]) {
+            uint8_t *bucket = (uint8_t *)buckets + ((keys[idx] & mask) >> skip) * stride;
+            assert(check_region(region, bucket));
+            uint32_t count = std::min(((uint32_t *)bucket)[1], num_tuples);
+            uint32_t *tuples = (uint32_t *)(bucket + 8);
+            payloads[idx] = 0;
+            for (uint32_t j = 0; j < count; j++) {
+                if (tuples[2 * j] == keys[idx]) {
+                    std::memcpy(&payloads[idx], &tuples[2 * j + 1], sizeof(T1));
+                    matches[idx] = 1;
+                    break;
+                }
+            }
+            if (*(uint64_t *)(bucket + 8 + 8 * num_tuples) != 0) {
+                matches[idx] = matches[idx] == 1 ? 3 : 2;
+            }
+        }
+    }
+    set_tile_size(payload_tile, key_size);
+    set_tile_size(match_tile, key_size);
+    set_tile_ready(payload_tile, 1);
+    set_tile_ready(match_tile, 1);
+}
+template <class T1>
 inline void maa_indirect_store_vector(T1 *data, int idx_tile, int src_tile, int cond_tile = -1, int dst_tile = -1) {
     volatile T1 *src = get_cacheable_tile_pointer<T1>(src_tile);
     int *indices = get_cacheable_tile_pointer<int>(idx_tile);
@@ -731,6 +948,119 @@ inline void maa_indirect_rmw_scalar(T1 *data, int idx_tile, int src_reg, Operati
         set_tile_size(dst_tile, index_size);
     }
 }
+template <class T1>
+inline void maa_indirect_cas(T1 *data, int idx_tile, volatile T1 *new_values, bool is_scalar, int expected_tile, int success_tile, int cond_tile) {
+    int *indices = get_cacheable_tile_pointer<int>(idx_tile);
+    int index_size = get_tile_size(idx_tile);
+    volatile T1 *expected = get_cacheable_tile_pointer<T1>(expected_tile);
+    uint32_t *cond_array = nullptr;
+    uint32_t *success = nullptr;
+    if (cond_tile != -1) {
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+        assert(index_size == get_tile_size(cond_tile));
+    }
+    if (success_tile != -1) {
+        success = get_cacheable_tile_pointer<uint32_t>(success_tile);
+    }
+
+    int8_t region = get_region(data);
+    for (int idx = 0; idx < index_size; idx++) {
+        uint32_t swapped = 0;
+        if (cond_tile == -1 || cond_array[idx]) {
+            assert(check_region(region, data + indices[idx]));
+            // Words are compared bitwise, as the hardware does
+            T1 old_value = data[indices[idx]];
+            T1 expected_value = expected[idx];
+            if (std::memcmp(&old_value, &expected_value, sizeof(T1)) == 0) {
+                data[indices[idx]] = new_values[is_scalar ? 0 : idx];
+                swapped = 1;
+            }
+            expected[idx] = old_value;
+        }
+        if (success_tile != -1) {
+            success[idx] = swapped;
+        }
+    }
+    set_tile_ready(expected_tile, 1);
+    set_tile_size(expected_tile, index_size);
+    if (success_tile != -1) {
+        set_tile_ready(success_tile, 1);
+        set_tile_size(success_tile, index_size);
+    }
+}
+template <class T1>
+inline void maa_indirect_cas_vector(T1 *data, int idx_tile, int new_tile, int expected_tile, int success_tile = -1, int cond_tile = -1) {
+    assert(get_tile_size(idx_tile) == get_tile_size(new_tile));
+    maa_indirect_cas<T1>(data, idx_tile, get_cacheable_tile_pointer<T1>(new_tile), false, expected_tile, success_tile, cond_tile);
+    set_tile_ready(new_tile, 1);
+}
+template <class T1>
+inline void maa_indirect_cas_scalar(T1 *data, int idx_tile, int new_reg, int expected_tile, int success_tile = -1, int cond_tile = -1) {
+    T1 new_value = get_reg<T1>(new_reg);
+    maa_indirect_cas<T1>(data, idx_tile, &new_value, true, expected_tile, success_tile, cond_tile);
+}
+// Bitmap tiles pack 8 elements per byte, element i is bit (i & 7) of byte (i >> 3), and their sizes count bytes
+inline void maa_bitmap_vector(int src1_tile, int src2_tile, int dst_tile, Operation_t op) {
+    uint8_t *src1 = get_cacheable_tile_pointer<uint8_t>(src1_tile);
+    uint8_t *src2 = get_cacheable_tile_pointer<uint8_t>(src2_tile);
+    uint8_t *dst = get_cacheable_tile_pointer<uint8_t>(dst_tile);
+    int src_size = get_tile_size(src1_tile);
+    assert(src_size == get_tile_size(src2_tile));
+    assert(op == Operation_t::AND_OP || op == Operation_t::OR_OP || op == Operation_t::XOR_OP || op == Operation_t::ANDN_OP);
+    for (int i = 0; i < src_size; i++) {
+        dst[i] = (uint8_t)alu((uint32_t)src1[i], (uint32_t)src2[i], op);
+    }
+    set_tile_size(dst_tile, src_size);
+    set_tile_ready(dst_tile, 1);
+}
+inline void maa_bitmap_popcount(int src1_tile, int dst_reg) {
+    uint8_t *src1 = get_cacheable_tile_pointer<uint8_t>(src1_tile);
+    int src_size = get_tile_size(src1_tile);
+    uint32_t count = 0;
+    for (int i = 0; i < src_size; i++) {
+        count += __builtin_popcount(src1[i]);
+    }
+    set_reg<uint32_t>(dst_reg, count);
+}
+inline void maa_indirect_bits(void *bitmap, int idx_tile, int dst_tile, int cond_tile, bool set) {
+    uint8_t *data = (uint8_t *)bitmap;
+    int *indices = get_cacheable_tile_pointer<int>(idx_tile);
+    int index_size = get_tile_size(idx_tile);
+    uint32_t *cond_array = nullptr;
+    uint8_t *dst = nullptr;
+    if (cond_tile != -1) {
+        cond_array = get_cacheable_tile_pointer<uint32_t>(cond_tile);
+        assert(index_size == get_tile_size(cond_tile));
+    }
+    if (dst_tile != -1) {
+        dst = get_cacheable_tile_pointer<uint8_t>(dst_tile);
+        memset(dst, 0, (index_size + 7) / 8);
+    }
+    int8_t region = get_region(bitmap);
+    for (int idx = 0; idx < index_size; idx++) {
+        if (cond_tile == -1 || cond_array[idx]) {
+            uint8_t *byte = data + (indices[idx] >> 3);
+            uint8_t mask = 1 << (indices[idx] & 7);
+            assert(check_region(region, byte));
+            if (dst_tile != -1 && (*byte & mask) != 0) {
+                dst[idx >> 3] |= 1 << (idx & 7);
+            }
+            if (set) {
+                *byte |= mask;
+            }
+        }
+    }
+    if (dst_tile != -1) {
+        set_tile_ready(dst_tile, 1);
+        set_tile_size(dst_tile, (index_size + 7) / 8);
+    }
+}
+inline void maa_indirect_test_bits(void *bitmap, int idx_tile, int dst_tile, int cond_tile = -1) {
+    maa_indirect_bits(bitmap, idx_tile, dst_tile, cond_tile, false);
+}
+inline void maa_indirect_test_and_set_bits(void *bitmap, int idx_tile, int dst_tile = -1, int cond_tile = -1) {
+    maa_indirect_bits(bitmap, idx_tile, dst_tile, cond_tile, true);
+}
 // for each tile of i, set last_i_reg to 0 and last_j_reg to -1
 template <class T1>
 inline void maa_range_loop(int last_i_reg, int last_j_reg, int min_tile, int max_tile, int stride_reg, int dst_i_tile, int dst_j_tile, int cond_tile = -1) {
@@ -773,4 +1103,17 @@ inline void maa_range_loop(int last_i_reg, int last_j_reg, int min_tile, int max
     set_tile_ready(dst_j_tile, 1);
     set_tile_size(dst_i_tile, idxj == -1 ? TILE_SIZE : idxj);
     set_tile_ready(dst_i_tile, 1);
-}
\ No newline at end of file
+}// Odd iterations use alt_induction_reg and alt_tile_offset, like the replayed hardware loop
+template <class T1, class Body>
+inline void maa_loop(int induction_reg, int bound_reg, int stride_reg, Body body, int alt_induction_reg = -1, int alt_tile_offset = 0) {
+    T1 bound = get_reg<T1>(bound_reg);
+    T1 stride = get_reg<T1>(stride_reg);
+    assert(stride > 0);
+    int iteration = 0;
+    for (T1 induction = get_reg<T1>(induction_reg); induction < bound; induction += stride, iteration++) {
+        bool is_alternate = iteration % 2 == 1;
+        int reg = (is_alternate && alt_induction_reg != -1) ? alt_induction_reg : induction_reg;
+        set_reg<T1>(reg, induction);
+        body(reg, is_alternate ? alt_tile_offset : 0);
+    }
+}
@@ -35,7 +35,16 @@ enum OpcodeType : uint8_t {
     RANGE_LOOP = 7,
     ALU_SCALAR = 8,
     ALU_VECTOR = 9,
-    ALU_REDUCE = 10
+    ALU_REDUCE = 10,
+    INDIR_LD_CHAINED = 11,
+    INDIR_PROBE = 12,
+    ALU_COMPACT = 13,
+    ALU_SCAN = 14,
+    ALU_SCAN_EXCL = 15,
+    ALU_HISTOGRAM = 16,
+    ALU_CVT = 17,
+    LOOP_BEGIN = 18,
+    LOOP_END = 19
 };
 enum class DataType : uint8_t {
     UINT32_TYPE = 0,
@@ -44,12 +53,20 @@ enum class DataType : uint8_t {
     UINT64_TYPE = 3,
     INT64_TYPE = 4,
     FLOAT64_TYPE = 5,
+    UINT8_TYPE = 6,
+    INT8_TYPE = 7,
+    UINT16_TYPE = 8,
+    INT16_TYPE = 9,
+    FLOAT16_TYPE = 10,
+    BFLOAT16_TYPE = 11,
+    BIT_TYPE = 12,
     MAX
 };
 
 volatile uint64_t *INSTR_opcode_datatype_optype_tdst1_tdst2;
 volatile uint64_t *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc;
 volatile uint64_t *INSTR_baseaddr;
+volatile uint64_t *INSTR_baseaddr2;
 uint64_t MAA_end_addr;
 int8_t region_count;
 
@@ -86,6 +103,8 @@ void alloc_MAA() {
     current_addr += 8;
     INSTR_baseaddr = (volatile uint64_t *)(current_addr);
     current_addr += 8;
+    INSTR_baseaddr2 = (volatile uint64_t *)(current_addr);
+    current_addr += 8;
     MAA_end_addr = current_addr;
     clear_mem_region();
 }
@@ -110,14 +129,25 @@ inline volatile T1 get_reg(int reg_id) {
     __asm__ __volatile__("mfence;");
     return data;
 }
+// Registers are written as whole words, sub-word values are zero-extended
 template <class T1>
-inline void set_reg(int reg_id, T1 data) {
+inline void write_reg(int reg_id, T1 data, std::true_type) {
+    uint32_t word = 0;
+    std::memcpy(&word, &data, sizeof(T1));
+    ((volatile uint32_t *)REG_noncacheable)[reg_id] = word;
+}
+template <class T1>
+inline void write_reg(int reg_id, T1 data, std::false_type) {
     *((T1 *)(&(((volatile uint32_t *)REG_noncacheable)[reg_id]))) = data;
+}
+template <class T1>
+inline void set_reg(int reg_id, T1 data) {
+    write_reg(reg_id, data, std::integral_constant<bool, (sizeof(T1) < sizeof(uint32_t))>());
     __asm__ __volatile__("mfence;");
 }
 template <class T1>
 inline int get_new_reg(T1 data) {
-    int num_regs_needed = sizeof(T1) / sizeof(uint32_t);
+    int num_regs_needed = sizeof(T1) <= sizeof(uint32_t) ? 1 : 2;
     assert(num_regs_needed == 1 || num_regs_needed == 2);
     int reg_id = REG_count;
     REG_count += num_regs_needed;
@@ -127,7 +157,7 @@ inline int get_new_reg(T1 data) {
 }
 template <class T1>
 inline int get_new_reg() {
-    int num_regs_needed = sizeof(T1) / sizeof(uint32_t);
+    int num_regs_needed = sizeof(T1) <= sizeof(uint32_t) ? 1 : 2;
     assert(num_regs_needed == 1 || num_regs_needed == 2);
     int reg_id = REG_count;
     REG_count += num_regs_needed;
@@ -136,7 +166,8 @@ inline int get_new_reg() {
 }
 template <class T1>
 inline int get_new_tile() {
-    int num_tiles_needed = sizeof(T1) / sizeof(uint32_t);
+    // Sub-word elements are packed in the low part of a single tile
+    int num_tiles_needed = sizeof(T1) <= sizeof(uint32_t) ? 1 : 2;
     assert(num_tiles_needed == 1 || num_tiles_needed == 2);
     int tile_id = SPD_count;
     SPD_count += num_tiles_needed;
@@ -145,7 +176,7 @@ inline int get_new_tile() {
 }
 template <class T1>
 void maa_const(T1 data, int dst_reg) {
-    *((T1 *)(&(((volatile uint32_t *)REG_noncacheable)[dst_reg]))) = data;
+    write_reg(dst_reg, data, std::integral_constant<bool, (sizeof(T1) < sizeof(uint32_t))>());
 }
 
 template <class T1>
@@ -169,8 +200,24 @@ DataType get_data_type() {
            : std::is_same<T1, uint64_t>::value ? DataType::UINT64_TYPE
            : std::is_same<T1, int64_t>::value  ? DataType::INT64_TYPE
            : std::is_same<T1, double>::value   ? DataType::FLOAT64_TYPE
+           : std::is_same<T1, uint8_t>::value  ? DataType::UINT8_TYPE
+           : std::is_same<T1, int8_t>::value   ? DataType::INT8_TYPE
+           : std::is_same<T1, uint16_t>::value ? DataType::UINT16_TYPE
+           : std::is_same<T1, int16_t>::value  ? DataType::INT16_TYPE
                                                : DataType::MAX;
 }
+#ifdef __FLT16_MAX__
+template <>
+inline DataType get_data_type<_Float16>() {
+    return DataType::FLOAT16_TYPE;
+}
+#endif
+#ifdef __BFLT16_MAX__
+template <>
+inline DataType get_data_type<__bf16>() {
+    return DataType::BFLOAT16_TYPE;
+}
+#endif
 template <class T1>
 inline void maa_alu_scalar(int src1_tile, int src2_reg, int dst_tile, Operation_t op, int cond_tile = -1) {
     DataType data_type = get_data_type<T1>();
@@ -209,6 +256,96 @@ inline void maa_alu_vector(int src1_tile, int src2_tile, int dst_tile, Operation
     *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
     __asm__ __volatile__("mfence;");
 }
+// dst[i] = (T2)src1[i], floats going to integers saturate and integers keep their low bits when narrowed
+template <class T1, class T2>
+inline void maa_alu_convert(int src1_tile, int dst_tile, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    DataType dst_data_type = get_data_type<T2>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::ALU_CVT << 32) |                         // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)dst_data_type << 16) |                               // optype
+                                                ((uint64_t)dst_tile << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)src1_tile << 56) |                       // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// Packs the elements of src1_tile whose cond_tile entry is nonzero into dst_tile and sets its size
+// to the number of survivors. If idx_tile is given, it receives the original index of each survivor.
+template <class T1>
+inline void maa_alu_compact(int src1_tile, int cond_tile, int dst_tile, int idx_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::ALU_COMPACT << 32) |                     // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)dst_tile << 8) |                                     // tdst1
+                                                (uint64_t)(idx_tile == -1 ? NA_UINT8 : idx_tile);               // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)src1_tile << 56) |                       // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)cond_tile;                                // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// Inclusive or exclusive ADD/MIN/MAX scan of src1_tile into dst_tile. A nonzero flag_tile entry
+// restarts the scan at that element. carry_reg, if given, holds the starting value and receives
+// the final running value, so a scan can continue across tiles. Masked elements do not contribute.
+template <class T1>
+inline void maa_alu_segmented_scan(int src1_tile, int flag_tile, int dst_tile, Operation_t op, bool exclusive = false, int carry_reg = -1, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    OpcodeType opcode = exclusive ? OpcodeType::ALU_SCAN_EXCL : OpcodeType::ALU_SCAN;
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)opcode << 32) |                                      // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)op << 16) |                                          // optype
+                                                ((uint64_t)dst_tile << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)src1_tile << 56) |                       // tsrc1
+                                                            ((uint64_t)(flag_tile == -1 ? NA_UINT8 : flag_tile) << 48) | // tsrc2
+                                                            ((uint64_t)(carry_reg == -1 ? NA_UINT8 : carry_reg) << 40) | // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)(carry_reg == -1 ? NA_UINT8 : carry_reg) << 24) | // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+template <class T1>
+inline void maa_alu_scan(int src1_tile, int dst_tile, Operation_t op, bool exclusive = false, int carry_reg = -1, int cond_tile = -1) {
+    maa_alu_segmented_scan<T1>(src1_tile, -1, dst_tile, op, exclusive, carry_reg, cond_tile);
+}
+// dst_tile[b] = number of elements of id_tile equal to b (or the sum of their weight_tile entries),
+// for b in [0, bounds_reg). Ids out of bounds are dropped. The counts stay in the SPD.
+template <class T1>
+inline void maa_alu_histogram(int id_tile, int bounds_reg, int dst_tile, int weight_tile = -1, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::ALU_HISTOGRAM << 32) |                   // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)dst_tile << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)id_tile << 56) |                         // tsrc1
+                                                            ((uint64_t)(weight_tile == -1 ? NA_UINT8 : weight_tile) << 48) | // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)bounds_reg << 24) |                      // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
 template <class T1>
 inline void maa_alu_reduce(int src1_tile, int dst_reg, Operation_t op, int cond_tile = -1) {
     DataType data_type = get_data_type<T1>();
@@ -228,6 +365,43 @@ inline void maa_alu_reduce(int src1_tile, int dst_reg, Operation_t op, int cond_
     *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
     __asm__ __volatile__("mfence;");
 }
+// Bitmap tiles pack 8 elements per byte, element i is bit (i & 7) of byte (i >> 3), and their sizes count bytes.
+// Bitmaps are streamed in and out as uint8_t tiles. dst = src1 op src2 for op in AND, OR, XOR, ANDN (src1 & ~src2)
+inline void maa_bitmap_vector(int src1_tile, int src2_tile, int dst_tile, Operation_t op) {
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::ALU_VECTOR << 32) |                      // opcode
+                                                ((uint64_t)DataType::BIT_TYPE << 24) |                          // datatype
+                                                ((uint64_t)op << 16) |                                          // optype
+                                                ((uint64_t)dst_tile << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)src1_tile << 56) |                       // tsrc1
+                                                            ((uint64_t)src2_tile << 48) |                       // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)NA_UINT8;                                 // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// dst_reg = number of set bits of the bitmap tile
+inline void maa_bitmap_popcount(int src1_tile, int dst_reg) {
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::ALU_REDUCE << 32) |                      // opcode
+                                                ((uint64_t)DataType::BIT_TYPE << 24) |                          // datatype
+                                                ((uint64_t)Operation_t::ADD_OP << 16) |                         // optype
+                                                ((uint64_t)NA_UINT8 << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)src1_tile << 56) |                       // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)dst_reg << 40) |                         // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)NA_UINT8;                                 // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
 template <class T1>
 inline void maa_stream_load(T1 *data, int min_reg, int max_reg, int stride_reg, int dst_tile, int cond_tile = -1) {
     DataType data_type = get_data_type<T1>();
@@ -285,6 +459,51 @@ inline void maa_indirect_load(T1 *data, int idx_tile, int dst_tile, int cond_til
     *INSTR_baseaddr = (uint64_t)data;                                                                           // baseaddr
     __asm__ __volatile__("mfence;");
 }
+// dst[i] = data[indices[idx[i]]], the second base address must be written before the first one
+template <class T1>
+inline void maa_indirect_load_chained(T1 *data, uint32_t *indices, int idx_tile, int dst_tile, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::INDIR_LD_CHAINED << 32) |                // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)dst_tile << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)idx_tile << 56) |                        // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr2 = (uint64_t)data;                                                                          // baseaddr2
+    *INSTR_baseaddr = (uint64_t)indices;                                                                        // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// Probes the head bucket of each key in key_tile, bucket = buckets + ((key & mask) >> skip) * stride.
+// Buckets are {latch, count, tuples[num_tuples] = {key, payload}, next} and must not cross a cache line.
+// layout_reg holds (num_tuples << 16) | stride. match_tile is 0 on a miss, 1 on a hit,
+// 2 if the key is not in the head bucket but the bucket has an overflow chain, and 3 on
+// a hit in a bucket with an overflow chain, where duplicate keys may have more tuples.
+template <class T1>
+inline void maa_hash_probe(void *buckets, int mask_reg, int skip_reg, int layout_reg, int key_tile, int payload_tile, int match_tile, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::INDIR_PROBE << 32) |                     // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)payload_tile << 8) |                                 // tdst1
+                                                (uint64_t)match_tile;                                           // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)key_tile << 56) |                        // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)mask_reg << 24) |                        // rsrc1
+                                                            ((uint64_t)skip_reg << 16) |                        // rsrc2
+                                                            ((uint64_t)layout_reg << 8) |                       // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr = (uint64_t)buckets;                                                                        // baseaddr
+    __asm__ __volatile__("mfence;");
+}
 template <class T1>
 inline void maa_indirect_store_vector(T1 *data, int idx_tile, int src_tile, int cond_tile = -1, int dst_tile = -1) {
     DataType data_type = get_data_type<T1>();
@@ -361,6 +580,82 @@ inline void maa_indirect_rmw_scalar(T1 *data, int idx_tile, int src_reg, Operati
     *INSTR_baseaddr = (uint64_t)data;                                                                           // baseaddr
     __asm__ __volatile__("mfence;");
 }
+// data[idx[i]] = new[i] if it equals expected[i], expected[i] gets the old value and success[i] is 1 if swapped
+template <class T1>
+inline void maa_indirect_cas_vector(T1 *data, int idx_tile, int new_tile, int expected_tile, int success_tile = -1, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::INDIR_RMW_VECTOR << 32) |                  // opcode
+                                                ((uint64_t)data_type << 24) |                                     // datatype
+                                                ((uint64_t)Operation_t::CAS_OP << 16) |                           // optype
+                                                ((uint64_t)expected_tile << 8) |                                  // tdst1
+                                                (uint64_t)(success_tile == -1 ? NA_UINT8 : success_tile);         // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)idx_tile << 56) |                          // tsrc1
+                                                            ((uint64_t)new_tile << 48) |                          // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                          // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                          // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                          // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                          // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                           // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile);   // cond
+    *INSTR_baseaddr = (uint64_t)data;                                                                             // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// data[idx[i]] = new_reg if it equals expected[i], expected[i] gets the old value and success[i] is 1 if swapped
+template <class T1>
+inline void maa_indirect_cas_scalar(T1 *data, int idx_tile, int new_reg, int expected_tile, int success_tile = -1, int cond_tile = -1) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::INDIR_RMW_SCALAR << 32) |                  // opcode
+                                                ((uint64_t)data_type << 24) |                                     // datatype
+                                                ((uint64_t)Operation_t::CAS_OP << 16) |                           // optype
+                                                ((uint64_t)expected_tile << 8) |                                  // tdst1
+                                                (uint64_t)(success_tile == -1 ? NA_UINT8 : success_tile);         // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)idx_tile << 56) |                          // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                          // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                          // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                          // rdst2
+                                                            ((uint64_t)new_reg << 24) |                           // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                          // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                           // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile);   // cond
+    *INSTR_baseaddr = (uint64_t)data;                                                                             // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// dst[i] = bit idx[i] of the bitmap, the bits are packed in dst_tile
+inline void maa_indirect_test_bits(void *bitmap, int idx_tile, int dst_tile, int cond_tile = -1) {
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::INDIR_LD << 32) |                        // opcode
+                                                ((uint64_t)DataType::BIT_TYPE << 24) |                          // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)(dst_tile == -1 ? NA_UINT8 : dst_tile) << 8) |       // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)idx_tile << 56) |                        // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr = (uint64_t)bitmap;                                                                         // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// dst[i] = bit idx[i] of the bitmap, then the bit is set. Of the elements setting the same bit, only the first one gets 0
+inline void maa_indirect_test_and_set_bits(void *bitmap, int idx_tile, int dst_tile = -1, int cond_tile = -1) {
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::INDIR_RMW_SCALAR << 32) |                // opcode
+                                                ((uint64_t)DataType::BIT_TYPE << 24) |                          // datatype
+                                                ((uint64_t)Operation_t::OR_OP << 16) |                          // optype
+                                                ((uint64_t)(dst_tile == -1 ? NA_UINT8 : dst_tile) << 8) |       // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)idx_tile << 56) |                        // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
+    *INSTR_baseaddr = (uint64_t)bitmap;                                                                         // baseaddr
+    __asm__ __volatile__("mfence;");
+}
 // for each tile of i, set last_i_reg to 0 and last_j_reg to -1
 template <class T1>
 inline void maa_range_loop(int last_i_reg, int last_j_reg, int min_tile, int max_tile, int stride_reg, int dst_i_tile, int dst_j_tile, int cond_tile = -1) {
@@ -380,4 +675,53 @@ inline void maa_range_loop(int last_i_reg, int last_j_reg, int min_tile, int max
                                                             (uint64_t)(cond_tile == -1 ? NA_UINT8 : cond_tile); // cond
     *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
     __asm__ __volatile__("mfence;");
-}
\ No newline at end of file
+}
+// Records the instructions up to maa_loop_end instead of running them. maa_loop_end replays them for
+// REG[induction_reg] from its current value while it is below REG[bound_reg], adding REG[stride_reg] each iteration.
+// Odd iterations read alt_induction_reg instead of induction_reg and add alt_tile_offset to the tiles written by the
+// loop, so an iteration can start before the previous one drains. Results of odd iterations are in the moved tiles.
+template <class T1>
+inline void maa_loop_begin(int induction_reg, int bound_reg, int stride_reg, int alt_induction_reg = -1, int alt_tile_offset = 0) {
+    DataType data_type = get_data_type<T1>();
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::LOOP_BEGIN << 32) |                      // opcode
+                                                ((uint64_t)data_type << 24) |                                   // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)(alt_tile_offset == 0 ? NA_UINT8 : alt_tile_offset) << 8) | // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)NA_UINT8 << 56) |                        // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)(alt_induction_reg == -1 ? NA_UINT8 : alt_induction_reg) << 40) | // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)induction_reg << 24) |                   // rsrc1
+                                                            ((uint64_t)bound_reg << 16) |                       // rsrc2
+                                                            ((uint64_t)stride_reg << 8) |                       // rsrc3
+                                                            (uint64_t)NA_UINT8;                                 // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// Returns once all iterations of the recorded loop are dispatched
+inline void maa_loop_end() {
+    *INSTR_opcode_datatype_optype_tdst1_tdst2 = ((uint64_t)OpcodeType::LOOP_END << 32) |                        // opcode
+                                                ((uint64_t)DataType::UINT32_TYPE << 24) |                       // datatype
+                                                ((uint64_t)NA_UINT8 << 16) |                                    // optype
+                                                ((uint64_t)NA_UINT8 << 8) |                                     // tdst1
+                                                (uint64_t)NA_UINT8;                                             // tdst2
+    *INSTR_tsrc1_tsrc2_rdst1_rdst2_rsrc1_rsrc2_rsrc3_csrc = ((uint64_t)NA_UINT8 << 56) |                        // tsrc1
+                                                            ((uint64_t)NA_UINT8 << 48) |                        // tsrc2
+                                                            ((uint64_t)NA_UINT8 << 40) |                        // rdst1
+                                                            ((uint64_t)NA_UINT8 << 32) |                        // rdst2
+                                                            ((uint64_t)NA_UINT8 << 24) |                        // rsrc1
+                                                            ((uint64_t)NA_UINT8 << 16) |                        // rsrc2
+                                                            ((uint64_t)NA_UINT8 << 8) |                         // rsrc3
+                                                            (uint64_t)NA_UINT8;                                 // cond
+    *INSTR_baseaddr = NA_UINT64;                                                                                // baseaddr
+    __asm__ __volatile__("mfence;");
+}
+// Runs body(induction_reg, tile_offset) as a hardware loop. The body issues the instructions of one iteration,
+// reads the induction from induction_reg, and adds tile_offset to every use of the tiles it writes.
+template <class T1, class Body>
+inline void maa_loop(int induction_reg, int bound_reg, int stride_reg, Body body, int alt_induction_reg = -1, int alt_tile_offset = 0) {
+    maa_loop_begin<T1>(induction_reg, bound_reg, stride_reg, alt_induction_reg, alt_tile_offset);
+    body(induction_reg, 0);
+    maa_loop_end();
+}
@@ -0,0 +1,40 @@
+# Runs test_opcodes.o (bash make_functional.sh GEM5) on the timing model. Each kernel gets its own
+# checkpoint, and every run compares the MAA version against the CPU version.
+OUTDIR=./chkpt_opcodes
+GEM5_HOME=../..
+N=65536
+
+checkpoint() {
+    KERNEL=$1
+    if [ ! -d ${OUTDIR}/${KERNEL} ]; then
+        mkdir -p ${OUTDIR}/${KERNEL}
+        OMP_PROC_BIND=false OMP_NUM_THREADS=4 ${GEM5_HOME}/build/X86/gem5.fast --outdir=${OUTDIR}/${KERNEL} ${GEM5_HOME}/configs/deprecated/example/se.py --cpu-type AtomicSimpleCPU -n 4 --mem-size "16GB" --cmd ./test_opcodes.o --options "$N CMP ${KERNEL}" 2>&1 | awk '{ print strftime(), $0; fflush() }' | tee ${OUTDIR}/${KERNEL}/logs_checkpoint.txt
+    fi
+}
+
+run() {
+    NAME=$1
+    KERNEL=$2
+    shift 2
+    checkpoint ${KERNEL}
+    mkdir -p ${OUTDIR}/${KERNEL}/${NAME}
+    OMP_PROC_BIND=false OMP_NUM_THREADS=4 ${GEM5_HOME}/build/X86/gem5.opt --outdir=${OUTDIR}/${KERNEL}/${NAME} ${GEM5_HOME}/configs/deprecated/example/se.py --checkpoint-dir ${OUTDIR}/${KERNEL} --cpu-type X86O3CPU -n 4 --mem-size '16GB' --sys-clock '3.2GHz' --cpu-clock '3.2GHz' --caches --l1d_size=32kB --l1d_assoc=8 --l1d-hwp-type=StridePrefetcher --l1d_mshrs=16 --l1i_size=32kB --l1i_assoc=8 --l1i-hwp-type=StridePrefetcher --l1i_mshrs=16 --l2cache --l2_size=256kB --l2_assoc=4 --l2-hwp-type=StridePrefetcher --l2_mshrs=32 --l3cache --l3_size=8MB --l3_assoc=16 --l3_mshrs=256 --cacheline_size=64 --mem-type Ramulator2 --ramulator-config ${GEM5_HOME}/ext/ramulator2/ramulator2/example_gem5_config.yaml --mem-channels 1 --maa --maa_num_tile_elements 16384 "$@" --cmd ./test_opcodes.o --options "$N CMP ${KERNEL}" -r 1 2>&1 | awk '{ print strftime(), $0; fflush() }' | tee ${OUTDIR}/${KERNEL}/${NAME}/logs_run.txt
+    grep -q "End of Test, all tests correct!" ${OUTDIR}/${KERNEL}/${NAME}/logs_run.txt || echo "${KERNEL} ${NAME} failed"
+}
+
+run default chained
+run default probe
+run default compact
+run default scan
+run default segmented_scan
+run default histogram
+run default rmw_combined
+run default cas_vector
+run default cas_scalar
+run default convert
+run default bitmap
+run default loop
+run tlb all --maa_num_tlb_entries 64
+for POLICY in History CLDensity HillClimb; do
+    run ${POLICY} all --maa_reconfigure_row_table --maa_row_table_policy ${POLICY}
+done
@@ -0,0 +1,769 @@
+#include "MAA.hpp"
+#include <cassert>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#define DELTA 0.001
+
+#if !defined(FUNC) && !defined(GEM5) && !defined(GEM5_MAGIC)
+#define FUNC
+#endif
+
+#if defined(FUNC)
+#include "MAA_functional.hpp"
+#elif defined(GEM5)
+#include "MAA_gem5.hpp"
+#include <gem5/m5ops.h>
+#elif defined(GEM5_MAGIC)
+#include "MAA_gem5_magic.hpp"
+#endif
+
+// Each kernel runs a CPU version and an MAA version of the same computation, CMP compares them.
+// Built with FUNC the MAA version runs on the functional model (MAA_functional.hpp), and built
+// with GEM5 on the timing model (MAA_gem5.hpp), so both models are checked against the same
+// CPU results. run_opcodes.sh runs each kernel on the timing model.
+
+#define NUM_HASH_BUCKETS 1024
+#define HASH_SKIP 2
+#define HASH_TUPLES 2
+#define HASH_BUCKET_SIZE 32
+#define NUM_BUCKETS 257
+
+/*******************************************************************************/
+/*******************************************************************************/
+/*                                    TESTS                                    */
+/*******************************************************************************/
+/*******************************************************************************/
+
+// a[i] = b[perm[idx[i]]]
+void chained(int *a, int *b, int *perm, int *idx, int n) {
+    std::cout << "starting chained n(" << n << ")" << std::endl;
+    for (int i = 0; i < n; i++) {
+        a[i] = b[perm[idx[i]]];
+    }
+}
+void chained_maa(int *a, int *b, int *perm, int *idx, int n) {
+    std::cout << "starting chained_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int idx_tile = get_new_tile<int>();
+    int b_tile = get_new_tile<int>();
+    int *b_p = get_cacheable_tile_pointer<int>(b_tile);
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        int curr_tile_size = std::min(n - i_base, TILE_SIZE);
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(idx, min_reg_id, max_reg_id, stride_reg_id, idx_tile);
+        maa_indirect_load_chained<int>(b, (uint32_t *)perm, idx_tile, b_tile);
+        wait_ready(b_tile);
+        for (int i_offset = 0; i_offset < curr_tile_size; i_offset++) {
+            a[i_base + i_offset] = b_p[i_offset];
+        }
+    }
+}
+
+// Buckets are {latch, count, tuples[HASH_TUPLES] = {key, payload}, next}
+void *hash_build(int *keys, int n) {
+    uint8_t *table = (uint8_t *)aligned_alloc(64, NUM_HASH_BUCKETS * HASH_BUCKET_SIZE);
+    memset(table, 0, NUM_HASH_BUCKETS * HASH_BUCKET_SIZE);
+    uint32_t mask = (NUM_HASH_BUCKETS - 1) << HASH_SKIP;
+    for (int i = 0; i < n; i++) {
+        uint8_t *bucket = table + ((keys[i] & mask) >> HASH_SKIP) * HASH_BUCKET_SIZE;
+        uint32_t *count = (uint32_t *)(bucket + 4);
+        uint32_t *tuples = (uint32_t *)(bucket + 8);
+        if (*count < HASH_TUPLES) {
+            tuples[2 * *count] = keys[i];
+            tuples[2 * *count + 1] = keys[i] * 3 + 1;
+            (*count)++;
+        } else {
+            // Only marks the overflow chain, the probe leaves it to the core
+            *(uint64_t *)(bucket + 8 + 8 * HASH_TUPLES) = 1;
+        }
+    }
+    return table;
+}
+void probe(int *payload, int *match, void *table, int *keys, int n) {
+    std::cout << "starting probe n(" << n << ")" << std::endl;
+    uint32_t mask = (NUM_HASH_BUCKETS - 1) << HASH_SKIP;
+    for (int i = 0; i < n; i++) {
+        uint8_t *bucket = (uint8_t *)table + ((keys[i] & mask) >> HASH_SKIP) * HASH_BUCKET_SIZE;
+        uint32_t count = ((uint32_t *)bucket)[1];
+        uint32_t *tuples = (uint32_t *)(bucket + 8);
+        payload[i] = 0;
+        match[i] = 0;
+        for (uint32_t j = 0; j < count; j++) {
+            if (tuples[2 * j] == (uint32_t)keys[i]) {
+                payload[i] = tuples[2 * j + 1];
+                match[i] = 1;
+                break;
+            }
+        }
+        if (*(uint64_t *)(bucket + 8 + 8 * HASH_TUPLES) != 0) {
+            match[i] = match[i] == 1 ? 3 : 2;
+        }
+    }
+}
+void probe_maa(int *payload, int *match, void *table, int *keys, int n) {
+    std::cout << "starting probe_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int mask_reg_id = get_new_reg<uint32_t>((NUM_HASH_BUCKETS - 1) << HASH_SKIP);
+    int skip_reg_id = get_new_reg<uint32_t>(HASH_SKIP);
+    int layout_reg_id = get_new_reg<uint32_t>((HASH_TUPLES << 16) | HASH_BUCKET_SIZE);
+    int key_tile = get_new_tile<int>();
+    int payload_tile = get_new_tile<int>();
+    int match_tile = get_new_tile<uint32_t>();
+    int *payload_p = get_cacheable_tile_pointer<int>(payload_tile);
+    uint32_t *match_p = get_cacheable_tile_pointer<uint32_t>(match_tile);
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        int curr_tile_size = std::min(n - i_base, TILE_SIZE);
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(keys, min_reg_id, max_reg_id, stride_reg_id, key_tile);
+        maa_hash_probe<int>(table, mask_reg_id, skip_reg_id, layout_reg_id, key_tile, payload_tile, match_tile);
+        wait_ready(payload_tile);
+        wait_ready(match_tile);
+        for (int i_offset = 0; i_offset < curr_tile_size; i_offset++) {
+            payload[i_base + i_offset] = payload_p[i_offset];
+            match[i_base + i_offset] = match_p[i_offset];
+        }
+    }
+}
+
+// Packs the b[i] > C values and their indices
+void compact(int *a, int *a_idx, int &a_size, int *b, int n, const int C) {
+    std::cout << "starting compact n(" << n << ")" << std::endl;
+    a_size = 0;
+    for (int i = 0; i < n; i++) {
+        if (b[i] > C) {
+            a[a_size] = b[i];
+            a_idx[a_size] = i;
+            a_size++;
+        }
+    }
+}
+void compact_maa(int *a, int *a_idx, int &a_size, int *b, int n, const int C) {
+    std::cout << "starting compact_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int C_reg_id = get_new_reg<int>(C);
+    int b_tile = get_new_tile<int>();
+    int cond_tile = get_new_tile<uint32_t>();
+    int a_tile = get_new_tile<int>();
+    int idx_tile = get_new_tile<uint32_t>();
+    int *a_p = get_cacheable_tile_pointer<int>(a_tile);
+    uint32_t *idx_p = get_cacheable_tile_pointer<uint32_t>(idx_tile);
+    a_size = 0;
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(b, min_reg_id, max_reg_id, stride_reg_id, b_tile);
+        maa_alu_scalar<int>(b_tile, C_reg_id, cond_tile, Operation_t::GT_OP);
+        maa_alu_compact<int>(b_tile, cond_tile, a_tile, idx_tile);
+        wait_ready(a_tile);
+        wait_ready(idx_tile);
+        int curr_packed = get_tile_size(a_tile);
+        for (int i_offset = 0; i_offset < curr_packed; i_offset++) {
+            a[a_size] = a_p[i_offset];
+            a_idx[a_size] = i_base + idx_p[i_offset];
+            a_size++;
+        }
+    }
+}
+
+// Inclusive ADD scan of b, or exclusive MAX scan of b restarting where flags[i] is set
+void scan(int *a, int *b, int *flags, int n, bool segmented) {
+    std::cout << "starting " << (segmented ? "segmented_scan" : "scan") << " n(" << n << ")" << std::endl;
+    int carry = segmented ? std::numeric_limits<int>::lowest() : 0;
+    for (int i = 0; i < n; i++) {
+        if (segmented) {
+            if (flags[i]) {
+                carry = std::numeric_limits<int>::lowest();
+            }
+            a[i] = carry;
+            carry = std::max(carry, b[i]);
+        } else {
+            carry += b[i];
+            a[i] = carry;
+        }
+    }
+}
+void scan_maa(int *a, int *b, int *flags, int n, bool segmented) {
+    std::cout << "starting " << (segmented ? "segmented_scan" : "scan") << "_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    // The carry register chains the scan across tiles
+    int carry_reg_id = get_new_reg<int>(segmented ? std::numeric_limits<int>::lowest() : 0);
+    int b_tile = get_new_tile<int>();
+    int flag_tile = get_new_tile<uint32_t>();
+    int a_tile = get_new_tile<int>();
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(b, min_reg_id, max_reg_id, stride_reg_id, b_tile);
+        if (segmented) {
+            maa_stream_load<int>(flags, min_reg_id, max_reg_id, stride_reg_id, flag_tile);
+            maa_alu_segmented_scan<int>(b_tile, flag_tile, a_tile, Operation_t::MAX_OP, true, carry_reg_id);
+        } else {
+            maa_alu_scan<int>(b_tile, a_tile, Operation_t::ADD_OP, false, carry_reg_id);
+        }
+        maa_stream_store<int>(a, min_reg_id, max_reg_id, stride_reg_id, a_tile);
+    }
+    wait_ready(a_tile);
+}
+
+// hist[bucket[i]] += b[i]
+void histogram(int *hist, int *bucket, int *b, int n) {
+    std::cout << "starting histogram n(" << n << ")" << std::endl;
+    for (int k = 0; k < NUM_BUCKETS; k++) {
+        hist[k] = 0;
+    }
+    for (int i = 0; i < n; i++) {
+        hist[bucket[i]] += b[i];
+    }
+}
+void histogram_maa(int *hist, int *bucket, int *b, int n) {
+    std::cout << "starting histogram_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int bounds_reg_id = get_new_reg<int>(NUM_BUCKETS);
+    int id_tile = get_new_tile<int>();
+    int weight_tile = get_new_tile<int>();
+    int hist_tile = get_new_tile<int>();
+    int *hist_p = get_cacheable_tile_pointer<int>(hist_tile);
+    for (int k = 0; k < NUM_BUCKETS; k++) {
+        hist[k] = 0;
+    }
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(bucket, min_reg_id, max_reg_id, stride_reg_id, id_tile);
+        maa_stream_load<int>(b, min_reg_id, max_reg_id, stride_reg_id, weight_tile);
+        maa_alu_histogram<int>(id_tile, bounds_reg_id, hist_tile, weight_tile);
+        wait_ready(hist_tile);
+        for (int k = 0; k < NUM_BUCKETS; k++) {
+            hist[k] += hist_p[k];
+        }
+    }
+}
+
+// a[idx[i]] += b[i], idx has duplicates so the row table fill combines their updates
+void rmw_combined(int *a, int *b, int *idx, int n) {
+    std::cout << "starting rmw_combined n(" << n << ")" << std::endl;
+    for (int i = 0; i < n; i++) {
+        a[idx[i]] += b[i];
+    }
+}
+void rmw_combined_maa(int *a, int *b, int *idx, int n) {
+    std::cout << "starting rmw_combined_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int idx_tile = get_new_tile<int>();
+    int b_tile = get_new_tile<int>();
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(idx, min_reg_id, max_reg_id, stride_reg_id, idx_tile);
+        maa_stream_load<int>(b, min_reg_id, max_reg_id, stride_reg_id, b_tile);
+        maa_indirect_rmw_vector<int>(a, idx_tile, b_tile, Operation_t::ADD_OP);
+    }
+    wait_ready(b_tile);
+}
+
+// old[i] = a[perm[i]], a[perm[i]] = b[i] (or C) if it was expected[i]
+void cas(int *a, int *old, int *success, int *b, int *expected, int *perm, int n, bool scalar, const int C) {
+    std::cout << "starting cas_" << (scalar ? "scalar" : "vector") << " n(" << n << ")" << std::endl;
+    for (int i = 0; i < n; i++) {
+        old[i] = a[perm[i]];
+        success[i] = old[i] == expected[i];
+        if (success[i]) {
+            a[perm[i]] = scalar ? C : b[i];
+        }
+    }
+}
+void cas_maa(int *a, int *old, int *success, int *b, int *expected, int *perm, int n, bool scalar, const int C) {
+    std::cout << "starting cas_" << (scalar ? "scalar" : "vector") << "_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int C_reg_id = get_new_reg<int>(C);
+    int idx_tile = get_new_tile<int>();
+    int new_tile = get_new_tile<int>();
+    int expected_tile = get_new_tile<int>();
+    int success_tile = get_new_tile<uint32_t>();
+    int *old_p = get_cacheable_tile_pointer<int>(expected_tile);
+    uint32_t *success_p = get_cacheable_tile_pointer<uint32_t>(success_tile);
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        int curr_tile_size = std::min(n - i_base, TILE_SIZE);
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(perm, min_reg_id, max_reg_id, stride_reg_id, idx_tile);
+        maa_stream_load<int>(expected, min_reg_id, max_reg_id, stride_reg_id, expected_tile);
+        if (scalar) {
+            maa_indirect_cas_scalar<int>(a, idx_tile, C_reg_id, expected_tile, success_tile);
+        } else {
+            maa_stream_load<int>(b, min_reg_id, max_reg_id, stride_reg_id, new_tile);
+            maa_indirect_cas_vector<int>(a, idx_tile, new_tile, expected_tile, success_tile);
+        }
+        wait_ready(expected_tile);
+        wait_ready(success_tile);
+        for (int i_offset = 0; i_offset < curr_tile_size; i_offset++) {
+            old[i_base + i_offset] = old_p[i_offset];
+            success[i_base + i_offset] = success_p[i_offset];
+        }
+    }
+}
+
+// a[i] = (float)(int16_t)(b[i] - C), through a 2-byte tile
+void convert(float *a, int *b, int n, const int C) {
+    std::cout << "starting convert n(" << n << ")" << std::endl;
+    for (int i = 0; i < n; i++) {
+        a[i] = (float)(int16_t)(b[i] - C);
+    }
+}
+void convert_maa(float *a, int *b, int n, const int C) {
+    std::cout << "starting convert_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int C_reg_id = get_new_reg<int>(C);
+    int b_tile = get_new_tile<int>();
+    int c_tile = get_new_tile<int>();
+    int s_tile = get_new_tile<int16_t>();
+    int a_tile = get_new_tile<float>();
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(b, min_reg_id, max_reg_id, stride_reg_id, b_tile);
+        maa_alu_scalar<int>(b_tile, C_reg_id, c_tile, Operation_t::SUB_OP);
+        maa_alu_convert<int, int16_t>(c_tile, s_tile);
+        maa_alu_convert<int16_t, float>(s_tile, a_tile);
+        maa_stream_store<float>(a, min_reg_id, max_reg_id, stride_reg_id, a_tile);
+    }
+    wait_ready(a_tile);
+}
+
+// bits[i] = test(bm_test, idx[i]) & test_and_set(bm_set, perm[i]), and bm_set_all gets all bits of idx
+void bitmap(uint8_t *bits, int &count, uint8_t *bm_test, uint8_t *bm_set, uint8_t *bm_set_all, int *idx, int *perm, int n) {
+    std::cout << "starting bitmap n(" << n << ")" << std::endl;
+    count = 0;
+    memset(bits, 0, (n + 7) / 8);
+    for (int i = 0; i < n; i++) {
+        bool tested = (bm_test[idx[i] >> 3] >> (idx[i] & 7)) & 1;
+        bool was_set = (bm_set[perm[i] >> 3] >> (perm[i] & 7)) & 1;
+        bm_set[perm[i] >> 3] |= 1 << (perm[i] & 7);
+        bm_set_all[idx[i] >> 3] |= 1 << (idx[i] & 7);
+        if (tested && was_set) {
+            bits[i >> 3] |= 1 << (i & 7);
+            count++;
+        }
+    }
+}
+void bitmap_maa(uint8_t *bits, int &count, uint8_t *bm_test, uint8_t *bm_set, uint8_t *bm_set_all, int *idx, int *perm, int n) {
+    std::cout << "starting bitmap_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int count_reg_id = get_new_reg<uint32_t>();
+    int idx_tile = get_new_tile<int>();
+    int perm_tile = get_new_tile<int>();
+    int tested_tile = get_new_tile<uint8_t>();
+    int was_set_tile = get_new_tile<uint8_t>();
+    int bits_tile = get_new_tile<uint8_t>();
+    uint8_t *bits_p = get_cacheable_tile_pointer<uint8_t>(bits_tile);
+    count = 0;
+    for (int i_base = 0; i_base < n; i_base += TILE_SIZE) {
+        maa_const(i_base, min_reg_id);
+        maa_stream_load<int>(idx, min_reg_id, max_reg_id, stride_reg_id, idx_tile);
+        maa_stream_load<int>(perm, min_reg_id, max_reg_id, stride_reg_id, perm_tile);
+        maa_indirect_test_bits(bm_test, idx_tile, tested_tile);
+        // perm has no duplicates, so each element sees the bit as it was before the kernel
+        maa_indirect_test_and_set_bits(bm_set, perm_tile, was_set_tile);
+        maa_indirect_test_and_set_bits(bm_set_all, idx_tile);
+        maa_bitmap_vector(tested_tile, was_set_tile, bits_tile, Operation_t::AND_OP);
+        maa_bitmap_popcount(bits_tile, count_reg_id);
+        wait_ready(bits_tile);
+        count += get_reg<uint32_t>(count_reg_id);
+        int curr_tile_bytes = get_tile_size(bits_tile);
+        for (int i_offset = 0; i_offset < curr_tile_bytes; i_offset++) {
+            bits[i_base / 8 + i_offset] = bits_p[i_offset];
+        }
+    }
+    wait_ready(idx_tile);
+}
+
+// a[i] = b[idx[i]], one replayed loop iteration per tile
+void loop(int *a, int *b, int *idx, int n) {
+    std::cout << "starting loop n(" << n << ")" << std::endl;
+    for (int i = 0; i < n; i++) {
+        a[i] = b[idx[i]];
+    }
+}
+void loop_maa(int *a, int *b, int *idx, int n) {
+    std::cout << "starting loop_maa n(" << n << "), tile(" << TILE_SIZE << ")" << std::endl;
+    init_MAA();
+    int max_reg_id = get_new_reg<int>(n);
+    int min_reg_id = get_new_reg<int>(0);
+    int alt_min_reg_id = get_new_reg<int>();
+    int stride_reg_id = get_new_reg<int>(1);
+    int tile_stride_reg_id = get_new_reg<int>(TILE_SIZE);
+    int idx_tile = get_new_tile<int>();
+    int b_tile = get_new_tile<int>();
+    // Odd iterations write the next two tiles
+    int alt_tile_offset = get_new_tile<int>() - idx_tile;
+    get_new_tile<int>();
+    maa_loop<int>(
+        min_reg_id, max_reg_id, tile_stride_reg_id, [&](int induction_reg_id, int tile_offset) {
+            maa_stream_load<int>(idx, induction_reg_id, max_reg_id, stride_reg_id, idx_tile + tile_offset);
+            maa_indirect_load<int>(b, idx_tile + tile_offset, b_tile + tile_offset);
+            maa_stream_store<int>(a, induction_reg_id, max_reg_id, stride_reg_id, b_tile + tile_offset);
+        },
+        alt_min_reg_id, alt_tile_offset);
+    wait_ready(b_tile);
+    wait_ready(b_tile + alt_tile_offset);
+}
+
+/*******************************************************************************/
+/*******************************************************************************/
+/*                                    MAIN                                     */
+/*******************************************************************************/
+/*******************************************************************************/
+
+template <class T>
+bool comparer(T *a1, T *a2, long n, std::string kernel) {
+    for (long i = 0; i < n; i += 1) {
+        if (abs(a1[i] - a2[i]) >= DELTA) {
+            std::cout << "Error -- " << kernel << ": " << i << " " << +a1[i] << " " << +a2[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc != 4) {
+        std::cout << "Usage: " << argv[0] << " <n> [BASE|MAA|CMP] [kernel|all]" << std::endl;
+        return 1;
+    }
+
+    srand((unsigned)time(NULL));
+
+    int n = std::stoi(argv[1]);
+    std::string mode = argv[2];
+    std::string kernel = argv[3];
+    bool base = false;
+    bool maa = false;
+    bool cmp = false;
+    if (mode == "BASE") {
+        base = true;
+    } else if (mode == "MAA") {
+        maa = true;
+    } else if (mode == "CMP") {
+        base = true;
+        maa = true;
+        cmp = true;
+    } else {
+        std::cout << "Error: Unknown mode " << mode << std::endl;
+        std::cout << "Usage: " << argv[0] << " <n> [BASE|MAA|CMP] [kernel|all]" << std::endl;
+        return 1;
+    }
+
+    const int const_val = rand() % 1024;
+    int nbytes = (n + 7) / 8;
+    int *b = (int *)malloc(sizeof(int) * n);
+    int *idx = (int *)malloc(sizeof(int) * n);
+    int *perm = (int *)malloc(sizeof(int) * n);
+    int *bucket = (int *)malloc(sizeof(int) * n);
+    int *flags = (int *)malloc(sizeof(int) * n);
+    int *keys = (int *)malloc(sizeof(int) * n);
+    int *expected = (int *)malloc(sizeof(int) * n);
+    int *a1 = (int *)malloc(sizeof(int) * n);
+    int *a2 = (int *)malloc(sizeof(int) * n);
+    int *c1 = (int *)malloc(sizeof(int) * n);
+    int *c2 = (int *)malloc(sizeof(int) * n);
+    int *d1 = (int *)malloc(sizeof(int) * n);
+    int *d2 = (int *)malloc(sizeof(int) * n);
+    float *f1 = (float *)malloc(sizeof(float) * n);
+    float *f2 = (float *)malloc(sizeof(float) * n);
+    uint8_t *bm_test = (uint8_t *)malloc(nbytes);
+    uint8_t *bm1 = (uint8_t *)malloc(nbytes);
+    uint8_t *bm2 = (uint8_t *)malloc(nbytes);
+    uint8_t *bm3 = (uint8_t *)malloc(nbytes);
+    uint8_t *bm4 = (uint8_t *)malloc(nbytes);
+    uint8_t *bits1 = (uint8_t *)malloc(nbytes);
+    uint8_t *bits2 = (uint8_t *)malloc(nbytes);
+
+    std::cout << "initializing general arrays" << std::endl;
+    for (int i = 0; i < n; i++) {
+        b[i] = (i * 3) % 1024;
+        idx[i] = rand() % n;
+        perm[i] = i;
+        bucket[i] = rand() % NUM_BUCKETS;
+        flags[i] = rand() % 8 == 0;
+        keys[i] = rand() % (1 << 20);
+    }
+    for (int i = n - 1; i > 0; i--) {
+        std::swap(perm[i], perm[rand() % (i + 1)]);
+    }
+    for (int i = 0; i < nbytes; i++) {
+        bm_test[i] = rand() % 256;
+        bm1[i] = bm2[i] = rand() % 256;
+    }
+    // Half of the probed keys are in the table
+    void *table = hash_build(keys, n / 2);
+    for (int i = n / 2; i < n; i++) {
+        if (rand() % 2 == 0) {
+            keys[i] = keys[rand() % (n / 2)];
+        }
+    }
+
+#ifdef GEM5
+    std::cout << "Checkpointing started" << std::endl;
+    m5_checkpoint(0, 0);
+    std::cout << "Checkpointing ended" << std::endl;
+#endif
+
+    std::cout << "initializing done, testing..." << std::endl;
+
+    if (maa) {
+        alloc_MAA();
+    }
+#ifdef GEM5
+    m5_clear_mem_region();
+    m5_add_mem_region(b, b + n, 0);
+    m5_add_mem_region(idx, idx + n, 1);
+    m5_add_mem_region(perm, perm + n, 2);
+    m5_add_mem_region(a2, a2 + n, 3);
+    m5_add_mem_region(keys, keys + n, 4);
+    m5_add_mem_region(table, (uint8_t *)table + NUM_HASH_BUCKETS * HASH_BUCKET_SIZE, 5);
+    m5_add_mem_region(flags, flags + n, 6);
+    m5_add_mem_region(bucket, bucket + n, 7);
+    m5_add_mem_region(expected, expected + n, 8);
+    m5_add_mem_region(f2, f2 + n, 9);
+    m5_add_mem_region(bm_test, bm_test + nbytes, 10);
+    m5_add_mem_region(bm2, bm2 + nbytes, 11);
+    m5_add_mem_region(bm4, bm4 + nbytes, 12);
+#endif
+
+    bool correct = true;
+
+    if (kernel == "chained" || kernel == "all") {
+        if (maa) {
+            chained_maa(a2, b, perm, idx, n);
+        }
+        if (base) {
+            chained(a1, b, perm, idx, n);
+        }
+        if (cmp) {
+            correct = comparer<int>(a1, a2, n, "chained");
+            if (correct) {
+                std::cout << "chained correct" << std::endl;
+            }
+        }
+    }
+
+    if (correct && (kernel == "probe" || kernel == "all")) {
+        if (maa) {
+            probe_maa(a2, c2, table, keys, n);
+        }
+        if (base) {
+            probe(a1, c1, table, keys, n);
+        }
+        if (cmp) {
+            correct = comparer<int>(a1, a2, n, "probe") && comparer<int>(c1, c2, n, "probe");
+            if (correct) {
+                std::cout << "probe correct" << std::endl;
+            }
+        }
+    }
+
+    if (correct && (kernel == "compact" || kernel == "all")) {
+        int size1 = 0, size2 = 0;
+        if (maa) {
+            compact_maa(a2, c2, size2, b, n, const_val);
+        }
+        if (base) {
+            compact(a1, c1, size1, b, n, const_val);
+        }
+        if (cmp) {
+            correct = comparer<int>(&size1, &size2, 1, "compact") && comparer<int>(a1, a2, size1, "compact") && comparer<int>(c1, c2, size1, "compact");
+            if (correct) {
+                std::cout << "compact correct" << std::endl;
+            }
+        }
+    }
+
+    for (bool segmented : {false, true}) {
+        std::string name = segmented ? "segmented_scan" : "scan";
+        if (correct && (kernel == name || kernel == "all")) {
+            if (maa) {
+                scan_maa(a2, b, flags, n, segmented);
+            }
+            if (base) {
+                scan(a1, b, flags, n, segmented);
+            }
+            if (cmp) {
+                correct = comparer<int>(a1, a2, n, name);
+                if (correct) {
+                    std::cout << name << " correct" << std::endl;
+                }
+            }
+        }
+    }
+
+    if (correct && (kernel == "histogram" || kernel == "all")) {
+        if (maa) {
+            histogram_maa(a2, bucket, b, n);
+        }
+        if (base) {
+            histogram(a1, bucket, b, n);
+        }
+        if (cmp) {
+            correct = comparer<int>(a1, a2, NUM_BUCKETS, "histogram");
+            if (correct) {
+                std::cout << "histogram correct" << std::endl;
+            }
+        }
+    }
+
+    if (correct && (kernel == "rmw_combined" || kernel == "all")) {
+        for (int i = 0; i < n; i++) {
+            a1[i] = a2[i] = (i * 7) % 1024;
+        }
+        if (maa) {
+            rmw_combined_maa(a2, b, idx, n);
+        }
+        if (base) {
+            rmw_combined(a1, b, idx, n);
+        }
+        if (cmp) {
+            correct = comparer<int>(a1, a2, n, "rmw_combined");
+            if (correct) {
+                std::cout << "rmw_combined correct" << std::endl;
+            }
+        }
+    }
+
+    for (bool scalar : {false, true}) {
+        std::string name = scalar ? "cas_scalar" : "cas_vector";
+        if (correct && (kernel == name || kernel == "all")) {
+            for (int i = 0; i < n; i++) {
+                a1[i] = a2[i] = (i * 7) % 1024;
+            }
+            // Half of the swaps succeed
+            for (int i = 0; i < n; i++) {
+                expected[i] = a1[perm[i]] + rand() % 2;
+            }
+            if (maa) {
+                cas_maa(a2, c2, d2, b, expected, perm, n, scalar, const_val);
+            }
+            if (base) {
+                cas(a1, c1, d1, b, expected, perm, n, scalar, const_val);
+            }
+            if (cmp) {
+                correct = comparer<int>(a1, a2, n, name) && comparer<int>(c1, c2, n, name) && comparer<int>(d1, d2, n, name);
+                if (correct) {
+                    std::cout << name << " correct" << std::endl;
+                }
+            }
+        }
+    }
+
+    if (correct && (kernel == "convert" || kernel == "all")) {
+        if (maa) {
+            convert_maa(f2, b, n, const_val);
+        }
+        if (base) {
+            convert(f1, b, n, const_val);
+        }
+        if (cmp) {
+            correct = comparer<float>(f1, f2, n, "convert");
+            if (correct) {
+                std::cout << "convert correct" << std::endl;
+            }
+        }
+    }
+
+    if (correct && (kernel == "bitmap" || kernel == "all")) {
+        int count1 = 0, count2 = 0;
+        memset(bm3, 0, nbytes);
+        memset(bm4, 0, nbytes);
+        if (maa) {
+            bitmap_maa(bits2, count2, bm_test, bm2, bm4, idx, perm, n);
+        }
+        if (base) {
+            bitmap(bits1, count1, bm_test, bm1, bm3, idx, perm, n);
+        }
+        if (cmp) {
+            correct = comparer<uint8_t>(bits1, bits2, nbytes, "bitmap") && comparer<uint8_t>(bm1, bm2, nbytes, "bitmap") &&
+                      comparer<uint8_t>(bm3, bm4, nbytes, "bitmap") && comparer<int>(&count1, &count2, 1, "bitmap");
+            if (correct) {
+                std::cout << "bitmap correct" << std::endl;
+            }
+        }
+    }
+
+    if (correct && (kernel == "loop" || kernel == "all")) {
+        if (maa) {
+            loop_maa(a2, b, idx, n);
+        }
+        if (base) {
+            loop(a1, b, idx, n);
+        }
+        if (cmp) {
+            correct = comparer<int>(a1, a2, n, "loop");
+            if (correct) {
+                std::cout << "loop correct" << std::endl;
+            }
+        }
+    }
+
+    free(b);
+    free(idx);
+    free(perm);
+    free(bucket);
+    free(flags);
+    free(keys);
+    free(expected);
+    free(a1);
+    free(a2);
+    free(c1);
+    free(c2);
+    free(d1);
+    free(d2);
+    free(f1);
+    free(f2);
+    free(bm_test);
+    free(bm1);
+    free(bm2);
+    free(bm3);
+    free(bm4);
+    free(bits1);
+    free(bits2);
+    free(table);
+    if (!correct) {
+#ifdef GEM5
+        m5_exit(1);
+#endif
+        return 1;
+    }
+    std::cout << "End of Test, all tests correct!" << std::endl;
+#ifdef GEM5
+    m5_exit(0);
+#endif
+    return 0;
+}
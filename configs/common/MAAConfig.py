@@ -33,6 +33,9 @@ def _get_maa_opts(options):
     if(hasattr(options, "maa_reconfigure_row_table")):
         opts["reconfigure_row_table"] = getattr(options, "maa_reconfigure_row_table")
 
+    if hasattr(options, "maa_row_table_policy"):
+        opts["row_table_policy"] = getattr(options, "maa_row_table_policy")
+
     if(hasattr(options, "maa_no_reorder")):
         opts["no_reorder"] = getattr(options, "maa_no_reorder")
 
@@ -48,6 +51,22 @@ def _get_maa_opts(options):
     if hasattr(options, "maa_num_request_table_entries_per_address"):
         opts["num_request_table_entries_per_address"] = getattr(options, "maa_num_request_table_entries_per_address")
 
+    if hasattr(options, "maa_num_tlb_entries"):
+        opts["num_tlb_entries"] = getattr(options, "maa_num_tlb_entries")
+
+    if hasattr(options, "maa_tlb_associativity"):
+        opts["tlb_associativity"] = getattr(options, "maa_tlb_associativity")
+
+    if hasattr(options, "maa_tlb_page_size"):
+        opts["tlb_page_size"] = getattr(options, "maa_tlb_page_size")
+
+    if hasattr(options, "maa_tlb_page_table_size"):
+        opts["tlb_page_table_size"] = getattr(options, "maa_tlb_page_table_size")
+
+    if hasattr(options, "maa_tlb_hit_latency"):
+        opts["tlb_hit_latency"] = getattr(options, "maa_tlb_hit_latency")
+
+
     if hasattr(options, "maa_spd_read_latency"):
         opts["spd_read_latency"] = getattr(options, "maa_spd_read_latency")
 
@@ -71,6 +90,9 @@ def _get_maa_opts(options):
     
     if hasattr(options, "maa_num_maas"):
         opts["num_maas"] = getattr(options, "maa_num_maas")
+
+    if hasattr(options, "maa_dram_addr_mapping"):
+        opts["dram_addr_mapping"] = getattr(options, "maa_dram_addr_mapping")
     
     opts["num_memory_channels"] = options.mem_channels
     opts["num_cores"] = options.num_cpus
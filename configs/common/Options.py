@@ -224,11 +224,17 @@ def addNoISAOptions(parser):
     parser.add_argument("--maa_num_row_table_entries_per_subslice_row", type=int, default=8, help="Number of row table entries (bursts) per each sub-slice of row table")
     parser.add_argument("--maa_num_row_table_config_cache_entries", type=int, default=16, help="Number of row table entry history in the configuration cache")
     parser.add_argument("--maa_reconfigure_row_table", action="store_true", help="Reconfigure row table")
+    parser.add_argument("--maa_row_table_policy", type=str, default="History", choices=["History", "CLDensity", "HillClimb"], help="Row table reconfiguration policy")
     parser.add_argument("--maa_no_reorder", default=False, action="store_true", help="Do not reorder using row table")
     parser.add_argument("--maa_force_cache_access", default=False, action="store_true", help="Force cache access instead of direct memory access for the indirect access unit")
     parser.add_argument("--maa_num_initial_row_table_slices", type=int, default=32, help="Number of initial row table slices if row table is not reconfigurable")
     parser.add_argument("--maa_num_request_table_addresses", type=int, default=128, help="Number of addresses in the request table")
-    parser.add_argument("--maa_num_request_table_entries_per_address", type=int, default=16, help="Number of entries in the request table per address")
+    parser.add_argument("--maa_num_request_table_entries_per_address", type=int, default=16, help="Number of entries in the request table per address, use 32 for 2-byte and 64 for 1-byte stream words")
+    parser.add_argument("--maa_num_tlb_entries", type=int, default=0, help="Number of TLB entries per stream and indirect unit, 0 for ideal address translation")
+    parser.add_argument("--maa_tlb_associativity", type=int, default=4, help="TLB associativity")
+    parser.add_argument("--maa_tlb_page_size", type=str, default="4KiB", choices=["4KiB", "2MiB", "1GiB"], help="Page size backing the data accessed by the TLB model")
+    parser.add_argument("--maa_tlb_page_table_size", type=str, default="64MiB", help="Size of the region at the top of memory holding the synthetic PTEs read by TLB page walks")
+    parser.add_argument("--maa_tlb_hit_latency", type=int, default=1, help="TLB hit latency")
     parser.add_argument("--maa_spd_read_latency", type=int, default=1, help="SPD read latency")
     parser.add_argument("--maa_spd_write_latency", type=int, default=1, help="SPD write latency")
     parser.add_argument("--maa_num_spd_read_ports_per_maa", type=int, default=4, help="Number of SPD read ports per DX100 instance")
@@ -239,6 +245,7 @@ def addNoISAOptions(parser):
     parser.add_argument("--maa_l2_uncacheable", action="store_true", help="Enable uncacheable L2 cache for MAA")
     parser.add_argument("--maa_l3_uncacheable", action="store_true", help="Enable uncacheable L3 cache for MAA")
     parser.add_argument("--maa_num_maas", type=int, default=1, help="Number of MAA instances")
+    parser.add_argument("--maa_dram_addr_mapping", type=str, default="RoBaRaCoCh", choices=["RoBaRaCoCh", "ChRaBaRoCo", "MOP4CLXOR"], help="DRAM address mapping, must match the Ramulator2 AddrMapper")
     parser.add_argument("--maa_ncbus_width", type=int, default=32, help="Width of the Non-Coherent Bus")
     parser.add_argument("--l1d_repl_policy",  default="LRURP",
                     choices=ObjectList.rp_list.get_names(),
@@ -1,17 +1,569 @@
 #include "mem/MAA/ALU.hh"
 #include "mem/MAA/MAA.hh"
 #include "mem/MAA/IF.hh"
+#include "mem/MAA/HalfFloat.hh"
 #include "mem/MAA/SPD.hh"
+#include "base/bitfield.hh"
 #include "base/trace.hh"
 #include "debug/MAAALU.hh"
 #include "debug/MAATrace.hh"
 #include <cassert>
+#include <limits>
+#include <type_traits>
 
 #ifndef TRACING_ON
 #define TRACING_ON 1
 #endif
 
 namespace gem5 {
+///////////////
+//
+// ALU KERNELS
+//
+///////////////
+template <Instruction::OPType optype>
+constexpr bool isCompareOP() {
+    return optype == Instruction::OPType::GT_OP ||
+           optype == Instruction::OPType::GTE_OP ||
+           optype == Instruction::OPType::LT_OP ||
+           optype == Instruction::OPType::LTE_OP ||
+           optype == Instruction::OPType::EQ_OP;
+}
+template <Instruction::OPType optype>
+constexpr bool isBitwiseOP() {
+    return optype == Instruction::OPType::AND_OP ||
+           optype == Instruction::OPType::OR_OP ||
+           optype == Instruction::OPType::XOR_OP ||
+           optype == Instruction::OPType::ANDN_OP ||
+           optype == Instruction::OPType::SHL_OP ||
+           optype == Instruction::OPType::SHR_OP;
+}
+template <typename T, Instruction::OPType optype>
+inline auto computeALU(T src1, T src2) {
+    if constexpr (optype == Instruction::OPType::ADD_OP) {
+        return (T)(src1 + src2);
+    } else if constexpr (optype == Instruction::OPType::SUB_OP) {
+        return (T)(src1 - src2);
+    } else if constexpr (optype == Instruction::OPType::MUL_OP) {
+        return (T)(src1 * src2);
+    } else if constexpr (optype == Instruction::OPType::DIV_OP) {
+        return (T)(src1 / src2);
+    } else if constexpr (optype == Instruction::OPType::MIN_OP) {
+        return std::min(src1, src2);
+    } else if constexpr (optype == Instruction::OPType::MAX_OP) {
+        return std::max(src1, src2);
+    } else if constexpr (optype == Instruction::OPType::AND_OP) {
+        return (T)(src1 & src2);
+    } else if constexpr (optype == Instruction::OPType::OR_OP) {
+        return (T)(src1 | src2);
+    } else if constexpr (optype == Instruction::OPType::XOR_OP) {
+        return (T)(src1 ^ src2);
+    } else if constexpr (optype == Instruction::OPType::ANDN_OP) {
+        return (T)(src1 & ~src2);
+    } else if constexpr (optype == Instruction::OPType::SHL_OP) {
+        return (T)(src1 << src2);
+    } else if constexpr (optype == Instruction::OPType::SHR_OP) {
+        return (T)(src1 >> src2);
+    } else if constexpr (optype == Instruction::OPType::GT_OP) {
+        return (uint32_t)(src1 > src2 ? 1 : 0);
+    } else if constexpr (optype == Instruction::OPType::GTE_OP) {
+        return (uint32_t)(src1 >= src2 ? 1 : 0);
+    } else if constexpr (optype == Instruction::OPType::LT_OP) {
+        return (uint32_t)(src1 < src2 ? 1 : 0);
+    } else if constexpr (optype == Instruction::OPType::LTE_OP) {
+        return (uint32_t)(src1 <= src2 ? 1 : 0);
+    } else {
+        static_assert(optype == Instruction::OPType::EQ_OP, "Unsupported ALU optype!");
+        return (uint32_t)(src1 == src2 ? 1 : 0);
+    }
+}
+template <typename T, Instruction::OPType optype, Instruction::OpcodeType opcode>
+void ALUKernel(ALUUnit::KernelArgs &args) {
+    // Comparisons produce 4-byte words regardless of the input type
+    typedef decltype(computeALU<T, optype>(T(), T())) R;
+    const T *src1 = (const T *)args.src1;
+    const T *src2 = (const T *)args.src2;
+    R *dst = (R *)args.dst;
+    int num_taken = 0;
+    int num_nonzero = 0;
+    if constexpr (opcode == Instruction::OpcodeType::ALU_REDUCE) {
+        static_assert(isCompareOP<optype>() == false, "ALU_REDUCE does not support comparisons!");
+        T red = *((T *)args.red);
+        for (int i = 0; i < args.num_elements; i++) {
+            if (args.cond == nullptr || args.cond[i] != 0) {
+                red = computeALU<T, optype>(src1[i], red);
+                num_taken++;
+            }
+        }
+        *((T *)args.red) = red;
+    } else {
+        const T src2_scalar = (opcode == Instruction::OpcodeType::ALU_SCALAR) ? src2[0] : T();
+        if (args.cond == nullptr) {
+            for (int i = 0; i < args.num_elements; i++) {
+                dst[i] = computeALU<T, optype>(src1[i], opcode == Instruction::OpcodeType::ALU_SCALAR ? src2_scalar : src2[i]);
+            }
+            num_taken = args.num_elements;
+            if constexpr (isCompareOP<optype>()) {
+                for (int i = 0; i < args.num_elements; i++) {
+                    num_nonzero += dst[i];
+                }
+            }
+        } else {
+            // Elements that do not pass the condition are zeroed
+            for (int i = 0; i < args.num_elements; i++) {
+                if (args.cond[i] != 0) {
+                    dst[i] = computeALU<T, optype>(src1[i], opcode == Instruction::OpcodeType::ALU_SCALAR ? src2_scalar : src2[i]);
+                    num_taken++;
+                    if constexpr (isCompareOP<optype>()) {
+                        num_nonzero += dst[i];
+                    }
+                } else {
+                    dst[i] = 0;
+                }
+            }
+        }
+    }
+    args.num_taken = num_taken;
+    args.num_nonzero = num_nonzero;
+}
+template <typename T>
+void compactKernel(ALUUnit::KernelArgs &args) {
+    // Packing only moves words, so it is specialized by the word size
+    const T *src1 = (const T *)args.src1;
+    T *dst = (T *)args.dst;
+    int num_taken = 0;
+    for (int i = 0; i < args.num_elements; i++) {
+        if (args.cond[i] != 0) {
+            dst[num_taken] = src1[i];
+            if (args.idx != nullptr) {
+                args.idx[num_taken] = args.first_element + i;
+            }
+            num_taken++;
+        }
+    }
+    args.num_taken = num_taken;
+    args.num_nonzero = 0;
+}
+template <typename T, Instruction::OPType optype, bool exclusive>
+void scanKernel(ALUUnit::KernelArgs &args) {
+    // The running value carries across chunks in the accumulator. A nonzero
+    // segment flag restarts it at the element, and elements that do not pass
+    // the condition contribute nothing but still get the running value.
+    const T *src1 = (const T *)args.src1;
+    const uint32_t *flags = (const uint32_t *)args.src2;
+    T *dst = (T *)args.dst;
+    const T identity = *((const T *)args.identity);
+    T carry = *((T *)args.red);
+    for (int i = 0; i < args.num_elements; i++) {
+        if (flags != nullptr && flags[i] != 0) {
+            carry = identity;
+        }
+        if constexpr (exclusive) {
+            dst[i] = carry;
+        }
+        if (args.cond == nullptr || args.cond[i] != 0) {
+            carry = computeALU<T, optype>(src1[i], carry);
+        }
+        if constexpr (exclusive == false) {
+            dst[i] = carry;
+        }
+    }
+    *((T *)args.red) = carry;
+    args.num_taken = args.num_elements;
+    args.num_nonzero = 0;
+}
+template <typename T>
+void histogramKernel(ALUUnit::KernelArgs &args) {
+    // dst points to bucket 0, and bucket ids out of [0, num_buckets) are dropped
+    const uint32_t *ids = (const uint32_t *)args.src1;
+    const T *weights = (const T *)args.src2;
+    T *dst = (T *)args.dst;
+    int num_taken = 0;
+    for (int i = 0; i < args.num_elements; i++) {
+        if ((args.cond == nullptr || args.cond[i] != 0) && ids[i] < (uint32_t)args.num_buckets) {
+            dst[ids[i]] += weights == nullptr ? (T)1 : weights[i];
+            num_taken++;
+        }
+    }
+    args.num_taken = num_taken;
+    args.num_nonzero = 0;
+}
+void popcountKernel(ALUUnit::KernelArgs &args) {
+    // Bitmap bytes are summed into a 4-byte count of the set bits
+    const uint8_t *src1 = (const uint8_t *)args.src1;
+    uint32_t count = *((uint32_t *)args.red);
+    for (int i = 0; i < args.num_elements; i++) {
+        count += popCount(src1[i]);
+    }
+    *((uint32_t *)args.red) = count;
+    args.num_taken = args.num_elements;
+    args.num_nonzero = 0;
+}
+template <typename S, typename D>
+inline D convertWord(S value) {
+    // Floats going to integers saturate and NaNs become zero, integers keep
+    // their low bits when narrowed, and floats round to nearest-even
+    if constexpr (std::numeric_limits<S>::is_integer == false && std::numeric_limits<D>::is_integer) {
+        double value_double = static_cast<double>(value);
+        if (value_double != value_double) {
+            return 0;
+        } else if (value_double <= static_cast<double>(std::numeric_limits<D>::lowest())) {
+            return std::numeric_limits<D>::lowest();
+        } else if (value_double >= static_cast<double>(std::numeric_limits<D>::max())) {
+            return std::numeric_limits<D>::max();
+        }
+        return static_cast<D>(value_double);
+    } else {
+        return static_cast<D>(value);
+    }
+}
+template <typename S, typename D>
+void convertKernel(ALUUnit::KernelArgs &args) {
+    const S *src1 = (const S *)args.src1;
+    D *dst = (D *)args.dst;
+    int num_taken = 0;
+    for (int i = 0; i < args.num_elements; i++) {
+        if (args.cond == nullptr || args.cond[i] != 0) {
+            dst[i] = convertWord<S, D>(src1[i]);
+            num_taken++;
+        } else {
+            dst[i] = D();
+        }
+    }
+    args.num_taken = num_taken;
+    args.num_nonzero = 0;
+}
+template <typename S>
+ALUUnit::Kernel getConvertKernel(Instruction::DataType dst_datatype) {
+    switch (dst_datatype) {
+    case Instruction::DataType::UINT32_TYPE:
+        return &convertKernel<S, uint32_t>;
+    case Instruction::DataType::INT32_TYPE:
+        return &convertKernel<S, int32_t>;
+    case Instruction::DataType::FLOAT32_TYPE:
+        return &convertKernel<S, float>;
+    case Instruction::DataType::UINT64_TYPE:
+        return &convertKernel<S, uint64_t>;
+    case Instruction::DataType::INT64_TYPE:
+        return &convertKernel<S, int64_t>;
+    case Instruction::DataType::FLOAT64_TYPE:
+        return &convertKernel<S, double>;
+    case Instruction::DataType::UINT8_TYPE:
+        return &convertKernel<S, uint8_t>;
+    case Instruction::DataType::INT8_TYPE:
+        return &convertKernel<S, int8_t>;
+    case Instruction::DataType::UINT16_TYPE:
+        return &convertKernel<S, uint16_t>;
+    case Instruction::DataType::INT16_TYPE:
+        return &convertKernel<S, int16_t>;
+    case Instruction::DataType::FLOAT16_TYPE:
+        return &convertKernel<S, float16_t>;
+    case Instruction::DataType::BFLOAT16_TYPE:
+        return &convertKernel<S, bfloat16_t>;
+    default:
+        return nullptr;
+    }
+}
+template <typename T, Instruction::OPType optype>
+ALUUnit::Kernel getALUKernel(Instruction::OpcodeType opcode) {
+    if constexpr (std::numeric_limits<T>::is_integer == false && isBitwiseOP<optype>()) {
+        return nullptr;
+    } else {
+        switch (opcode) {
+        case Instruction::OpcodeType::ALU_SCALAR:
+            return &ALUKernel<T, optype, Instruction::OpcodeType::ALU_SCALAR>;
+        case Instruction::OpcodeType::ALU_VECTOR:
+            return &ALUKernel<T, optype, Instruction::OpcodeType::ALU_VECTOR>;
+        case Instruction::OpcodeType::ALU_REDUCE:
+            // Reductions have no identity for comparisons, XOR, ANDN and shifts
+            if constexpr (isCompareOP<optype>() ||
+                          optype == Instruction::OPType::XOR_OP ||
+                          optype == Instruction::OPType::ANDN_OP ||
+                          optype == Instruction::OPType::SHL_OP ||
+                          optype == Instruction::OPType::SHR_OP) {
+                return nullptr;
+            } else {
+                return &ALUKernel<T, optype, Instruction::OpcodeType::ALU_REDUCE>;
+            }
+        case Instruction::OpcodeType::ALU_SCAN:
+        case Instruction::OpcodeType::ALU_SCAN_EXCL:
+            if constexpr (optype == Instruction::OPType::ADD_OP ||
+                          optype == Instruction::OPType::MIN_OP ||
+                          optype == Instruction::OPType::MAX_OP) {
+                if (opcode == Instruction::OpcodeType::ALU_SCAN) {
+                    return &scanKernel<T, optype, false>;
+                } else {
+                    return &scanKernel<T, optype, true>;
+                }
+            } else {
+                return nullptr;
+            }
+        default:
+            return nullptr;
+        }
+    }
+}
+template <typename T>
+ALUUnit::Kernel getALUKernel(Instruction::OpcodeType opcode, Instruction::OPType optype) {
+    switch (optype) {
+    case Instruction::OPType::ADD_OP:
+        return getALUKernel<T, Instruction::OPType::ADD_OP>(opcode);
+    case Instruction::OPType::SUB_OP:
+        return getALUKernel<T, Instruction::OPType::SUB_OP>(opcode);
+    case Instruction::OPType::MUL_OP:
+        return getALUKernel<T, Instruction::OPType::MUL_OP>(opcode);
+    case Instruction::OPType::DIV_OP:
+        return getALUKernel<T, Instruction::OPType::DIV_OP>(opcode);
+    case Instruction::OPType::MIN_OP:
+        return getALUKernel<T, Instruction::OPType::MIN_OP>(opcode);
+    case Instruction::OPType::MAX_OP:
+        return getALUKernel<T, Instruction::OPType::MAX_OP>(opcode);
+    case Instruction::OPType::AND_OP:
+        return getALUKernel<T, Instruction::OPType::AND_OP>(opcode);
+    case Instruction::OPType::OR_OP:
+        return getALUKernel<T, Instruction::OPType::OR_OP>(opcode);
+    case Instruction::OPType::XOR_OP:
+        return getALUKernel<T, Instruction::OPType::XOR_OP>(opcode);
+    case Instruction::OPType::ANDN_OP:
+        return getALUKernel<T, Instruction::OPType::ANDN_OP>(opcode);
+    case Instruction::OPType::SHL_OP:
+        return getALUKernel<T, Instruction::OPType::SHL_OP>(opcode);
+    case Instruction::OPType::SHR_OP:
+        return getALUKernel<T, Instruction::OPType::SHR_OP>(opcode);
+    case Instruction::OPType::GT_OP:
+        return getALUKernel<T, Instruction::OPType::GT_OP>(opcode);
+    case Instruction::OPType::GTE_OP:
+        return getALUKernel<T, Instruction::OPType::GTE_OP>(opcode);
+    case Instruction::OPType::LT_OP:
+        return getALUKernel<T, Instruction::OPType::LT_OP>(opcode);
+    case Instruction::OPType::LTE_OP:
+        return getALUKernel<T, Instruction::OPType::LTE_OP>(opcode);
+    case Instruction::OPType::EQ_OP:
+        return getALUKernel<T, Instruction::OPType::EQ_OP>(opcode);
+    default:
+        return nullptr;
+    }
+}
+template <typename T>
+void initReduction(uint8_t *red, Instruction::OPType optype) {
+    T identity;
+    switch (optype) {
+    case Instruction::OPType::OR_OP:
+    case Instruction::OPType::ADD_OP:
+    case Instruction::OPType::SUB_OP: {
+        identity = 0;
+        break;
+    }
+    case Instruction::OPType::MUL_OP:
+    case Instruction::OPType::DIV_OP: {
+        identity = 1;
+        break;
+    }
+    case Instruction::OPType::MIN_OP: {
+        identity = std::numeric_limits<T>::max();
+        break;
+    }
+    case Instruction::OPType::MAX_OP: {
+        // lowest(), not min(): for floating-point types min() is the smallest
+        // positive value, which would clamp all-negative MAX results to it
+        identity = std::numeric_limits<T>::lowest();
+        break;
+    }
+    case Instruction::OPType::AND_OP: {
+        if constexpr (std::is_integral_v<T>) {
+            identity = ~((T)0);
+        } else {
+            assert(false);
+        }
+        break;
+    }
+    default:
+        assert(false);
+    }
+    *((T *)red) = identity;
+}
+ALUUnit::Kernel getBitmapKernel(Instruction::OpcodeType opcode, Instruction::OPType optype) {
+    // Bitmaps are processed a byte (8 elements) at a time, only bitwise
+    // operations and the popcount (ADD) reduction are meaningful on them
+    if (opcode == Instruction::OpcodeType::ALU_REDUCE) {
+        return optype == Instruction::OPType::ADD_OP ? &popcountKernel : nullptr;
+    } else if (opcode != Instruction::OpcodeType::ALU_SCALAR && opcode != Instruction::OpcodeType::ALU_VECTOR) {
+        return nullptr;
+    }
+    switch (optype) {
+    case Instruction::OPType::AND_OP:
+    case Instruction::OPType::OR_OP:
+    case Instruction::OPType::XOR_OP:
+    case Instruction::OPType::ANDN_OP:
+        return getALUKernel<uint8_t>(opcode, optype);
+    default:
+        return nullptr;
+    }
+}
+ALUUnit::Kernel getALUKernel(Instruction::DataType datatype, Instruction::OpcodeType opcode, Instruction::OPType optype) {
+    if (datatype == Instruction::DataType::BIT_TYPE) {
+        return getBitmapKernel(opcode, optype);
+    }
+    if (opcode == Instruction::OpcodeType::ALU_HISTOGRAM) {
+        switch (datatype) {
+        case Instruction::DataType::UINT32_TYPE:
+            return &histogramKernel<uint32_t>;
+        case Instruction::DataType::INT32_TYPE:
+            return &histogramKernel<int32_t>;
+        case Instruction::DataType::FLOAT32_TYPE:
+            return &histogramKernel<float>;
+        case Instruction::DataType::UINT64_TYPE:
+            return &histogramKernel<uint64_t>;
+        case Instruction::DataType::INT64_TYPE:
+            return &histogramKernel<int64_t>;
+        case Instruction::DataType::FLOAT64_TYPE:
+            return &histogramKernel<double>;
+        case Instruction::DataType::UINT8_TYPE:
+            return &histogramKernel<uint8_t>;
+        case Instruction::DataType::INT8_TYPE:
+            return &histogramKernel<int8_t>;
+        case Instruction::DataType::UINT16_TYPE:
+            return &histogramKernel<uint16_t>;
+        case Instruction::DataType::INT16_TYPE:
+            return &histogramKernel<int16_t>;
+        case Instruction::DataType::FLOAT16_TYPE:
+            return &histogramKernel<float16_t>;
+        case Instruction::DataType::BFLOAT16_TYPE:
+            return &histogramKernel<bfloat16_t>;
+        default:
+            return nullptr;
+        }
+    }
+    if (opcode == Instruction::OpcodeType::ALU_COMPACT) {
+        switch (datatype) {
+        case Instruction::DataType::UINT8_TYPE:
+        case Instruction::DataType::INT8_TYPE:
+            return &compactKernel<uint8_t>;
+        case Instruction::DataType::UINT16_TYPE:
+        case Instruction::DataType::INT16_TYPE:
+        case Instruction::DataType::FLOAT16_TYPE:
+        case Instruction::DataType::BFLOAT16_TYPE:
+            return &compactKernel<uint16_t>;
+        case Instruction::DataType::UINT32_TYPE:
+        case Instruction::DataType::INT32_TYPE:
+        case Instruction::DataType::FLOAT32_TYPE:
+            return &compactKernel<uint32_t>;
+        case Instruction::DataType::UINT64_TYPE:
+        case Instruction::DataType::INT64_TYPE:
+        case Instruction::DataType::FLOAT64_TYPE:
+            return &compactKernel<uint64_t>;
+        default:
+            return nullptr;
+        }
+    }
+    if (opcode == Instruction::OpcodeType::ALU_CVT) {
+        // The destination type comes in the optype field
+        Instruction::DataType dst_datatype = static_cast<Instruction::DataType>(optype);
+        switch (datatype) {
+        case Instruction::DataType::UINT32_TYPE:
+            return getConvertKernel<uint32_t>(dst_datatype);
+        case Instruction::DataType::INT32_TYPE:
+            return getConvertKernel<int32_t>(dst_datatype);
+        case Instruction::DataType::FLOAT32_TYPE:
+            return getConvertKernel<float>(dst_datatype);
+        case Instruction::DataType::UINT64_TYPE:
+            return getConvertKernel<uint64_t>(dst_datatype);
+        case Instruction::DataType::INT64_TYPE:
+            return getConvertKernel<int64_t>(dst_datatype);
+        case Instruction::DataType::FLOAT64_TYPE:
+            return getConvertKernel<double>(dst_datatype);
+        case Instruction::DataType::UINT8_TYPE:
+            return getConvertKernel<uint8_t>(dst_datatype);
+        case Instruction::DataType::INT8_TYPE:
+            return getConvertKernel<int8_t>(dst_datatype);
+        case Instruction::DataType::UINT16_TYPE:
+            return getConvertKernel<uint16_t>(dst_datatype);
+        case Instruction::DataType::INT16_TYPE:
+            return getConvertKernel<int16_t>(dst_datatype);
+        case Instruction::DataType::FLOAT16_TYPE:
+            return getConvertKernel<float16_t>(dst_datatype);
+        case Instruction::DataType::BFLOAT16_TYPE:
+            return getConvertKernel<bfloat16_t>(dst_datatype);
+        default:
+            return nullptr;
+        }
+    }
+    switch (datatype) {
+    case Instruction::DataType::UINT32_TYPE:
+        return getALUKernel<uint32_t>(opcode, optype);
+    case Instruction::DataType::INT32_TYPE:
+        return getALUKernel<int32_t>(opcode, optype);
+    case Instruction::DataType::FLOAT32_TYPE:
+        return getALUKernel<float>(opcode, optype);
+    case Instruction::DataType::UINT64_TYPE:
+        return getALUKernel<uint64_t>(opcode, optype);
+    case Instruction::DataType::INT64_TYPE:
+        return getALUKernel<int64_t>(opcode, optype);
+    case Instruction::DataType::FLOAT64_TYPE:
+        return getALUKernel<double>(opcode, optype);
+    case Instruction::DataType::UINT8_TYPE:
+        return getALUKernel<uint8_t>(opcode, optype);
+    case Instruction::DataType::INT8_TYPE:
+        return getALUKernel<int8_t>(opcode, optype);
+    case Instruction::DataType::UINT16_TYPE:
+        return getALUKernel<uint16_t>(opcode, optype);
+    case Instruction::DataType::INT16_TYPE:
+        return getALUKernel<int16_t>(opcode, optype);
+    case Instruction::DataType::FLOAT16_TYPE:
+        return getALUKernel<float16_t>(opcode, optype);
+    case Instruction::DataType::BFLOAT16_TYPE:
+        return getALUKernel<bfloat16_t>(opcode, optype);
+    default:
+        return nullptr;
+    }
+}
+void initReduction(uint8_t *red, Instruction::DataType datatype, Instruction::OPType optype) {
+    switch (datatype) {
+    case Instruction::DataType::UINT32_TYPE:
+        initReduction<uint32_t>(red, optype);
+        break;
+    case Instruction::DataType::INT32_TYPE:
+        initReduction<int32_t>(red, optype);
+        break;
+    case Instruction::DataType::FLOAT32_TYPE:
+        initReduction<float>(red, optype);
+        break;
+    case Instruction::DataType::UINT64_TYPE:
+        initReduction<uint64_t>(red, optype);
+        break;
+    case Instruction::DataType::INT64_TYPE:
+        initReduction<int64_t>(red, optype);
+        break;
+    case Instruction::DataType::FLOAT64_TYPE:
+        initReduction<double>(red, optype);
+        break;
+    case Instruction::DataType::UINT8_TYPE:
+        initReduction<uint8_t>(red, optype);
+        break;
+    case Instruction::DataType::INT8_TYPE:
+        initReduction<int8_t>(red, optype);
+        break;
+    case Instruction::DataType::UINT16_TYPE:
+        initReduction<uint16_t>(red, optype);
+        break;
+    case Instruction::DataType::INT16_TYPE:
+        initReduction<int16_t>(red, optype);
+        break;
+    case Instruction::DataType::FLOAT16_TYPE:
+        initReduction<float16_t>(red, optype);
+        break;
+    case Instruction::DataType::BFLOAT16_TYPE:
+        initReduction<bfloat16_t>(red, optype);
+        break;
+    case Instruction::DataType::BIT_TYPE:
+        // Popcounts start from zero
+        initReduction<uint32_t>(red, optype);
+        break;
+    default:
+        assert(false);
+    }
+}
+
 ///////////////
 //
 // ALU ACCESS UNIT
@@ -52,7 +604,7 @@ void ALUUnit::updateLatency(int num_spd_read_data_accesses,
     }
     if (num_alu_accesses != 0) {
         // ALU operations
-        Cycles ALU_latency = Cycles(getCeiling(num_alu_accesses, num_ALU_lanes) * ALU_lane_latency);
+        Cycles ALU_latency = Cycles(getCeiling(num_alu_accesses, num_ALU_lanes) * my_lane_depth * ALU_lane_latency);
         if (my_ALU_finish_tick < curTick())
             my_ALU_finish_tick = maa->getClockEdge(ALU_latency);
         else
@@ -92,7 +644,9 @@ void ALUUnit::executeInstruction() {
         my_src2_tile = my_instruction->src2SpdID;
         my_max = -1;
         my_i = 0;
+        my_num_packed = 0;
         my_input_word_size = my_instruction->getWordSize(my_src1_tile);
+        my_src2_word_size = my_src2_tile != -1 ? my_instruction->getWordSize(my_src2_tile) : 1;
         my_output_word_size = my_dst_tile != -1 ? my_instruction->getWordSize(my_dst_tile) : 1;
         my_input_words_per_cl = 64 / my_input_word_size;
         maa->stats.numInst++;
@@ -103,74 +657,60 @@ void ALUUnit::executeInstruction() {
         } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
             maa->stats.numInst_ALUR++;
             panic_if(my_dst_reg == -1, "A[%d] %s: ALU_REDUCE instruction %s has no destination register!\n", my_alu_id, __func__, my_instruction->print());
-            switch (my_instruction->optype) {
-            case Instruction::OPType::OR_OP:
-            case Instruction::OPType::ADD_OP:
-            case Instruction::OPType::SUB_OP: {
-                my_red_i32 = 0;
-                my_red_u32 = 0;
-                my_red_i64 = 0;
-                my_red_u64 = 0;
-                my_red_f32 = 0;
-                my_red_f64 = 0;
-                break;
-            }
-            case Instruction::OPType::MUL_OP:
-            case Instruction::OPType::DIV_OP: {
-                my_red_i32 = 1;
-                my_red_u32 = 1;
-                my_red_i64 = 1;
-                my_red_u64 = 1;
-                my_red_f32 = 1;
-                my_red_f64 = 1;
-                break;
-            }
-            case Instruction::OPType::MIN_OP: {
-                my_red_i32 = std::numeric_limits<int32_t>::max();
-                my_red_u32 = std::numeric_limits<uint32_t>::max();
-                my_red_i64 = std::numeric_limits<int64_t>::max();
-                my_red_u64 = std::numeric_limits<uint64_t>::max();
-                my_red_f32 = std::numeric_limits<float>::max();
-                my_red_f64 = std::numeric_limits<double>::max();
-                break;
-            }
-            case Instruction::OPType::MAX_OP: {
-                my_red_i32 = std::numeric_limits<int32_t>::min();
-                my_red_u32 = std::numeric_limits<uint32_t>::min();
-                my_red_i64 = std::numeric_limits<int64_t>::min();
-                my_red_u64 = std::numeric_limits<uint64_t>::min();
-                my_red_f32 = std::numeric_limits<float>::min();
-                my_red_f64 = std::numeric_limits<double>::min();
-                break;
-            }
-            case Instruction::OPType::AND_OP: {
-                my_red_i32 = 0xFFFFFFFF;
-                my_red_u32 = 0xFFFFFFFF;
-                my_red_i64 = 0xFFFFFFFFFFFFFFFF;
-                my_red_u64 = 0xFFFFFFFFFFFFFFFF;
-                break;
-            }
-            default:
-                assert(false);
-            }
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_COMPACT) {
+            maa->stats.numInst_ALUC++;
+            panic_if(my_cond_tile == -1, "A[%d] %s: ALU_COMPACT instruction %s has no condition tile!\n", my_alu_id, __func__, my_instruction->print());
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCAN || my_instruction->opcode == Instruction::OpcodeType::ALU_SCAN_EXCL) {
+            maa->stats.numInst_ALUSC++;
+            panic_if(my_dst_tile == -1, "A[%d] %s: ALU_SCAN instruction %s has no destination tile!\n", my_alu_id, __func__, my_instruction->print());
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM) {
+            maa->stats.numInst_ALUH++;
+            panic_if(my_dst_tile == -1, "A[%d] %s: ALU_HISTOGRAM instruction %s has no destination tile!\n", my_alu_id, __func__, my_instruction->print());
+            panic_if(my_instruction->src1RegID == -1, "A[%d] %s: ALU_HISTOGRAM instruction %s has no bounds register!\n", my_alu_id, __func__, my_instruction->print());
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_CVT) {
+            maa->stats.numInst_ALUCV++;
+            panic_if(my_dst_tile == -1, "A[%d] %s: ALU_CVT instruction %s has no destination tile!\n", my_alu_id, __func__, my_instruction->print());
         } else {
             assert(false);
         }
+        my_is_compare = my_instruction->opcode != Instruction::OpcodeType::ALU_CVT &&
+                        (my_instruction->optype == Instruction::OPType::GT_OP ||
+                         my_instruction->optype == Instruction::OPType::GTE_OP ||
+                         my_instruction->optype == Instruction::OPType::LT_OP ||
+                         my_instruction->optype == Instruction::OPType::LTE_OP ||
+                         my_instruction->optype == Instruction::OPType::EQ_OP);
+        my_kernel = getALUKernel(my_instruction->datatype, my_instruction->opcode, my_instruction->optype);
+        panic_if(my_kernel == nullptr, "A[%d] %s: unsupported instruction %s!\n", my_alu_id, __func__, my_instruction->print());
+        // A 4-byte condition per bitmap byte has no meaning, bitmaps are masked with AND/ANDN instead
+        panic_if(my_instruction->datatype == Instruction::DataType::BIT_TYPE && my_cond_tile != -1, "A[%d] %s: bitmap instruction %s with a condition tile!\n", my_alu_id, __func__, my_instruction->print());
+        my_is_scan = my_instruction->opcode == Instruction::OpcodeType::ALU_SCAN || my_instruction->opcode == Instruction::OpcodeType::ALU_SCAN_EXCL;
+        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE || my_is_scan) {
+            initReduction(my_red, my_instruction->datatype, my_instruction->optype);
+        }
+        my_num_buckets = 0;
+        if (my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM) {
+            // Counts accumulate in the SPD from zero, the tile is written back only when finished
+            my_num_buckets = maa->rf->getData<int>(my_instruction->src1RegID);
+            panic_if(my_num_buckets <= 0 || my_num_buckets > num_tile_elements, "A[%d] %s: %d histogram buckets do not fit a tile!\n", my_alu_id, __func__, my_num_buckets);
+            std::memset(maa->spd->getTileDataPtr(my_dst_tile, my_output_word_size), 0, my_num_buckets * my_output_word_size);
+        }
+        my_lane_depth = 1;
+        if (my_is_scan) {
+            // Segments restart from the identity, the first one from the carry-in register if given
+            std::memcpy(my_identity, my_red, sizeof(my_red));
+            if (my_instruction->src1RegID != -1) {
+                std::memcpy(my_red, maa->rf->getDataPtr(my_instruction->src1RegID), my_input_word_size);
+            }
+            // A log-depth lane tree scans each group of lanes, then one more level adds the carry
+            while ((1 << (my_lane_depth - 1)) < num_ALU_lanes) {
+                my_lane_depth++;
+            }
+        }
         (*maa->stats.ALU_NumInsts[my_alu_id])++;
-        if (my_instruction->optype == Instruction::OPType::ADD_OP ||
-            my_instruction->optype == Instruction::OPType::SUB_OP ||
-            my_instruction->optype == Instruction::OPType::MUL_OP ||
-            my_instruction->optype == Instruction::OPType::DIV_OP ||
-            my_instruction->optype == Instruction::OPType::MIN_OP ||
-            my_instruction->optype == Instruction::OPType::MAX_OP ||
-            my_instruction->optype == Instruction::OPType::AND_OP ||
-            my_instruction->optype == Instruction::OPType::OR_OP ||
-            my_instruction->optype == Instruction::OPType::XOR_OP ||
-            my_instruction->optype == Instruction::OPType::SHL_OP ||
-            my_instruction->optype == Instruction::OPType::SHR_OP) {
-            (*maa->stats.ALU_NumInstsCompute[my_alu_id])++;
-        } else {
+        if (my_is_compare) {
             (*maa->stats.ALU_NumInstsCompare[my_alu_id])++;
+        } else {
+            (*maa->stats.ALU_NumInstsCompute[my_alu_id])++;
         }
         my_output_words_per_cl = 64 / my_output_word_size;
         my_SPD_read_finish_tick = curTick();
@@ -179,7 +719,7 @@ void ALUUnit::executeInstruction() {
         my_decode_start_tick = curTick();
         my_cond_tile_ready = (my_cond_tile == -1) ? true : false;
         my_src1_tile_ready = false;
-        my_src2_tile_ready = (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) ? true : false;
+        my_src2_tile_ready = (my_src2_tile == -1) ? true : false;
 
         // Setting the state of the instruction and ALU unit
         DPRINTF(MAAALU, "A[%d] %s: state set to work for request %s!\n", my_alu_id, __func__, my_instruction->print());
@@ -214,7 +754,7 @@ void ALUUnit::executeInstruction() {
             }
             panic_if(maa->spd->getSize(my_src1_tile) != my_max, "A[%d] %s: src1 size (%d) != max (%d)!\n", my_alu_id, __func__, maa->spd->getSize(my_src1_tile), my_max);
         }
-        if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
+        if (my_src2_tile != -1) {
             if (maa->spd->getTileStatus(my_src2_tile) == SPD::TileStatus::Finished) {
                 my_src2_tile_ready = true;
                 if (my_max == -1) {
@@ -239,589 +779,95 @@ void ALUUnit::executeInstruction() {
                 } else if (my_src2_tile_ready == false) {
                     DPRINTF(MAAALU, "A[%d] %s: src2 tile[%d] not ready, returning!\n", my_alu_id, __func__, my_src2_tile);
                     // Just a fake access to callback ALU when the src2 is ready
-                    maa->spd->getElementFinished(my_src2_tile, my_i, my_input_word_size, (uint8_t)FuncUnitType::ALU, my_alu_id);
+                    maa->spd->getElementFinished(my_src2_tile, my_i, my_src2_word_size, (uint8_t)FuncUnitType::ALU, my_alu_id);
                     return;
                 }
                 DPRINTF(MAAALU, "A[%d] %s: my_i (%d) >= my_max (%d), finished!\n", my_alu_id, __func__, my_i, my_max);
                 break;
             }
-            bool cond_ready = my_cond_tile == -1 || maa->spd->getElementFinished(my_cond_tile, my_i, 4, (uint8_t)FuncUnitType::ALU, my_alu_id);
-            bool src1_ready = cond_ready && maa->spd->getElementFinished(my_src1_tile, my_i, my_input_word_size, (uint8_t)FuncUnitType::ALU, my_alu_id);
-            bool src2_ready = src1_ready && (my_instruction->opcode != Instruction::OpcodeType::ALU_VECTOR ||
-                                             maa->spd->getElementFinished(my_src2_tile, my_i, my_input_word_size, (uint8_t)FuncUnitType::ALU, my_alu_id));
-            if (cond_ready == false) {
-                DPRINTF(MAAALU, "A[%d] %s: cond tile[%d] element[%d] not ready, returning!\n", my_alu_id, __func__, my_cond_tile, my_i);
-            } else if (src1_ready == false) {
-                DPRINTF(MAAALU, "A[%d] %s: src1 tile[%d] element[%d] not ready, returning!\n", my_alu_id, __func__, my_src1_tile, my_i);
-            } else if (src2_ready == false) {
-                DPRINTF(MAAALU, "A[%d] %s: src2 tile[%d] element[%d] not ready, returning!\n", my_alu_id, __func__, my_src2_tile, my_i);
+            // Finding the chunk of consecutive ready elements starting from my_i
+            int chunk_end = my_max == -1 ? num_tile_elements : my_max;
+            if (my_cond_tile != -1) {
+                chunk_end = maa->spd->getFirstUnfinished(my_cond_tile, my_i, chunk_end, 4);
             }
-            if (cond_ready == false || src1_ready == false || src2_ready == false) {
-                updateLatency(num_spd_read_data_accesses, num_spd_read_cond_accesses, num_spd_write_accesses, num_alu_accesses);
-                return;
+            chunk_end = maa->spd->getFirstUnfinished(my_src1_tile, my_i, chunk_end, my_input_word_size);
+            if (my_src2_tile != -1) {
+                chunk_end = maa->spd->getFirstUnfinished(my_src2_tile, my_i, chunk_end, my_src2_word_size);
             }
-            if (my_cond_tile == -1 || maa->spd->getData<uint32_t>(my_cond_tile, my_i) != 0) {
-                num_alu_accesses++;
-                switch (my_instruction->datatype) {
-                case Instruction::DataType::UINT32_TYPE: {
-                    uint32_t src1 = maa->spd->getData<uint32_t>(my_src1_tile, my_i);
-                    num_spd_read_data_accesses++;
-                    uint32_t src2;
-                    if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
-                        src2 = maa->rf->getData<uint32_t>(my_instruction->src1RegID);
-                    } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
-                        src2 = maa->spd->getData<uint32_t>(my_src2_tile, my_i);
-                        num_spd_read_data_accesses++;
-                    } else {
-                        src2 = my_red_u32;
-                    }
-                    uint32_t result_u32_compare = 0;
-                    uint32_t result_u32_compute = 0;
-                    switch (my_instruction->optype) {
-                    case Instruction::OPType::ADD_OP:
-                        result_u32_compute = src1 + src2;
-                        break;
-                    case Instruction::OPType::SUB_OP:
-                        result_u32_compute = src1 - src2;
-                        break;
-                    case Instruction::OPType::MUL_OP:
-                        result_u32_compute = src1 * src2;
-                        break;
-                    case Instruction::OPType::DIV_OP:
-                        result_u32_compute = src1 / src2;
-                        break;
-                    case Instruction::OPType::MIN_OP:
-                        result_u32_compute = std::min(src1, src2);
-                        break;
-                    case Instruction::OPType::MAX_OP:
-                        result_u32_compute = std::max(src1, src2);
-                        break;
-                    case Instruction::OPType::AND_OP:
-                        result_u32_compute = src1 & src2;
-                        break;
-                    case Instruction::OPType::OR_OP:
-                        result_u32_compute = src1 | src2;
-                        break;
-                    case Instruction::OPType::XOR_OP:
-                        result_u32_compute = src1 ^ src2;
-                        break;
-                    case Instruction::OPType::SHL_OP:
-                        result_u32_compute = src1 << src2;
-                        break;
-                    case Instruction::OPType::SHR_OP:
-                        result_u32_compute = src1 >> src2;
-                        break;
-                    case Instruction::OPType::GT_OP:
-                        result_u32_compare = src1 > src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::GTE_OP:
-                        result_u32_compare = src1 >= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LT_OP:
-                        result_u32_compare = src1 < src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LTE_OP:
-                        result_u32_compare = src1 <= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::EQ_OP:
-                        result_u32_compare = src1 == src2 ? 1 : 0;
-                        break;
-                    default:
-                        assert(false);
-                    }
-                    if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                        my_instruction->optype == Instruction::OPType::GTE_OP ||
-                        my_instruction->optype == Instruction::OPType::LT_OP ||
-                        my_instruction->optype == Instruction::OPType::LTE_OP ||
-                        my_instruction->optype == Instruction::OPType::EQ_OP) {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32_compare;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32_compare);
-                            num_spd_write_accesses++;
-                        }
-                        (*maa->stats.ALU_NumComparedWords[my_alu_id])++;
-                        if (result_u32_compare != 0) {
-                            (*maa->stats.ALU_NumTakenWords[my_alu_id])++;
-                        }
-                    } else {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32_compute;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32_compute);
-                            num_spd_write_accesses++;
-                        }
-                    }
-                    break;
+            bool chunk_ready = my_max != -1 && chunk_end >= my_max;
+            if (chunk_ready == false) {
+                // Registering for the callback of the first tile that is not ready
+                bool cond_ready = my_cond_tile == -1 || maa->spd->getElementFinished(my_cond_tile, chunk_end, 4, (uint8_t)FuncUnitType::ALU, my_alu_id);
+                bool src1_ready = cond_ready && maa->spd->getElementFinished(my_src1_tile, chunk_end, my_input_word_size, (uint8_t)FuncUnitType::ALU, my_alu_id);
+                bool src2_ready = src1_ready && (my_src2_tile == -1 ||
+                                                 maa->spd->getElementFinished(my_src2_tile, chunk_end, my_src2_word_size, (uint8_t)FuncUnitType::ALU, my_alu_id));
+                if (cond_ready == false) {
+                    DPRINTF(MAAALU, "A[%d] %s: cond tile[%d] element[%d] not ready, returning!\n", my_alu_id, __func__, my_cond_tile, chunk_end);
+                } else if (src1_ready == false) {
+                    DPRINTF(MAAALU, "A[%d] %s: src1 tile[%d] element[%d] not ready, returning!\n", my_alu_id, __func__, my_src1_tile, chunk_end);
+                } else if (src2_ready == false) {
+                    DPRINTF(MAAALU, "A[%d] %s: src2 tile[%d] element[%d] not ready, returning!\n", my_alu_id, __func__, my_src2_tile, chunk_end);
                 }
-                case Instruction::DataType::INT32_TYPE: {
-                    int32_t src1 = maa->spd->getData<int32_t>(my_src1_tile, my_i);
-                    num_spd_read_data_accesses++;
-                    int32_t src2;
-                    if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
-                        src2 = maa->rf->getData<int32_t>(my_instruction->src1RegID);
-                    } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
-                        src2 = maa->spd->getData<int32_t>(my_src2_tile, my_i);
-                        num_spd_read_data_accesses++;
-                    } else {
-                        src2 = my_red_i32;
-                    }
-                    int32_t result_i32 = 0;
-                    uint32_t result_u32 = 0;
-                    switch (my_instruction->optype) {
-                    case Instruction::OPType::ADD_OP:
-                        result_i32 = src1 + src2;
-                        break;
-                    case Instruction::OPType::SUB_OP:
-                        result_i32 = src1 - src2;
-                        break;
-                    case Instruction::OPType::MUL_OP:
-                        result_i32 = src1 * src2;
-                        break;
-                    case Instruction::OPType::DIV_OP:
-                        result_i32 = src1 / src2;
-                        break;
-                    case Instruction::OPType::MIN_OP:
-                        result_i32 = std::min(src1, src2);
-                        break;
-                    case Instruction::OPType::MAX_OP:
-                        result_i32 = std::max(src1, src2);
-                        break;
-                    case Instruction::OPType::AND_OP:
-                        result_i32 = src1 & src2;
-                        break;
-                    case Instruction::OPType::OR_OP:
-                        result_i32 = src1 | src2;
-                        break;
-                    case Instruction::OPType::XOR_OP:
-                        result_i32 = src1 ^ src2;
-                        break;
-                    case Instruction::OPType::SHL_OP:
-                        result_i32 = src1 << src2;
-                        break;
-                    case Instruction::OPType::SHR_OP:
-                        result_i32 = src1 >> src2;
-                        break;
-                    case Instruction::OPType::GT_OP:
-                        result_u32 = src1 > src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::GTE_OP:
-                        result_u32 = src1 >= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LT_OP:
-                        result_u32 = src1 < src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LTE_OP:
-                        result_u32 = src1 <= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::EQ_OP:
-                        result_u32 = src1 == src2 ? 1 : 0;
-                        break;
-                    default:
-                        assert(false);
-                    }
-                    if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                        my_instruction->optype == Instruction::OPType::GTE_OP ||
-                        my_instruction->optype == Instruction::OPType::LT_OP ||
-                        my_instruction->optype == Instruction::OPType::LTE_OP ||
-                        my_instruction->optype == Instruction::OPType::EQ_OP) {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32);
-                            num_spd_write_accesses++;
-                        }
-                        (*maa->stats.ALU_NumComparedWords[my_alu_id])++;
-                        if (result_u32 != 0) {
-                            (*maa->stats.ALU_NumTakenWords[my_alu_id])++;
-                        }
-                    } else {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_i32 = result_i32;
-                        } else {
-                            maa->spd->setData<int32_t>(my_dst_tile, my_i, result_i32);
-                            num_spd_write_accesses++;
-                        }
-                    }
-                    break;
-                }
-                case Instruction::DataType::FLOAT32_TYPE: {
-                    float src1 = maa->spd->getData<float>(my_src1_tile, my_i);
-                    num_spd_read_data_accesses++;
-                    float src2;
-                    if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
-                        src2 = maa->rf->getData<float>(my_instruction->src1RegID);
-                    } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
-                        src2 = maa->spd->getData<float>(my_src2_tile, my_i);
-                        num_spd_read_data_accesses++;
-                    } else {
-                        src2 = my_red_f32;
-                    }
-                    float result_f32 = 0;
-                    uint32_t result_u32 = 0;
-                    switch (my_instruction->optype) {
-                    case Instruction::OPType::ADD_OP:
-                        result_f32 = src1 + src2;
-                        break;
-                    case Instruction::OPType::SUB_OP:
-                        result_f32 = src1 - src2;
-                        break;
-                    case Instruction::OPType::MUL_OP:
-                        result_f32 = src1 * src2;
-                        break;
-                    case Instruction::OPType::DIV_OP:
-                        result_f32 = src1 / src2;
-                        break;
-                    case Instruction::OPType::MIN_OP:
-                        result_f32 = std::min(src1, src2);
-                        break;
-                    case Instruction::OPType::MAX_OP:
-                        result_f32 = std::max(src1, src2);
-                        break;
-                    case Instruction::OPType::GT_OP:
-                        result_u32 = src1 > src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::GTE_OP:
-                        result_u32 = src1 >= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LT_OP:
-                        result_u32 = src1 < src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LTE_OP:
-                        result_u32 = src1 <= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::EQ_OP:
-                        result_u32 = src1 == src2 ? 1 : 0;
-                        break;
-                    default:
-                        assert(false);
-                    }
-                    if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                        my_instruction->optype == Instruction::OPType::GTE_OP ||
-                        my_instruction->optype == Instruction::OPType::LT_OP ||
-                        my_instruction->optype == Instruction::OPType::LTE_OP ||
-                        my_instruction->optype == Instruction::OPType::EQ_OP) {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32);
-                            num_spd_write_accesses++;
-                        }
-                        (*maa->stats.ALU_NumComparedWords[my_alu_id])++;
-                        if (result_u32 != 0) {
-                            (*maa->stats.ALU_NumTakenWords[my_alu_id])++;
-                        }
-                    } else {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_f32 = result_f32;
-                        } else {
-                            maa->spd->setData<float>(my_dst_tile, my_i, result_f32);
-                            num_spd_write_accesses++;
-                        }
-                    }
-                    break;
-                }
-                case Instruction::DataType::UINT64_TYPE: {
-                    uint64_t src1 = maa->spd->getData<uint64_t>(my_src1_tile, my_i);
-                    num_spd_read_data_accesses++;
-                    uint64_t src2;
-                    if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
-                        src2 = maa->rf->getData<uint64_t>(my_instruction->src1RegID);
-                    } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
-                        src2 = maa->spd->getData<uint64_t>(my_src2_tile, my_i);
-                        num_spd_read_data_accesses++;
-                    } else {
-                        src2 = my_red_u64;
-                    }
-                    uint64_t result_u64 = 0;
-                    uint32_t result_u32 = 0;
-                    switch (my_instruction->optype) {
-                    case Instruction::OPType::ADD_OP:
-                        result_u64 = src1 + src2;
-                        break;
-                    case Instruction::OPType::SUB_OP:
-                        result_u64 = src1 - src2;
-                        break;
-                    case Instruction::OPType::MUL_OP:
-                        result_u64 = src1 * src2;
-                        break;
-                    case Instruction::OPType::DIV_OP:
-                        result_u64 = src1 / src2;
-                        break;
-                    case Instruction::OPType::MIN_OP:
-                        result_u64 = std::min(src1, src2);
-                        break;
-                    case Instruction::OPType::MAX_OP:
-                        result_u64 = std::max(src1, src2);
-                        break;
-                    case Instruction::OPType::AND_OP:
-                        result_u64 = src1 & src2;
-                        break;
-                    case Instruction::OPType::OR_OP:
-                        result_u64 = src1 | src2;
-                        break;
-                    case Instruction::OPType::XOR_OP:
-                        result_u64 = src1 ^ src2;
-                        break;
-                    case Instruction::OPType::SHL_OP:
-                        result_u64 = src1 << src2;
-                        break;
-                    case Instruction::OPType::SHR_OP:
-                        result_u64 = src1 >> src2;
-                        break;
-                    case Instruction::OPType::GT_OP:
-                        result_u32 = src1 > src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::GTE_OP:
-                        result_u32 = src1 >= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LT_OP:
-                        result_u32 = src1 < src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LTE_OP:
-                        result_u32 = src1 <= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::EQ_OP:
-                        result_u32 = src1 == src2 ? 1 : 0;
-                        break;
-                    default:
-                        assert(false);
-                    }
-                    if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                        my_instruction->optype == Instruction::OPType::GTE_OP ||
-                        my_instruction->optype == Instruction::OPType::LT_OP ||
-                        my_instruction->optype == Instruction::OPType::LTE_OP ||
-                        my_instruction->optype == Instruction::OPType::EQ_OP) {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32);
-                            num_spd_write_accesses++;
-                        }
-                        (*maa->stats.ALU_NumComparedWords[my_alu_id])++;
-                        if (result_u32 != 0) {
-                            (*maa->stats.ALU_NumTakenWords[my_alu_id])++;
-                        }
-                    } else {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u64 = result_u64;
-                        } else {
-                            maa->spd->setData<uint64_t>(my_dst_tile, my_i, result_u64);
-                            num_spd_write_accesses++;
-                        }
-                    }
-                    break;
+                assert(cond_ready == false || src1_ready == false || src2_ready == false);
+            }
+            if (chunk_end > my_i) {
+                KernelArgs args;
+                args.cond = my_cond_tile == -1 ? nullptr : (const uint32_t *)maa->spd->getTileDataPtr(my_cond_tile, 4) + my_i;
+                args.src1 = maa->spd->getTileDataPtr(my_src1_tile, my_input_word_size) + my_i * my_input_word_size;
+                if (my_src2_tile != -1) {
+                    args.src2 = maa->spd->getTileDataPtr(my_src2_tile, my_src2_word_size) + my_i * my_src2_word_size;
+                } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
+                    args.src2 = maa->rf->getDataPtr(my_instruction->src1RegID);
+                } else {
+                    args.src2 = nullptr;
                 }
-                case Instruction::DataType::INT64_TYPE: {
-                    int64_t src1 = maa->spd->getData<int64_t>(my_src1_tile, my_i);
-                    num_spd_read_data_accesses++;
-                    int64_t src2;
-                    if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
-                        src2 = maa->rf->getData<int64_t>(my_instruction->src1RegID);
-                    } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
-                        src2 = maa->spd->getData<int64_t>(my_src2_tile, my_i);
-                        num_spd_read_data_accesses++;
-                    } else {
-                        src2 = my_red_i64;
-                    }
-                    int64_t result_i64 = 0;
-                    uint32_t result_u32 = 0;
-                    switch (my_instruction->optype) {
-                    case Instruction::OPType::ADD_OP:
-                        result_i64 = src1 + src2;
-                        break;
-                    case Instruction::OPType::SUB_OP:
-                        result_i64 = src1 - src2;
-                        break;
-                    case Instruction::OPType::MUL_OP:
-                        result_i64 = src1 * src2;
-                        break;
-                    case Instruction::OPType::DIV_OP:
-                        result_i64 = src1 / src2;
-                        break;
-                    case Instruction::OPType::MIN_OP:
-                        result_i64 = std::min(src1, src2);
-                        break;
-                    case Instruction::OPType::MAX_OP:
-                        result_i64 = std::max(src1, src2);
-                        break;
-                    case Instruction::OPType::AND_OP:
-                        result_i64 = src1 & src2;
-                        break;
-                    case Instruction::OPType::OR_OP:
-                        result_i64 = src1 | src2;
-                        break;
-                    case Instruction::OPType::XOR_OP:
-                        result_i64 = src1 ^ src2;
-                        break;
-                    case Instruction::OPType::SHL_OP:
-                        result_i64 = src1 << src2;
-                        break;
-                    case Instruction::OPType::SHR_OP:
-                        result_i64 = src1 >> src2;
-                        break;
-                    case Instruction::OPType::GT_OP:
-                        result_u32 = src1 > src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::GTE_OP:
-                        result_u32 = src1 >= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LT_OP:
-                        result_u32 = src1 < src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LTE_OP:
-                        result_u32 = src1 <= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::EQ_OP:
-                        result_u32 = src1 == src2 ? 1 : 0;
-                        break;
-                    default:
-                        assert(false);
-                    }
-                    if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                        my_instruction->optype == Instruction::OPType::GTE_OP ||
-                        my_instruction->optype == Instruction::OPType::LT_OP ||
-                        my_instruction->optype == Instruction::OPType::LTE_OP ||
-                        my_instruction->optype == Instruction::OPType::EQ_OP) {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32);
-                            num_spd_write_accesses++;
-                        }
-                        (*maa->stats.ALU_NumComparedWords[my_alu_id])++;
-                        if (result_u32 != 0) {
-                            (*maa->stats.ALU_NumTakenWords[my_alu_id])++;
-                        }
-                    } else {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_i64 = result_i64;
-                        } else {
-                            maa->spd->setData<uint64_t>(my_dst_tile, my_i, result_i64);
-                            num_spd_write_accesses++;
-                        }
-                    }
-                    break;
+                // Compaction appends the taken elements after the ones packed so far, histograms index from bucket 0
+                int dst_offset = my_instruction->opcode == Instruction::OpcodeType::ALU_COMPACT     ? my_num_packed
+                                 : my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM ? 0
+                                                                                                    : my_i;
+                args.dst = my_dst_tile == -1 ? nullptr : maa->spd->getTileDataPtr(my_dst_tile, my_output_word_size) + dst_offset * my_output_word_size;
+                args.idx = my_instruction->dst2SpdID == -1 ? nullptr : (uint32_t *)maa->spd->getTileDataPtr(my_instruction->dst2SpdID, 4) + dst_offset;
+                args.first_element = my_i;
+                args.num_buckets = my_num_buckets;
+                args.red = my_red;
+                args.identity = my_identity;
+                args.num_elements = chunk_end - my_i;
+                (*my_kernel)(args);
+                DPRINTF(MAAALU, "A[%d] %s: elements [%d-%d) computed, %d taken!\n", my_alu_id, __func__, my_i, chunk_end, args.num_taken);
+                num_alu_accesses += args.num_taken;
+                num_spd_read_data_accesses += args.num_taken;
+                if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
+                    num_spd_read_data_accesses += args.num_taken;
+                } else if (my_is_scan && my_src2_tile != -1) {
+                    num_spd_read_cond_accesses += args.num_elements;
+                } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM && my_src2_tile != -1) {
+                    num_spd_read_data_accesses += args.num_taken;
                 }
-                case Instruction::DataType::FLOAT64_TYPE: {
-                    double src1 = maa->spd->getData<double>(my_src1_tile, my_i);
-                    num_spd_read_data_accesses++;
-                    double src2;
-                    if (my_instruction->opcode == Instruction::OpcodeType::ALU_SCALAR) {
-                        src2 = maa->rf->getData<double>(my_instruction->src1RegID);
-                    } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_VECTOR) {
-                        src2 = maa->spd->getData<double>(my_src2_tile, my_i);
-                        num_spd_read_data_accesses++;
-                    } else {
-                        src2 = my_red_f64;
-                    }
-                    double result_f64 = 0;
-                    uint32_t result_u32 = 0;
-                    switch (my_instruction->optype) {
-                    case Instruction::OPType::ADD_OP:
-                        result_f64 = src1 + src2;
-                        break;
-                    case Instruction::OPType::SUB_OP:
-                        result_f64 = src1 - src2;
-                        break;
-                    case Instruction::OPType::MUL_OP:
-                        result_f64 = src1 * src2;
-                        break;
-                    case Instruction::OPType::DIV_OP:
-                        result_f64 = src1 / src2;
-                        break;
-                    case Instruction::OPType::MIN_OP:
-                        result_f64 = std::min(src1, src2);
-                        break;
-                    case Instruction::OPType::MAX_OP:
-                        result_f64 = std::max(src1, src2);
-                        break;
-                    case Instruction::OPType::GT_OP:
-                        result_u32 = src1 > src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::GTE_OP:
-                        result_u32 = src1 >= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LT_OP:
-                        result_u32 = src1 < src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::LTE_OP:
-                        result_u32 = src1 <= src2 ? 1 : 0;
-                        break;
-                    case Instruction::OPType::EQ_OP:
-                        result_u32 = src1 == src2 ? 1 : 0;
-                        break;
-                    default:
-                        assert(false);
+                if (my_instruction->opcode == Instruction::OpcodeType::ALU_COMPACT) {
+                    maa->spd->setElementsFinished(my_dst_tile, my_num_packed, my_num_packed + args.num_taken, my_output_word_size);
+                    num_spd_write_accesses += args.num_taken;
+                    if (my_instruction->dst2SpdID != -1) {
+                        maa->spd->setElementsFinished(my_instruction->dst2SpdID, my_num_packed, my_num_packed + args.num_taken, 4);
+                        num_spd_write_accesses += args.num_taken;
                     }
-                    if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                        my_instruction->optype == Instruction::OPType::GTE_OP ||
-                        my_instruction->optype == Instruction::OPType::LT_OP ||
-                        my_instruction->optype == Instruction::OPType::LTE_OP ||
-                        my_instruction->optype == Instruction::OPType::EQ_OP) {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_u32 = result_u32;
-                        } else {
-                            maa->spd->setData<uint32_t>(my_dst_tile, my_i, result_u32);
-                            num_spd_write_accesses++;
-                        }
-                        (*maa->stats.ALU_NumComparedWords[my_alu_id])++;
-                        if (result_u32 != 0) {
-                            (*maa->stats.ALU_NumTakenWords[my_alu_id])++;
-                        }
-                    } else {
-                        if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
-                            my_red_f64 = result_f64;
-                        } else {
-                            maa->spd->setData<double>(my_dst_tile, my_i, result_f64);
-                            num_spd_write_accesses++;
-                        }
-                    }
-                    break;
-                }
-                default:
-                    assert(false);
+                    my_num_packed += args.num_taken;
+                } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM) {
+                    // One word write per counted id, the bucket counts are finished at the end
+                    num_spd_write_accesses += args.num_taken;
+                } else if (my_dst_tile != -1) {
+                    maa->spd->setElementsFinished(my_dst_tile, my_i, chunk_end, my_output_word_size);
+                    num_spd_write_accesses += args.num_taken;
                 }
-            } else if (my_dst_tile != -1) {
-                DPRINTF(MAAALU, "A[%d] %s: SPD[%d][%d] = %u (cond not taken)\n", my_alu_id, __func__, my_dst_tile, my_i, 0);
-                if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                    my_instruction->optype == Instruction::OPType::GTE_OP ||
-                    my_instruction->optype == Instruction::OPType::LT_OP ||
-                    my_instruction->optype == Instruction::OPType::LTE_OP ||
-                    my_instruction->optype == Instruction::OPType::EQ_OP) {
-                    maa->spd->setData<uint32_t>(my_dst_tile, my_i, 0);
-                } else {
-                    switch (my_instruction->datatype) {
-                    case Instruction::DataType::UINT32_TYPE: {
-                        maa->spd->setData<uint32_t>(my_dst_tile, my_i, 0);
-                        break;
-                    }
-                    case Instruction::DataType::INT32_TYPE: {
-                        maa->spd->setData<int32_t>(my_dst_tile, my_i, 0);
-                        break;
-                    }
-                    case Instruction::DataType::FLOAT32_TYPE: {
-                        maa->spd->setData<float>(my_dst_tile, my_i, 0);
-                        break;
-                    }
-                    case Instruction::DataType::UINT64_TYPE: {
-                        maa->spd->setData<uint64_t>(my_dst_tile, my_i, 0);
-                        break;
-                    }
-                    case Instruction::DataType::INT64_TYPE: {
-                        maa->spd->setData<int64_t>(my_dst_tile, my_i, 0);
-                        break;
-                    }
-                    case Instruction::DataType::FLOAT64_TYPE: {
-                        maa->spd->setData<double>(my_dst_tile, my_i, 0);
-                        break;
-                    }
-                    default:
-                        assert(false);
-                    }
+                if (my_is_compare) {
+                    (*maa->stats.ALU_NumComparedWords[my_alu_id]) += args.num_taken;
+                    (*maa->stats.ALU_NumTakenWords[my_alu_id]) += args.num_nonzero;
                 }
+                my_i = chunk_end;
+            }
+            if (chunk_ready == false) {
+                updateLatency(num_spd_read_data_accesses, num_spd_read_cond_accesses, num_spd_write_accesses, num_alu_accesses);
+                return;
             }
-            my_i++;
         }
         updateLatency(num_spd_read_data_accesses, num_spd_read_cond_accesses, num_spd_write_accesses, num_alu_accesses);
         DPRINTF(MAAALU, "A[%d] %s: setting state to finish for request %s!\n", my_alu_id, __func__, my_instruction->print());
@@ -838,29 +884,32 @@ void ALUUnit::executeInstruction() {
         panic_if(my_cond_tile_ready == false, "A[%d] %s: cond tile[%d] not ready!\n", my_alu_id, __func__, my_cond_tile);
         panic_if(my_src1_tile_ready == false, "A[%d] %s: src1 tile[%d] not ready!\n", my_alu_id, __func__, my_src1_tile);
         panic_if(my_src2_tile_ready == false, "A[%d] %s: src2 tile[%d] not ready!\n", my_alu_id, __func__, my_src2_tile);
-        if (my_dst_tile != -1) {
+        if (my_instruction->opcode == Instruction::OpcodeType::ALU_COMPACT) {
+            DPRINTF(MAAALU, "A[%d] %s: %d of %d elements packed!\n", my_alu_id, __func__, my_num_packed, my_i);
+            maa->spd->setSize(my_dst_tile, my_num_packed);
+            if (my_instruction->dst2SpdID != -1) {
+                maa->spd->setSize(my_instruction->dst2SpdID, my_num_packed);
+            }
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM) {
+            maa->spd->setElementsFinished(my_dst_tile, 0, my_num_buckets, my_output_word_size);
+            maa->spd->setSize(my_dst_tile, my_num_buckets);
+        } else if (my_dst_tile != -1) {
             maa->spd->setSize(my_dst_tile, my_i);
         } else {
             panic_if(my_instruction->opcode != Instruction::OpcodeType::ALU_REDUCE, "A[%d] %s: ALU_VECTOR/ALU_SCALAR without dst_tile!\n", my_alu_id, __func__);
-            if (my_instruction->optype == Instruction::OPType::GT_OP ||
-                my_instruction->optype == Instruction::OPType::GTE_OP ||
-                my_instruction->optype == Instruction::OPType::LT_OP ||
-                my_instruction->optype == Instruction::OPType::LTE_OP ||
-                my_instruction->optype == Instruction::OPType::EQ_OP ||
-                my_instruction->datatype == Instruction::DataType::UINT32_TYPE) {
-                maa->rf->setData<uint32_t>(my_instruction->dst1RegID, my_red_u32);
-            } else if (my_instruction->datatype == Instruction::DataType::INT32_TYPE) {
-                maa->rf->setData<int32_t>(my_instruction->dst1RegID, my_red_i32);
-            } else if (my_instruction->datatype == Instruction::DataType::FLOAT32_TYPE) {
-                maa->rf->setData<float>(my_instruction->dst1RegID, my_red_f32);
-            } else if (my_instruction->datatype == Instruction::DataType::UINT64_TYPE) {
-                maa->rf->setData<uint64_t>(my_instruction->dst1RegID, my_red_u64);
-            } else if (my_instruction->datatype == Instruction::DataType::INT64_TYPE) {
-                maa->rf->setData<int64_t>(my_instruction->dst1RegID, my_red_i64);
-            } else if (my_instruction->datatype == Instruction::DataType::FLOAT64_TYPE) {
-                maa->rf->setData<double>(my_instruction->dst1RegID, my_red_f64);
+        }
+        // Reductions write their result and scans their carry-out
+        if (my_instruction->dst1RegID != -1) {
+            if (my_instruction->datatype == Instruction::DataType::BIT_TYPE) {
+                // Popcounts are 4-byte counts
+                maa->rf->setData<uint32_t>(my_instruction->dst1RegID, *((uint32_t *)my_red));
+            } else if (my_input_word_size == 8) {
+                maa->rf->setData<uint64_t>(my_instruction->dst1RegID, *((uint64_t *)my_red));
             } else {
-                assert(false);
+                // Sub-word results are zero-extended to the 4-byte register
+                uint32_t red_u32 = 0;
+                std::memcpy(&red_u32, my_red, my_input_word_size);
+                maa->rf->setData<uint32_t>(my_instruction->dst1RegID, red_u32);
             }
         }
         maa->finishInstructionCompute(my_instruction);
@@ -872,6 +921,14 @@ void ALUUnit::executeInstruction() {
             maa->stats.cycles_ALUV += total_cycles;
         } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_REDUCE) {
             maa->stats.cycles_ALUR += total_cycles;
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_COMPACT) {
+            maa->stats.cycles_ALUC += total_cycles;
+        } else if (my_is_scan) {
+            maa->stats.cycles_ALUSC += total_cycles;
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_HISTOGRAM) {
+            maa->stats.cycles_ALUH += total_cycles;
+        } else if (my_instruction->opcode == Instruction::OpcodeType::ALU_CVT) {
+            maa->stats.cycles_ALUCV += total_cycles;
         } else {
             assert(false);
         }
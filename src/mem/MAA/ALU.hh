@@ -14,6 +14,24 @@ class Instruction;
 
 class ALUUnit {
 public:
+    // Arguments of an ALU kernel over a chunk of ready elements. All pointers
+    // are offset to the first element of the chunk.
+    struct KernelArgs {
+        const uint32_t *cond;    // nullptr if unconditional
+        const uint8_t *src1;
+        const uint8_t *src2;     // tile for ALU_VECTOR, register for ALU_SCALAR, segment flags for ALU_SCAN
+        uint8_t *dst;            // nullptr for ALU_REDUCE, next packed slot for ALU_COMPACT
+        uint32_t *idx;           // original indices of the packed elements, nullptr if not needed
+        int first_element;       // tile element of the first element of the chunk
+        int num_buckets;         // ALU_HISTOGRAM buckets, ids beyond it are dropped
+        uint8_t *red;            // accumulator for ALU_REDUCE, running value for ALU_SCAN
+        const uint8_t *identity; // value a new ALU_SCAN segment starts from
+        int num_elements;
+        int num_taken;           // elements that passed the condition
+        int num_nonzero;         // taken elements with a nonzero comparison result
+    };
+    typedef void (*Kernel)(KernelArgs &args);
+
     enum class Status : uint8_t {
         Idle = 0,
         Decode = 1,
@@ -50,8 +68,11 @@ protected:
     int my_dst_tile, my_dst_reg, my_cond_tile, my_src1_tile, my_src2_tile;
     bool my_cond_tile_ready, my_src1_tile_ready, my_src2_tile_ready;
     int my_i, my_max;
+    int my_num_packed;
+    int my_num_buckets;
     int my_input_word_size;
     int my_input_words_per_cl;
+    int my_src2_word_size;
     int my_output_word_size;
     int my_output_words_per_cl;
     Cycles ALU_lane_latency;
@@ -61,12 +82,12 @@ protected:
     Tick my_ALU_finish_tick;
     Tick my_decode_start_tick;
     int num_tile_elements;
-    int32_t my_red_i32;
-    uint32_t my_red_u32;
-    int64_t my_red_i64;
-    uint64_t my_red_u64;
-    float my_red_f32;
-    double my_red_f64;
+    bool my_is_compare;
+    bool my_is_scan;
+    int my_lane_depth;
+    Kernel my_kernel;
+    alignas(8) uint8_t my_red[8];
+    alignas(8) uint8_t my_identity[8];
 
     void executeInstruction();
     void updateLatency(int num_spd_read_data_accesses,
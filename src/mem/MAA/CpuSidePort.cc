@@ -91,10 +91,9 @@ void MAA::recvTimingReq(PacketPtr pkt, int core_id) {
             panic_if(pkt->getSize() != 64, "Invalid size for SPD data: %d\n", pkt->getSize());
             int element_id = (offset % (num_tile_elements * sizeof(uint32_t))) / sizeof(uint32_t);
             for (int i = 0; i < 64 / sizeof(uint32_t); i++) {
-                uint32_t data = pkt->getPtr<uint32_t>()[i];
-                DPRINTF(MAACpuPort, "%s: TILE[%d][%d] = %u\n", __func__, tile_id, element_id + i, data);
-                spd->setData<uint32_t>(tile_id, element_id + i, data);
+                DPRINTF(MAACpuPort, "%s: TILE[%d][%d] = %u\n", __func__, tile_id, element_id + i, pkt->getPtr<uint32_t>()[i]);
             }
+            spd->setData<uint32_t>(tile_id, element_id, 64 / sizeof(uint32_t), pkt->getPtr<uint32_t>());
             assert(pkt->needsResponse() == false);
             pendingDelete.reset(pkt);
             break;
@@ -199,7 +198,9 @@ void MAA::recvTimingReq(PacketPtr pkt, int core_id) {
                 current_instruction->opcode = (data & NA_UINT8) == NA_UINT8 ? Instruction::OpcodeType::MAX : static_cast<Instruction::OpcodeType>(data & NA_UINT8);
                 assert(current_instruction->opcode != Instruction::OpcodeType::MAX);
                 if (current_instruction->opcode == Instruction::OpcodeType::STREAM_LD ||
-                    current_instruction->opcode == Instruction::OpcodeType::INDIR_LD) {
+                    current_instruction->opcode == Instruction::OpcodeType::INDIR_LD ||
+                    current_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ||
+                    current_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
                     current_instruction->accessType = Instruction::AccessType::READ;
                 } else if (current_instruction->opcode == Instruction::OpcodeType::STREAM_ST ||
                            current_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR ||
@@ -243,12 +244,26 @@ void MAA::recvTimingReq(PacketPtr pkt, int core_id) {
                     current_instruction->minAddr = addrRegions[current_instruction->addrRangeID].first;
                     current_instruction->maxAddr = addrRegions[current_instruction->addrRangeID].second;
                 }
+                if (current_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED) {
+                    panic_if(current_instruction->baseAddr2 == 0xFFFFFFFFFFFFFFFF, "Received %s without instruction[3]!\n", current_instruction->print());
+                    current_instruction->addrRangeID2 = getAddrRegion(current_instruction->baseAddr2);
+                    current_instruction->minAddr2 = addrRegions[current_instruction->addrRangeID2].first;
+                    current_instruction->maxAddr2 = addrRegions[current_instruction->addrRangeID2].second;
+                    // The invalidator grants a single region permit per instruction
+                    panic_if(num_maas > 1 && current_instruction->addrRangeID2 != current_instruction->addrRangeID,
+                             "%s: chained arrays must share an address region with multiple MAAs!\n", current_instruction->print());
+                }
                 my_instruction_recvs[instruction_id] = true;
                 DPRINTF(MAAController, "%s: %s received!\n", __func__, current_instruction->print());
                 respond_immediately = false;
                 scheduleDispatchInstructionEvent();
                 break;
             }
+            case 3: {
+                panic_if(instruction_id == -1, "Received new instruction[3] before insturction[0]!\n");
+                current_instruction->baseAddr2 = data;
+                break;
+            }
             default:
                 assert(false);
             }
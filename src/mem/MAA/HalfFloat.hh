@@ -0,0 +1,118 @@
+#ifndef __MEM_MAA_HALF_FLOAT_HH__
+#define __MEM_MAA_HALF_FLOAT_HH__
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace gem5 {
+
+// 16-bit floating point storage types. Arithmetic and comparisons go through
+// float, and results are rounded back to nearest-even when stored.
+// is_bf16 = false: IEEE binary16 (FP16), 5-bit exponent and 10-bit mantissa
+// is_bf16 = true: bfloat16 (BF16), the upper half of an IEEE binary32
+template <bool is_bf16>
+struct HalfFloat {
+    uint16_t bits;
+
+    constexpr HalfFloat() : bits(0) {}
+    HalfFloat(float value) : bits(fromFloat(value)) {}
+    operator float() const { return toFloat(bits); }
+    HalfFloat &operator+=(HalfFloat other) {
+        bits = fromFloat(toFloat(bits) + toFloat(other.bits));
+        return *this;
+    }
+    static constexpr HalfFloat fromBits(uint16_t _bits) {
+        HalfFloat value;
+        value.bits = _bits;
+        return value;
+    }
+
+    static uint16_t fromFloat(float value) {
+        uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        if constexpr (is_bf16) {
+            if ((x & 0x7FFFFFFF) > 0x7F800000) {
+                // Keeping NaNs quiet, rounding could turn them into infinities
+                return (x >> 16) | 0x0040;
+            }
+            return (x + 0x7FFF + ((x >> 16) & 1)) >> 16;
+        } else {
+            uint32_t sign = (x >> 16) & 0x8000;
+            uint32_t exponent = (x >> 23) & 0xFF;
+            uint32_t mantissa = x & 0x7FFFFF;
+            if (exponent == 0xFF) {
+                return sign | 0x7C00 | (mantissa != 0 ? 0x0200 : 0);
+            }
+            int half_exponent = (int)exponent - 127 + 15;
+            if (half_exponent >= 31) {
+                return sign | 0x7C00;
+            }
+            int shift = 13;
+            uint32_t half = 0;
+            if (half_exponent <= 0) {
+                // Subnormal, the implicit one becomes explicit
+                if (half_exponent < -10) {
+                    return sign;
+                }
+                mantissa |= 0x800000;
+                shift = 14 - half_exponent;
+            } else {
+                half = (uint32_t)half_exponent << 10;
+            }
+            half |= mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            // A carry out of the mantissa correctly bumps the exponent
+            if (remainder > halfway || (remainder == halfway && (half & 1))) {
+                half++;
+            }
+            return sign | half;
+        }
+    }
+    static float toFloat(uint16_t value) {
+        uint32_t x;
+        if constexpr (is_bf16) {
+            x = (uint32_t)value << 16;
+        } else {
+            uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+            uint32_t exponent = (value >> 10) & 0x1F;
+            uint32_t mantissa = value & 0x3FF;
+            if (exponent == 0) {
+                float subnormal = std::ldexp((float)mantissa, -24);
+                return sign != 0 ? -subnormal : subnormal;
+            } else if (exponent == 0x1F) {
+                x = sign | 0x7F800000 | (mantissa << 13);
+            } else {
+                x = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+            }
+        }
+        float result;
+        std::memcpy(&result, &x, sizeof(result));
+        return result;
+    }
+};
+typedef HalfFloat<false> float16_t;
+typedef HalfFloat<true> bfloat16_t;
+
+static_assert(sizeof(float16_t) == 2 && sizeof(bfloat16_t) == 2, "Half floats must be packed in 2 bytes!");
+
+} // namespace gem5
+
+namespace std {
+// Limits used by the reduction identities and the kernel type checks
+template <bool is_bf16>
+class numeric_limits<gem5::HalfFloat<is_bf16>> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_signed = true;
+    static constexpr bool has_infinity = true;
+    static constexpr gem5::HalfFloat<is_bf16> max() { return gem5::HalfFloat<is_bf16>::fromBits(is_bf16 ? 0x7F7F : 0x7BFF); }
+    static constexpr gem5::HalfFloat<is_bf16> lowest() { return gem5::HalfFloat<is_bf16>::fromBits(is_bf16 ? 0xFF7F : 0xFBFF); }
+    static constexpr gem5::HalfFloat<is_bf16> infinity() { return gem5::HalfFloat<is_bf16>::fromBits(is_bf16 ? 0x7F80 : 0x7C00); }
+};
+} // namespace std
+
+#endif // __MEM_MAA_HALF_FLOAT_HH__
@@ -2,6 +2,7 @@
 #include "mem/MAA/MAA.hh"
 #include "debug/MAAController.hh"
 #include "mem/MAA/SPD.hh"
+#include <algorithm>
 #include <cassert>
 
 #ifndef TRACING_ON
@@ -10,6 +11,8 @@
 
 namespace gem5 {
 Instruction::Instruction() : baseAddr(0xFFFFFFFFFFFFFFFF),
+                             baseAddr2(0xFFFFFFFFFFFFFFFF),
+                             addrRangeID2(-1),
                              src1RegID(-1),
                              src2RegID(-1),
                              src3RegID(-1),
@@ -42,12 +45,14 @@ std::string Instruction::print() const {
     std::sprintf(minAddrStr, "0x%lx", minAddr);
     char maxAddrStr[32];
     std::sprintf(maxAddrStr, "0x%lx", maxAddr);
+    char baseAddr2Str[32];
+    std::sprintf(baseAddr2Str, "0x%lx", baseAddr2);
     std::ostringstream str;
-    ccprintf(str, "INSTR[%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s]",
+    ccprintf(str, "INSTR[%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s]",
              "core_id(" + std::to_string(core_id) + ")",
              " maa_id(" + std::to_string(maa_id) + ")",
              " opcode(" + opcode_names[(int)opcode] + ")",
-             optype == OPType::MAX ? "" : " optype(" + optype_names[(int)optype] + ")",
+             optype == OPType::MAX ? "" : (opcode == OpcodeType::ALU_CVT ? " to(" + datatype_names[(int)optype] + ")" : " optype(" + optype_names[(int)optype] + ")"),
              " datatype(" + datatype_names[(int)datatype] + ")",
              " state(" + status_names[(int)state] + ")",
              src1SpdID == -1 ? "" : " srcSPD1(" + std::to_string(src1SpdID) + "/" + tile_status_names[(uint8_t)src1Status] + ")",
@@ -60,7 +65,8 @@ std::string Instruction::print() const {
              dst1RegID == -1 ? "" : " dstREG1(" + std::to_string(dst1RegID) + ")",
              dst2RegID == -1 ? "" : " dstREG2(" + std::to_string(dst2RegID) + ")",
              condSpdID == -1 ? "" : " condSPD(" + std::to_string(condSpdID) + "/" + tile_status_names[(uint8_t)condStatus] + ")",
-             baseAddr != 0xFFFFFFFFFFFFFFFF ? " baseAddr(" + std::string(baseAddrStr) + ") minAddr(" + std::string(minAddrStr) + ") maxAddr(" + std::string(maxAddrStr) + ")" : "");
+             baseAddr != 0xFFFFFFFFFFFFFFFF ? " baseAddr(" + std::string(baseAddrStr) + ") minAddr(" + std::string(minAddrStr) + ") maxAddr(" + std::string(maxAddrStr) + ")" : "",
+             baseAddr2 != 0xFFFFFFFFFFFFFFFF ? " baseAddr2(" + std::string(baseAddr2Str) + ")" : "");
     return str.str();
 }
 int Instruction::getWordSize(int tile_id) {
@@ -72,14 +78,21 @@ int Instruction::getWordSize(int tile_id) {
         case OpcodeType::ALU_SCALAR:
         case OpcodeType::ALU_VECTOR:
         case OpcodeType::ALU_REDUCE:
+        case OpcodeType::ALU_COMPACT:
+        case OpcodeType::ALU_SCAN:
+        case OpcodeType::ALU_SCAN_EXCL:
+        case OpcodeType::ALU_CVT:
         case OpcodeType::STREAM_ST: {
             return WordSize();
         }
         case OpcodeType::INDIR_LD:
+        case OpcodeType::INDIR_LD_CHAINED:
+        case OpcodeType::INDIR_PROBE:
         case OpcodeType::INDIR_ST_VECTOR:
         case OpcodeType::INDIR_ST_SCALAR:
         case OpcodeType::INDIR_RMW_VECTOR:
         case OpcodeType::INDIR_RMW_SCALAR:
+        case OpcodeType::ALU_HISTOGRAM:
         case OpcodeType::RANGE_LOOP: {
             return 4;
         }
@@ -90,9 +103,12 @@ int Instruction::getWordSize(int tile_id) {
         switch (opcode) {
         case OpcodeType::INDIR_ST_VECTOR:
         case OpcodeType::INDIR_RMW_VECTOR:
-        case OpcodeType::ALU_VECTOR: {
+        case OpcodeType::ALU_VECTOR:
+        case OpcodeType::ALU_HISTOGRAM: {
             return WordSize();
         }
+        case OpcodeType::ALU_SCAN:
+        case OpcodeType::ALU_SCAN_EXCL:
         case OpcodeType::RANGE_LOOP: {
             return 4;
         }
@@ -110,7 +126,13 @@ int Instruction::getWordSize(int tile_id) {
             }
         }
         case OpcodeType::STREAM_LD:
+        case OpcodeType::ALU_COMPACT:
+        case OpcodeType::ALU_SCAN:
+        case OpcodeType::ALU_SCAN_EXCL:
+        case OpcodeType::ALU_HISTOGRAM:
         case OpcodeType::INDIR_LD:
+        case OpcodeType::INDIR_LD_CHAINED:
+        case OpcodeType::INDIR_PROBE:
         case OpcodeType::INDIR_ST_VECTOR:
         case OpcodeType::INDIR_ST_SCALAR:
         case OpcodeType::INDIR_RMW_VECTOR:
@@ -120,11 +142,18 @@ int Instruction::getWordSize(int tile_id) {
         case OpcodeType::RANGE_LOOP: {
             return 4;
         }
+        case OpcodeType::ALU_CVT: {
+            return DataTypeSize(CvtDataType());
+        }
         default:
             assert(false);
         }
     } else if (tile_id == dst2SpdID) {
         switch (opcode) {
+        case OpcodeType::INDIR_RMW_VECTOR:
+        case OpcodeType::INDIR_RMW_SCALAR:
+        case OpcodeType::INDIR_PROBE:
+        case OpcodeType::ALU_COMPACT:
         case OpcodeType::RANGE_LOOP: {
             return 4;
         }
@@ -138,7 +167,19 @@ int Instruction::getWordSize(int tile_id) {
     return -1;
 }
 int Instruction::WordSize() {
-    switch (datatype) {
+    return DataTypeSize(datatype);
+}
+int Instruction::DataTypeSize(DataType _datatype) {
+    switch (_datatype) {
+    case DataType::UINT8_TYPE:
+    case DataType::INT8_TYPE:
+    case DataType::BIT_TYPE:
+        return 1;
+    case DataType::UINT16_TYPE:
+    case DataType::INT16_TYPE:
+    case DataType::FLOAT16_TYPE:
+    case DataType::BFLOAT16_TYPE:
+        return 2;
     case DataType::UINT32_TYPE:
     case DataType::INT32_TYPE:
     case DataType::FLOAT32_TYPE:
@@ -161,6 +202,8 @@ bool IF::pushInstruction(Instruction _instruction) {
         break;
     }
     case Instruction::OpcodeType::INDIR_LD:
+    case Instruction::OpcodeType::INDIR_LD_CHAINED:
+    case Instruction::OpcodeType::INDIR_PROBE:
     case Instruction::OpcodeType::INDIR_ST_VECTOR:
     case Instruction::OpcodeType::INDIR_ST_SCALAR:
     case Instruction::OpcodeType::INDIR_RMW_VECTOR:
@@ -174,7 +217,12 @@ bool IF::pushInstruction(Instruction _instruction) {
     }
     case Instruction::OpcodeType::ALU_SCALAR:
     case Instruction::OpcodeType::ALU_VECTOR:
-    case Instruction::OpcodeType::ALU_REDUCE: {
+    case Instruction::OpcodeType::ALU_REDUCE:
+    case Instruction::OpcodeType::ALU_COMPACT:
+    case Instruction::OpcodeType::ALU_SCAN:
+    case Instruction::OpcodeType::ALU_SCAN_EXCL:
+    case Instruction::OpcodeType::ALU_HISTOGRAM:
+    case Instruction::OpcodeType::ALU_CVT: {
         _instruction.funcUniType = FuncUnitType::ALU;
         break;
     }
@@ -210,6 +258,19 @@ bool IF::pushInstruction(Instruction _instruction) {
                     return false;
                 }
             }
+            // Registers are not renamed, so an in-flight register writer blocks its readers and writers
+            for (int reg_id : {_instruction.src1RegID, _instruction.src2RegID, _instruction.src3RegID, _instruction.dst1RegID, _instruction.dst2RegID}) {
+                if (reg_id != -1 && (reg_id == instructions[maa_id][i].dst1RegID || reg_id == instructions[maa_id][i].dst2RegID)) {
+                    DPRINTF(MAAController, "%s: %s cannot be pushed b/c of %s!\n", __func__, _instruction.print(), instructions[maa_id][i].print());
+                    return false;
+                }
+            }
+            for (int reg_id : {_instruction.dst1RegID, _instruction.dst2RegID}) {
+                if (reg_id != -1 && (reg_id == instructions[maa_id][i].src1RegID || reg_id == instructions[maa_id][i].src2RegID || reg_id == instructions[maa_id][i].src3RegID)) {
+                    DPRINTF(MAAController, "%s: %s cannot be pushed b/c of %s!\n", __func__, _instruction.print(), instructions[maa_id][i].print());
+                    return false;
+                }
+            }
             if (_instruction.addrRangeID == instructions[maa_id][i].addrRangeID) {
                 if ((_instruction.accessType == Instruction::AccessType::WRITE && instructions[maa_id][i].accessType != Instruction::AccessType::COMPUTE) || // WAR hazard
                     (_instruction.accessType == Instruction::AccessType::READ && instructions[maa_id][i].accessType == Instruction::AccessType::WRITE)) {    // RAW hazard
@@ -217,6 +278,12 @@ bool IF::pushInstruction(Instruction _instruction) {
                     return false;
                 }
             }
+            // The second-level array of a chained load is read as well
+            if ((_instruction.addrRangeID2 != -1 && _instruction.addrRangeID2 == instructions[maa_id][i].addrRangeID && instructions[maa_id][i].accessType == Instruction::AccessType::WRITE) || // RAW hazard
+                (instructions[maa_id][i].addrRangeID2 != -1 && _instruction.addrRangeID == instructions[maa_id][i].addrRangeID2 && _instruction.accessType == Instruction::AccessType::WRITE)) {  // WAR hazard
+                DPRINTF(MAAController, "%s: %s cannot be pushed b/c of %s!\n", __func__, _instruction.print(), instructions[maa_id][i].print());
+                return false;
+            }
         }
     }
     if (free_instruction_slot == -1) {
@@ -227,6 +294,21 @@ bool IF::pushInstruction(Instruction _instruction) {
     instructions[maa_id][free_instruction_slot] = _instruction;
     valids[maa_id][free_instruction_slot] = true;
     instructions[maa_id][free_instruction_slot].if_id = free_instruction_slot;
+    push_seqs[maa_id][free_instruction_slot] = next_push_seq++;
+    num_dependents[maa_id][free_instruction_slot] = 0;
+    for (int i = 0; i < num_instructions_per_maa; i++) {
+        if (valids[maa_id][i] && i != free_instruction_slot) {
+            for (int tile_id : {_instruction.src1SpdID, _instruction.src2SpdID, _instruction.condSpdID}) {
+                if (tile_id != -1 && (tile_id == instructions[maa_id][i].dst1SpdID || tile_id == instructions[maa_id][i].dst2SpdID) &&
+                    dependencies[maa_id][free_instruction_slot * num_instructions_per_maa + i] == false) {
+                    dependencies[maa_id][free_instruction_slot * num_instructions_per_maa + i] = true;
+                    num_dependents[maa_id][i]++;
+                    reorderReadyQueues(maa_id, i);
+                }
+            }
+        }
+    }
+    updateReadyQueues(maa_id, free_instruction_slot);
     DPRINTF(MAAController, "%s: %s pushed to instruction[%d]!\n", __func__, _instruction.print(), free_instruction_slot);
     return true;
 }
@@ -247,54 +329,157 @@ bool IF::canPushRegister(Register _reg) {
     }
     return true;
 }
+bool IF::isReadyCompute(int maa_id, int instr_idx) {
+    const Instruction &instruction = instructions[maa_id][instr_idx];
+    return valids[maa_id][instr_idx] &&
+           instruction.maa_id == maa_id &&
+           instruction.state == Instruction::Status::Idle &&
+           (instruction.src1SpdID == -1 || instruction.src1Status == Instruction::TileStatus::Service || instruction.src1Status == Instruction::TileStatus::Finished) &&
+           (instruction.src2SpdID == -1 || instruction.src2Status == Instruction::TileStatus::Service || instruction.src2Status == Instruction::TileStatus::Finished) &&
+           (instruction.condSpdID == -1 || instruction.condStatus == Instruction::TileStatus::Service || instruction.condStatus == Instruction::TileStatus::Finished) &&
+           (instruction.dst1SpdID == -1 || instruction.dst1Status == Instruction::TileStatus::WaitForService) &&
+           (instruction.dst2SpdID == -1 || instruction.dst2Status == Instruction::TileStatus::WaitForService);
+}
+int IF::getInvalidateTile(int maa_id, int instr_idx) {
+    const Instruction &instruction = instructions[maa_id][instr_idx];
+    if (valids[maa_id][instr_idx] == false || instruction.state != Instruction::Status::Idle) {
+        return -1;
+    }
+    if (instruction.dst1Status == Instruction::TileStatus::WaitForInvalidation) {
+        return instruction.dst1SpdID;
+    } else if (instruction.dst2Status == Instruction::TileStatus::WaitForInvalidation) {
+        return instruction.dst2SpdID;
+    } else if (instruction.src1Status == Instruction::TileStatus::WaitForInvalidation) {
+        return instruction.src1SpdID;
+    } else if (instruction.src2Status == Instruction::TileStatus::WaitForInvalidation) {
+        return instruction.src2SpdID;
+    } else if (instruction.condStatus == Instruction::TileStatus::WaitForInvalidation) {
+        return instruction.condSpdID;
+    }
+    return -1;
+}
+bool IF::issueBefore(int maa_id, int instr_idx1, int instr_idx2) {
+    switch (issue_policy) {
+    case enums::OldestFirst: {
+        return push_seqs[maa_id][instr_idx1] < push_seqs[maa_id][instr_idx2];
+    }
+    case enums::CriticalPath: {
+        if (num_dependents[maa_id][instr_idx1] != num_dependents[maa_id][instr_idx2]) {
+            return num_dependents[maa_id][instr_idx1] > num_dependents[maa_id][instr_idx2];
+        }
+        return push_seqs[maa_id][instr_idx1] < push_seqs[maa_id][instr_idx2];
+    }
+    case enums::RoundRobin: {
+        // Kept in slot order, getReadyStart rotates it to the slot after the last issued one
+        return instr_idx1 < instr_idx2;
+    }
+    default:
+        panic("Invalid issue policy %d!\n", (int)issue_policy);
+    }
+    return false;
+}
+void IF::insertReady(int maa_id, uint8_t func_unit_type, int instr_idx) {
+    std::vector<int> &ready_queue = ready_queues[maa_id][func_unit_type];
+    if (std::find(ready_queue.begin(), ready_queue.end(), instr_idx) != ready_queue.end()) {
+        return;
+    }
+    auto it = std::upper_bound(ready_queue.begin(), ready_queue.end(), instr_idx, [this, maa_id](int instr_idx1, int instr_idx2) {
+        return issueBefore(maa_id, instr_idx1, instr_idx2);
+    });
+    ready_queue.insert(it, instr_idx);
+}
+void IF::removeReady(int maa_id, uint8_t func_unit_type, int instr_idx) {
+    std::vector<int> &ready_queue = ready_queues[maa_id][func_unit_type];
+    auto it = std::find(ready_queue.begin(), ready_queue.end(), instr_idx);
+    if (it != ready_queue.end()) {
+        ready_queue.erase(it);
+    }
+}
+int IF::getReadyStart(int maa_id, uint8_t func_unit_type) {
+    std::vector<int> &ready_queue = ready_queues[maa_id][func_unit_type];
+    if (issue_policy != enums::RoundRobin) {
+        return 0;
+    }
+    int start = std::upper_bound(ready_queue.begin(), ready_queue.end(), last_issued[maa_id][func_unit_type]) - ready_queue.begin();
+    return start == ready_queue.size() ? 0 : start;
+}
+void IF::updateReadyQueues(int maa_id, int instr_idx) {
+    if (getInvalidateTile(maa_id, instr_idx) != -1) {
+        insertReady(maa_id, (uint8_t)FuncUnitType::INVALIDATOR, instr_idx);
+    } else {
+        removeReady(maa_id, (uint8_t)FuncUnitType::INVALIDATOR, instr_idx);
+    }
+    uint8_t func_unit_type = (uint8_t)instructions[maa_id][instr_idx].funcUniType;
+    if (func_unit_type == (uint8_t)FuncUnitType::MAX) {
+        return;
+    }
+    if (isReadyCompute(maa_id, instr_idx)) {
+        insertReady(maa_id, func_unit_type, instr_idx);
+    } else {
+        removeReady(maa_id, func_unit_type, instr_idx);
+    }
+}
+void IF::reorderReadyQueues(int maa_id, int instr_idx) {
+    // Only the critical-path order depends on the number of dependents
+    if (issue_policy != enums::CriticalPath) {
+        return;
+    }
+    for (uint8_t func_unit_type : {(uint8_t)FuncUnitType::INVALIDATOR, (uint8_t)instructions[maa_id][instr_idx].funcUniType}) {
+        if (func_unit_type == (uint8_t)FuncUnitType::MAX) {
+            continue;
+        }
+        std::vector<int> &ready_queue = ready_queues[maa_id][func_unit_type];
+        if (std::find(ready_queue.begin(), ready_queue.end(), instr_idx) != ready_queue.end()) {
+            removeReady(maa_id, func_unit_type, instr_idx);
+            insertReady(maa_id, func_unit_type, instr_idx);
+        }
+    }
+}
+void IF::releaseDependencies(int maa_id, int instr_idx, int tile_id) {
+    // Drops the dependencies of instr_idx on the writers of tile_id, or on all writers if tile_id is -1
+    for (int i = 0; i < num_instructions_per_maa; i++) {
+        if (dependencies[maa_id][instr_idx * num_instructions_per_maa + i] == false) {
+            continue;
+        }
+        if (tile_id != -1 && instructions[maa_id][i].dst1SpdID != tile_id && instructions[maa_id][i].dst2SpdID != tile_id) {
+            continue;
+        }
+        dependencies[maa_id][instr_idx * num_instructions_per_maa + i] = false;
+        assert(num_dependents[maa_id][i] > 0);
+        num_dependents[maa_id][i]--;
+        reorderReadyQueues(maa_id, i);
+    }
+}
 Instruction *IF::getReady(FuncUnitType funcUniType, int maa_id) {
-    int rand_base = rand() % num_instructions_per_maa;
     if (funcUniType == FuncUnitType::INVALIDATOR) {
         panic_if(maa_id != -1, "Invalidator cannot have maa_id!\n");
-        int mid_base = rand() % num_maas;
-        for (int mid_offset = 0; mid_offset < num_maas; mid_offset++) {
-            int mid = (mid_base + mid_offset) % num_maas;
-            for (int i = 0; i < num_instructions_per_maa; i++) {
-                int instr_idx = (rand_base + i) % num_instructions_per_maa;
-                if (valids[mid][instr_idx] && instructions[mid][instr_idx].state == Instruction::Status::Idle) {
-                    int tile_id = -1;
-                    if (instructions[mid][instr_idx].dst1Status == Instruction::TileStatus::WaitForInvalidation) {
-                        tile_id = instructions[mid][instr_idx].dst1SpdID;
-                    } else if (instructions[mid][instr_idx].dst2Status == Instruction::TileStatus::WaitForInvalidation) {
-                        tile_id = instructions[mid][instr_idx].dst2SpdID;
-                    } else if (instructions[mid][instr_idx].src1Status == Instruction::TileStatus::WaitForInvalidation) {
-                        tile_id = instructions[mid][instr_idx].src1SpdID;
-                    } else if (instructions[mid][instr_idx].src2Status == Instruction::TileStatus::WaitForInvalidation) {
-                        tile_id = instructions[mid][instr_idx].src2SpdID;
-                    } else if (instructions[mid][instr_idx].condStatus == Instruction::TileStatus::WaitForInvalidation) {
-                        tile_id = instructions[mid][instr_idx].condSpdID;
-                    }
-                    if (tile_id != -1) {
-                        issueInstructionInvalidate(&instructions[mid][instr_idx], tile_id);
-                        DPRINTF(MAAController, "%s: returned instruction[%d] %s for invalidation!\n", __func__, instr_idx, instructions[mid][instr_idx].print());
-                        return &instructions[mid][instr_idx];
-                    }
-                }
+        // MAAs take turns in invalidation, starting after the last invalidated one
+        for (int mid_offset = 1; mid_offset <= num_maas; mid_offset++) {
+            int mid = (last_invalidated_maa + mid_offset) % num_maas;
+            std::vector<int> &ready_queue = ready_queues[mid][(uint8_t)FuncUnitType::INVALIDATOR];
+            if (ready_queue.empty() == false) {
+                int instr_idx = ready_queue[getReadyStart(mid, (uint8_t)FuncUnitType::INVALIDATOR)];
+                int tile_id = getInvalidateTile(mid, instr_idx);
+                assert(tile_id != -1);
+                last_invalidated_maa = mid;
+                last_issued[mid][(uint8_t)FuncUnitType::INVALIDATOR] = instr_idx;
+                issueInstructionInvalidate(&instructions[mid][instr_idx], tile_id);
+                DPRINTF(MAAController, "%s: returned instruction[%d] %s for invalidation!\n", __func__, instr_idx, instructions[mid][instr_idx].print());
+                return &instructions[mid][instr_idx];
             }
         }
     } else {
         panic_if(maa_id == -1, "Invalidator cannot have maa_id!\n");
-        for (int i = 0; i < num_instructions_per_maa; i++) {
-            int instr_idx = (rand_base + i) % num_instructions_per_maa;
-            if (valids[maa_id][instr_idx] &&
-                instructions[maa_id][instr_idx].maa_id == maa_id &&
-                instructions[maa_id][instr_idx].state == Instruction::Status::Idle &&
-                (instructions[maa_id][instr_idx].src1SpdID == -1 || instructions[maa_id][instr_idx].src1Status == Instruction::TileStatus::Service || instructions[maa_id][instr_idx].src1Status == Instruction::TileStatus::Finished) &&
-                (instructions[maa_id][instr_idx].src2SpdID == -1 || instructions[maa_id][instr_idx].src2Status == Instruction::TileStatus::Service || instructions[maa_id][instr_idx].src2Status == Instruction::TileStatus::Finished) &&
-                (instructions[maa_id][instr_idx].condSpdID == -1 || instructions[maa_id][instr_idx].condStatus == Instruction::TileStatus::Service || instructions[maa_id][instr_idx].condStatus == Instruction::TileStatus::Finished) &&
-                (instructions[maa_id][instr_idx].dst1SpdID == -1 || instructions[maa_id][instr_idx].dst1Status == Instruction::TileStatus::WaitForService) &&
-                (instructions[maa_id][instr_idx].dst2SpdID == -1 || instructions[maa_id][instr_idx].dst2Status == Instruction::TileStatus::WaitForService) &&
-                instructions[maa_id][instr_idx].funcUniType == funcUniType) {
-                if (maa->num_maas == 1 || maa->getAddrRegionPermit(&instructions[maa_id][instr_idx])) {
-                    issueInstructionCompute(&instructions[maa_id][instr_idx]);
-                    DPRINTF(MAAController, "%s: returned instruction[%d] %s for execute!\n", __func__, instr_idx, instructions[maa_id][instr_idx].print());
-                    return &instructions[maa_id][instr_idx];
-                }
+        std::vector<int> &ready_queue = ready_queues[maa_id][(uint8_t)funcUniType];
+        int start = getReadyStart(maa_id, (uint8_t)funcUniType);
+        for (int i = 0; i < ready_queue.size(); i++) {
+            int instr_idx = ready_queue[(start + i) % ready_queue.size()];
+            assert(instructions[maa_id][instr_idx].funcUniType == funcUniType);
+            if (maa->num_maas == 1 || maa->getAddrRegionPermit(&instructions[maa_id][instr_idx])) {
+                last_issued[maa_id][(uint8_t)funcUniType] = instr_idx;
+                issueInstructionCompute(&instructions[maa_id][instr_idx]);
+                DPRINTF(MAAController, "%s: returned instruction[%d] %s for execute!\n", __func__, instr_idx, instructions[maa_id][instr_idx].print());
+                return &instructions[maa_id][instr_idx];
             }
         }
     }
@@ -303,35 +488,37 @@ Instruction *IF::getReady(FuncUnitType funcUniType, int maa_id) {
 void IF::finishInstructionCompute(Instruction *instruction) {
     instruction->state = Instruction::Status::Finish;
     int maa_id = instruction->maa_id;
-    valids[maa_id][instruction->if_id] = false;
-    if (instruction->dst1SpdID != -1) {
-        for (int i = 0; i < num_instructions_per_maa; i++) {
-            if (valids[maa_id][i]) {
-                if (instructions[maa_id][i].src1SpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].src1Status = Instruction::TileStatus::Finished;
-                }
-                if (instructions[maa_id][i].src2SpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].src2Status = Instruction::TileStatus::Finished;
-                }
-                if (instructions[maa_id][i].condSpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].condStatus = Instruction::TileStatus::Finished;
-                }
-            }
-        }
+    int instr_idx = instruction->if_id;
+    valids[maa_id][instr_idx] = false;
+    releaseDependencies(maa_id, instr_idx, -1);
+    for (int i = 0; i < num_instructions_per_maa; i++) {
+        dependencies[maa_id][i * num_instructions_per_maa + instr_idx] = false;
     }
-    if (instruction->dst2SpdID != -1) {
-        for (int i = 0; i < num_instructions_per_maa; i++) {
-            if (valids[maa_id][i]) {
-                if (instructions[maa_id][i].src1SpdID == instruction->dst2SpdID) {
+    num_dependents[maa_id][instr_idx] = 0;
+    updateReadyQueues(maa_id, instr_idx);
+    for (int i = 0; i < num_instructions_per_maa; i++) {
+        if (valids[maa_id][i]) {
+            bool changed = false;
+            for (int tile_id : {instruction->dst1SpdID, instruction->dst2SpdID}) {
+                if (tile_id == -1) {
+                    continue;
+                }
+                if (instructions[maa_id][i].src1SpdID == tile_id) {
                     instructions[maa_id][i].src1Status = Instruction::TileStatus::Finished;
+                    changed = true;
                 }
-                if (instructions[maa_id][i].src2SpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].src2SpdID == tile_id) {
                     instructions[maa_id][i].src2Status = Instruction::TileStatus::Finished;
+                    changed = true;
                 }
-                if (instructions[maa_id][i].condSpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].condSpdID == tile_id) {
                     instructions[maa_id][i].condStatus = Instruction::TileStatus::Finished;
+                    changed = true;
                 }
             }
+            if (changed) {
+                updateReadyQueues(maa_id, i);
+            }
         }
     }
 }
@@ -354,20 +541,34 @@ void IF::finishInstructionInvalidate(Instruction *instruction, int tile_id, uint
     int maa_id = instruction->maa_id;
     for (int i = 0; i < num_instructions_per_maa; i++) {
         if (valids[maa_id][i]) {
+            bool changed = false;
+            bool src_changed = false;
             if (instructions[maa_id][i].src1SpdID == tile_id && instructions[maa_id][i].src1Status == Instruction::TileStatus::Invalidating) {
                 instructions[maa_id][i].src1Status = new_tile_status;
+                src_changed = true;
             }
             if (instructions[maa_id][i].src2SpdID == tile_id && instructions[maa_id][i].src2Status == Instruction::TileStatus::Invalidating) {
                 instructions[maa_id][i].src2Status = new_tile_status;
+                src_changed = true;
             }
             if (instructions[maa_id][i].condSpdID == tile_id && instructions[maa_id][i].condStatus == Instruction::TileStatus::Invalidating) {
                 instructions[maa_id][i].condStatus = new_tile_status;
+                src_changed = true;
             }
             if (instructions[maa_id][i].dst1SpdID == tile_id && instructions[maa_id][i].dst1Status == Instruction::TileStatus::Invalidating) {
                 instructions[maa_id][i].dst1Status = new_tile_status;
+                changed = true;
             }
             if (instructions[maa_id][i].dst2SpdID == tile_id && instructions[maa_id][i].dst2Status == Instruction::TileStatus::Invalidating) {
                 instructions[maa_id][i].dst2Status = new_tile_status;
+                changed = true;
+            }
+            // A source tile found finished no longer waits on its writers
+            if (src_changed && new_tile_status == Instruction::TileStatus::Finished) {
+                releaseDependencies(maa_id, i, tile_id);
+            }
+            if (changed || src_changed || &instructions[maa_id][i] == instruction) {
+                updateReadyQueues(maa_id, i);
             }
         }
     }
@@ -375,68 +576,70 @@ void IF::finishInstructionInvalidate(Instruction *instruction, int tile_id, uint
 void IF::issueInstructionCompute(Instruction *instruction) {
     instruction->state = Instruction::Status::Service;
     int maa_id = instruction->maa_id;
-    if (instruction->dst1SpdID != -1) {
-        for (int i = 0; i < num_instructions_per_maa; i++) {
-            if (valids[maa_id][i]) {
-                if (instructions[maa_id][i].src1SpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].src1Status = Instruction::TileStatus::Service;
-                }
-                if (instructions[maa_id][i].src2SpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].src2Status = Instruction::TileStatus::Service;
-                }
-                if (instructions[maa_id][i].condSpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].condStatus = Instruction::TileStatus::Service;
-                }
-                if (instructions[maa_id][i].dst1SpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].dst1Status = Instruction::TileStatus::Service;
-                }
-                if (instructions[maa_id][i].dst2SpdID == instruction->dst1SpdID) {
-                    instructions[maa_id][i].dst2Status = Instruction::TileStatus::Service;
+    updateReadyQueues(maa_id, instruction->if_id);
+    for (int i = 0; i < num_instructions_per_maa; i++) {
+        if (valids[maa_id][i]) {
+            bool changed = false;
+            for (int tile_id : {instruction->dst1SpdID, instruction->dst2SpdID}) {
+                if (tile_id == -1) {
+                    continue;
                 }
-            }
-        }
-    }
-    if (instruction->dst2SpdID != -1) {
-        for (int i = 0; i < num_instructions_per_maa; i++) {
-            if (valids[maa_id][i]) {
-                if (instructions[maa_id][i].src1SpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].src1SpdID == tile_id) {
                     instructions[maa_id][i].src1Status = Instruction::TileStatus::Service;
+                    changed = true;
                 }
-                if (instructions[maa_id][i].src2SpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].src2SpdID == tile_id) {
                     instructions[maa_id][i].src2Status = Instruction::TileStatus::Service;
+                    changed = true;
                 }
-                if (instructions[maa_id][i].condSpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].condSpdID == tile_id) {
                     instructions[maa_id][i].condStatus = Instruction::TileStatus::Service;
+                    changed = true;
                 }
-                if (instructions[maa_id][i].dst1SpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].dst1SpdID == tile_id) {
                     instructions[maa_id][i].dst1Status = Instruction::TileStatus::Service;
+                    changed = true;
                 }
-                if (instructions[maa_id][i].dst2SpdID == instruction->dst2SpdID) {
+                if (instructions[maa_id][i].dst2SpdID == tile_id) {
                     instructions[maa_id][i].dst2Status = Instruction::TileStatus::Service;
+                    changed = true;
                 }
             }
+            if (changed) {
+                updateReadyQueues(maa_id, i);
+            }
         }
     }
 }
 void IF::issueInstructionInvalidate(Instruction *instruction, int tile_id) {
     instruction->state = Instruction::Status::Service;
     int maa_id = instruction->maa_id;
+    updateReadyQueues(maa_id, instruction->if_id);
     for (int i = 0; i < num_instructions_per_maa; i++) {
         if (valids[maa_id][i]) {
+            bool changed = false;
             if (instructions[maa_id][i].src1SpdID == tile_id && instructions[maa_id][i].src1Status == Instruction::TileStatus::WaitForInvalidation) {
                 instructions[maa_id][i].src1Status = Instruction::TileStatus::Invalidating;
+                changed = true;
             }
             if (instructions[maa_id][i].src2SpdID == tile_id && instructions[maa_id][i].src2Status == Instruction::TileStatus::WaitForInvalidation) {
                 instructions[maa_id][i].src2Status = Instruction::TileStatus::Invalidating;
+                changed = true;
             }
             if (instructions[maa_id][i].condSpdID == tile_id && instructions[maa_id][i].condStatus == Instruction::TileStatus::WaitForInvalidation) {
                 instructions[maa_id][i].condStatus = Instruction::TileStatus::Invalidating;
+                changed = true;
             }
             if (instructions[maa_id][i].dst1SpdID == tile_id && instructions[maa_id][i].dst1Status == Instruction::TileStatus::WaitForInvalidation) {
                 instructions[maa_id][i].dst1Status = Instruction::TileStatus::Invalidating;
+                changed = true;
             }
             if (instructions[maa_id][i].dst2SpdID == tile_id && instructions[maa_id][i].dst2Status == Instruction::TileStatus::WaitForInvalidation) {
                 instructions[maa_id][i].dst2Status = Instruction::TileStatus::Invalidating;
+                changed = true;
+            }
+            if (changed) {
+                updateReadyQueues(maa_id, i);
             }
         }
     }
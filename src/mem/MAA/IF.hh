@@ -5,8 +5,10 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "base/types.hh"
+#include "enums/MAAIssuePolicy.hh"
 #include "mem/MAA/SPD.hh"
 #include "sim/system.hh"
 #include "arch/generic/mmu.hh"
@@ -43,9 +45,19 @@ public:
         ALU_SCALAR = 8,
         ALU_VECTOR = 9,
         ALU_REDUCE = 10,
+        INDIR_LD_CHAINED = 11,
+        INDIR_PROBE = 12,
+        ALU_COMPACT = 13,
+        ALU_SCAN = 14,
+        ALU_SCAN_EXCL = 15,
+        ALU_HISTOGRAM = 16,
+        ALU_CVT = 17,
+        // Loop control, recorded by the MAA and never pushed to the instruction file
+        LOOP_BEGIN = 18,
+        LOOP_END = 19,
         MAX
     };
-    std::string opcode_names[11] = {
+    std::string opcode_names[20] = {
         "STREAM_LD",
         "STREAM_ST",
         "INDIR_LD",
@@ -56,7 +68,16 @@ public:
         "RANGE_LOOP",
         "ALU_SCALAR",
         "ALU_VECTOR",
-        "ALU_REDUCE"};
+        "ALU_REDUCE",
+        "INDIR_LD_CHAINED",
+        "INDIR_PROBE",
+        "ALU_COMPACT",
+        "ALU_SCAN",
+        "ALU_SCAN_EXCL",
+        "ALU_HISTOGRAM",
+        "ALU_CVT",
+        "LOOP_BEGIN",
+        "LOOP_END"};
     enum class OPType : uint8_t {
         ADD_OP = 0,
         SUB_OP = 1,
@@ -74,9 +95,12 @@ public:
         LT_OP = 13,
         LTE_OP = 14,
         EQ_OP = 15,
+        NE_OP = 16,
+        CAS_OP = 17,
+        ANDN_OP = 18,
         MAX
     };
-    std::string optype_names[16] = {
+    std::string optype_names[19] = {
         "ADD",
         "SUB",
         "MUL",
@@ -92,7 +116,10 @@ public:
         "GTE",
         "LT",
         "LTE",
-        "EQ"};
+        "EQ",
+        "NE",
+        "CAS",
+        "ANDN"};
     enum class DataType : uint8_t {
         UINT32_TYPE = 0,
         INT32_TYPE = 1,
@@ -100,6 +127,14 @@ public:
         UINT64_TYPE = 3,
         INT64_TYPE = 4,
         FLOAT64_TYPE = 5,
+        UINT8_TYPE = 6,
+        INT8_TYPE = 7,
+        UINT16_TYPE = 8,
+        INT16_TYPE = 9,
+        FLOAT16_TYPE = 10,
+        BFLOAT16_TYPE = 11,
+        // Packed bits, moved as bytes of 8 elements, tile sizes count bytes
+        BIT_TYPE = 12,
         MAX
     };
     enum class AccessType : uint8_t {
@@ -108,13 +143,20 @@ public:
         COMPUTE = 2,
         MAX
     };
-    std::string datatype_names[6] = {
+    std::string datatype_names[13] = {
         "UINT32",
         "INT32",
         "FLOAT32",
         "UINT64",
         "INT64",
-        "FLOAT64"};
+        "FLOAT64",
+        "UINT8",
+        "INT8",
+        "UINT16",
+        "INT16",
+        "FLOAT16",
+        "BFLOAT16",
+        "BIT"};
     enum class Status : uint8_t {
         Idle = 0,
         Service = 1,
@@ -144,6 +186,10 @@ public:
     Addr baseAddr;
     Addr minAddr, maxAddr;
     int8_t addrRangeID;
+    // Second-level array of INDIR_LD_CHAINED, indexed by the words loaded from baseAddr
+    Addr baseAddr2;
+    Addr minAddr2, maxAddr2;
+    int8_t addrRangeID2;
     int16_t src1RegID, src2RegID, src3RegID, dst1RegID, dst2RegID;
     int16_t src1SpdID, src2SpdID;
     TileStatus src1Status, src2Status;
@@ -151,11 +197,11 @@ public:
     TileStatus dst1Status, dst2Status;
     int16_t condSpdID;
     TileStatus condStatus;
-    // {STREAM_LD, INDIR_LD, INDIR_ST, INDIR_RMW, RANGE_LOOP, CONDITION}
+    // {STREAM_LD, INDIR_LD, INDIR_LD_CHAINED, INDIR_PROBE, INDIR_ST, INDIR_RMW, RANGE_LOOP, CONDITION}
     OpcodeType opcode;
     // {ADD, SUB, MUL, DIV, MIN, MAX, GT, GTE, LT, LTE, EQ}
     OPType optype;
-    // {Int, Float}
+    // {Int, Float}, the source type of ALU_CVT
     DataType datatype;
     // {Read, Write, Compute}
     AccessType accessType;
@@ -170,6 +216,9 @@ public:
     std::string print() const;
     int getWordSize(int tile_id);
     int WordSize();
+    // ALU_CVT carries its destination type in the optype field
+    DataType CvtDataType() const { return static_cast<DataType>(optype); }
+    static int DataTypeSize(DataType _datatype);
     int core_id;
     int maa_id;
 };
@@ -181,27 +230,89 @@ protected:
     unsigned int num_maas;
     bool **valids;
     MAA *maa;
+    enums::MAAIssuePolicy issue_policy;
+    // Push order of each instruction, oldest has the smallest
+    uint64_t **push_seqs;
+    uint64_t next_push_seq;
+    // Number of waiting instructions that read a destination tile of each instruction
+    int **num_dependents;
+    // dependencies[maa][j * num_instructions_per_maa + i]: instruction j waits on a tile instruction i writes
+    bool **dependencies;
+    // Ready instructions of each function unit type, sorted in the issue order
+    // An instruction is inserted or removed only when its own status or its tiles change
+    std::vector<int> **ready_queues;
+    // Last issued instruction of each function unit type, used by round-robin
+    int **last_issued;
+    int last_invalidated_maa;
     Instruction::TileStatus getTileStatus(int tile_id, uint8_t tile_status);
+    bool isReadyCompute(int maa_id, int instr_idx);
+    int getInvalidateTile(int maa_id, int instr_idx);
+    bool issueBefore(int maa_id, int instr_idx1, int instr_idx2);
+    void insertReady(int maa_id, uint8_t func_unit_type, int instr_idx);
+    void removeReady(int maa_id, uint8_t func_unit_type, int instr_idx);
+    int getReadyStart(int maa_id, uint8_t func_unit_type);
+    void updateReadyQueues(int maa_id, int instr_idx);
+    void reorderReadyQueues(int maa_id, int instr_idx);
+    void releaseDependencies(int maa_id, int instr_idx, int tile_id);
 
 public:
-    IF(unsigned int _num_instructions_per_maa, unsigned int _num_maas, MAA *_maa) : num_instructions_per_maa(_num_instructions_per_maa), num_maas(_num_maas), maa(_maa) {
+    IF(unsigned int _num_instructions_per_maa, unsigned int _num_maas, enums::MAAIssuePolicy _issue_policy, MAA *_maa)
+        : num_instructions_per_maa(_num_instructions_per_maa), num_maas(_num_maas), maa(_maa), issue_policy(_issue_policy) {
         instructions = new Instruction *[num_maas];
         valids = new bool *[num_maas];
+        push_seqs = new uint64_t *[num_maas];
+        num_dependents = new int *[num_maas];
+        dependencies = new bool *[num_maas];
+        ready_queues = new std::vector<int> *[num_maas];
+        last_issued = new int *[num_maas];
         for (int i = 0; i < num_maas; i++) {
             instructions[i] = new Instruction[num_instructions_per_maa];
             valids[i] = new bool[num_instructions_per_maa];
+            push_seqs[i] = new uint64_t[num_instructions_per_maa];
+            num_dependents[i] = new int[num_instructions_per_maa];
+            dependencies[i] = new bool[num_instructions_per_maa * num_instructions_per_maa];
+            for (int j = 0; j < num_instructions_per_maa * num_instructions_per_maa; j++) {
+                dependencies[i][j] = false;
+            }
             for (int j = 0; j < num_instructions_per_maa; j++) {
                 valids[i][j] = false;
+                push_seqs[i][j] = 0;
+                num_dependents[i][j] = 0;
+            }
+            ready_queues[i] = new std::vector<int>[(uint8_t)FuncUnitType::MAX];
+            last_issued[i] = new int[(uint8_t)FuncUnitType::MAX];
+            for (int j = 0; j < (uint8_t)FuncUnitType::MAX; j++) {
+                ready_queues[i][j].reserve(num_instructions_per_maa);
+                last_issued[i][j] = num_instructions_per_maa - 1;
             }
         }
+        next_push_seq = 0;
+        last_invalidated_maa = num_maas - 1;
     }
     ~IF() {
         assert(instructions != nullptr);
         assert(valids != nullptr);
+        assert(push_seqs != nullptr);
+        assert(num_dependents != nullptr);
+        assert(dependencies != nullptr);
+        assert(ready_queues != nullptr);
+        assert(last_issued != nullptr);
         for (int i = 0; i < num_maas; i++) {
             delete[] instructions[i];
             delete[] valids[i];
+            delete[] push_seqs[i];
+            delete[] num_dependents[i];
+            delete[] dependencies[i];
+            delete[] ready_queues[i];
+            delete[] last_issued[i];
         }
+        delete[] instructions;
+        delete[] valids;
+        delete[] push_seqs;
+        delete[] num_dependents;
+        delete[] dependencies;
+        delete[] ready_queues;
+        delete[] last_issued;
     }
     bool pushInstruction(Instruction _instruction);
     bool canPushRegister(Register _reg);
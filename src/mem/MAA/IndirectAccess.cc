@@ -4,6 +4,7 @@
 #include "mem/MAA/MAA.hh"
 #include "mem/MAA/SPD.hh"
 #include "mem/MAA/IF.hh"
+#include "mem/MAA/HalfFloat.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "debug/MAAIndirect.hh"
@@ -20,6 +21,219 @@
 
 namespace gem5 {
 
+///////////////
+//
+// INDIRECT ACCESS RECEIVE KERNELS
+//
+///////////////
+template <typename T>
+void recvLoadKernel(uint8_t *line, const int *wids, const uint8_t *operands, uint8_t *fetched, int num_words) {
+    const T *line_typed = (const T *)line;
+    T *fetched_typed = (T *)fetched;
+    for (int i = 0; i < num_words; i++) {
+        fetched_typed[i] = line_typed[wids[i]];
+    }
+}
+template <typename T, bool is_scalar>
+void recvStoreKernel(uint8_t *line, const int *wids, const uint8_t *operands, uint8_t *fetched, int num_words) {
+    T *line_typed = (T *)line;
+    const T *operands_typed = (const T *)operands;
+    T *fetched_typed = (T *)fetched;
+    for (int i = 0; i < num_words; i++) {
+        if (fetched != nullptr) {
+            fetched_typed[i] = line_typed[wids[i]];
+        }
+        line_typed[wids[i]] = operands_typed[is_scalar ? 0 : i];
+    }
+}
+template <typename T>
+void recvCASKernel(uint8_t *line, const int *wids, const uint8_t *operands, uint8_t *fetched, int num_words) {
+    // Operands are {expected, new} pairs. Words are compared bitwise, and
+    // entries are applied in order, so duplicate words see the earlier swaps
+    T *line_typed = (T *)line;
+    const T *operands_typed = (const T *)operands;
+    T *fetched_typed = (T *)fetched;
+    for (int i = 0; i < num_words; i++) {
+        T old_data = line_typed[wids[i]];
+        fetched_typed[i] = old_data;
+        if (old_data == operands_typed[2 * i]) {
+            line_typed[wids[i]] = operands_typed[2 * i + 1];
+        }
+    }
+}
+template <bool is_set>
+void recvBitKernel(uint8_t *line, const int *wids, const uint8_t *operands, uint8_t *fetched, int num_words) {
+    // Operands are the bit masks within the byte, bits sharing a byte see the
+    // earlier sets, so only the first setter of a bit fetches a zero
+    for (int i = 0; i < num_words; i++) {
+        if (fetched != nullptr) {
+            fetched[i] = (line[wids[i]] & operands[i]) != 0 ? 1 : 0;
+        }
+        if constexpr (is_set) {
+            line[wids[i]] |= operands[i];
+        }
+    }
+}
+IndirectAccessUnit::RecvKernel getRecvLoadKernel(int word_size) {
+    switch (word_size) {
+    case 1:
+        return &recvLoadKernel<uint8_t>;
+    case 2:
+        return &recvLoadKernel<uint16_t>;
+    case 4:
+        return &recvLoadKernel<uint32_t>;
+    default:
+        return &recvLoadKernel<uint64_t>;
+    }
+}
+template <bool is_scalar>
+IndirectAccessUnit::RecvKernel getRecvStoreKernel(int word_size) {
+    switch (word_size) {
+    case 1:
+        return &recvStoreKernel<uint8_t, is_scalar>;
+    case 2:
+        return &recvStoreKernel<uint16_t, is_scalar>;
+    case 4:
+        return &recvStoreKernel<uint32_t, is_scalar>;
+    default:
+        return &recvStoreKernel<uint64_t, is_scalar>;
+    }
+}
+IndirectAccessUnit::RecvKernel getRecvCASKernel(int word_size) {
+    switch (word_size) {
+    case 1:
+        return &recvCASKernel<uint8_t>;
+    case 2:
+        return &recvCASKernel<uint16_t>;
+    case 4:
+        return &recvCASKernel<uint32_t>;
+    default:
+        return &recvCASKernel<uint64_t>;
+    }
+}
+template <typename T, Instruction::OPType optype, bool is_scalar>
+void recvRMWKernel(uint8_t *line, const int *wids, const uint8_t *operands, uint8_t *fetched, int num_words) {
+    T *line_typed = (T *)line;
+    const T *operands_typed = (const T *)operands;
+    T *fetched_typed = (T *)fetched;
+    // Entries are applied in order, so duplicate words see the earlier updates
+    for (int i = 0; i < num_words; i++) {
+        T old_data = line_typed[wids[i]];
+        T word_data = operands_typed[is_scalar ? 0 : i];
+        if (fetched != nullptr) {
+            fetched_typed[i] = old_data;
+        }
+        if constexpr (optype == Instruction::OPType::ADD_OP) {
+            line_typed[wids[i]] = old_data + word_data;
+        } else if constexpr (optype == Instruction::OPType::MIN_OP) {
+            line_typed[wids[i]] = old_data < word_data ? old_data : word_data;
+        } else {
+            static_assert(optype == Instruction::OPType::MAX_OP, "Unsupported RMW optype!");
+            line_typed[wids[i]] = old_data > word_data ? old_data : word_data;
+        }
+    }
+}
+template <typename T, bool is_scalar>
+IndirectAccessUnit::RecvKernel getRecvRMWKernel(Instruction::OPType optype) {
+    switch (optype) {
+    case Instruction::OPType::ADD_OP:
+        return &recvRMWKernel<T, Instruction::OPType::ADD_OP, is_scalar>;
+    case Instruction::OPType::MIN_OP:
+        return &recvRMWKernel<T, Instruction::OPType::MIN_OP, is_scalar>;
+    case Instruction::OPType::MAX_OP:
+        return &recvRMWKernel<T, Instruction::OPType::MAX_OP, is_scalar>;
+    default:
+        return nullptr;
+    }
+}
+template <typename T, Instruction::OPType optype>
+void combineRMWKernel(uint8_t *acc, const uint8_t *operand) {
+    T *acc_typed = (T *)acc;
+    T word_data = *((const T *)operand);
+    if constexpr (optype == Instruction::OPType::ADD_OP) {
+        *acc_typed = *acc_typed + word_data;
+    } else if constexpr (optype == Instruction::OPType::MIN_OP) {
+        *acc_typed = *acc_typed < word_data ? *acc_typed : word_data;
+    } else {
+        static_assert(optype == Instruction::OPType::MAX_OP, "Unsupported RMW optype!");
+        *acc_typed = *acc_typed > word_data ? *acc_typed : word_data;
+    }
+}
+template <typename T>
+IndirectAccessUnit::CombineKernel getCombineRMWKernel(Instruction::OPType optype) {
+    switch (optype) {
+    case Instruction::OPType::ADD_OP:
+        return &combineRMWKernel<T, Instruction::OPType::ADD_OP>;
+    case Instruction::OPType::MIN_OP:
+        return &combineRMWKernel<T, Instruction::OPType::MIN_OP>;
+    case Instruction::OPType::MAX_OP:
+        return &combineRMWKernel<T, Instruction::OPType::MAX_OP>;
+    default:
+        return nullptr;
+    }
+}
+IndirectAccessUnit::CombineKernel getCombineRMWKernel(Instruction::DataType datatype, Instruction::OPType optype) {
+    switch (datatype) {
+    case Instruction::DataType::UINT32_TYPE:
+        return getCombineRMWKernel<uint32_t>(optype);
+    case Instruction::DataType::INT32_TYPE:
+        return getCombineRMWKernel<int32_t>(optype);
+    case Instruction::DataType::FLOAT32_TYPE:
+        return getCombineRMWKernel<float>(optype);
+    case Instruction::DataType::UINT64_TYPE:
+        return getCombineRMWKernel<uint64_t>(optype);
+    case Instruction::DataType::INT64_TYPE:
+        return getCombineRMWKernel<int64_t>(optype);
+    case Instruction::DataType::FLOAT64_TYPE:
+        return getCombineRMWKernel<double>(optype);
+    case Instruction::DataType::UINT8_TYPE:
+        return getCombineRMWKernel<uint8_t>(optype);
+    case Instruction::DataType::INT8_TYPE:
+        return getCombineRMWKernel<int8_t>(optype);
+    case Instruction::DataType::UINT16_TYPE:
+        return getCombineRMWKernel<uint16_t>(optype);
+    case Instruction::DataType::INT16_TYPE:
+        return getCombineRMWKernel<int16_t>(optype);
+    case Instruction::DataType::FLOAT16_TYPE:
+        return getCombineRMWKernel<float16_t>(optype);
+    case Instruction::DataType::BFLOAT16_TYPE:
+        return getCombineRMWKernel<bfloat16_t>(optype);
+    default:
+        return nullptr;
+    }
+}
+template <bool is_scalar>
+IndirectAccessUnit::RecvKernel getRecvRMWKernel(Instruction::DataType datatype, Instruction::OPType optype) {
+    switch (datatype) {
+    case Instruction::DataType::UINT32_TYPE:
+        return getRecvRMWKernel<uint32_t, is_scalar>(optype);
+    case Instruction::DataType::INT32_TYPE:
+        return getRecvRMWKernel<int32_t, is_scalar>(optype);
+    case Instruction::DataType::FLOAT32_TYPE:
+        return getRecvRMWKernel<float, is_scalar>(optype);
+    case Instruction::DataType::UINT64_TYPE:
+        return getRecvRMWKernel<uint64_t, is_scalar>(optype);
+    case Instruction::DataType::INT64_TYPE:
+        return getRecvRMWKernel<int64_t, is_scalar>(optype);
+    case Instruction::DataType::FLOAT64_TYPE:
+        return getRecvRMWKernel<double, is_scalar>(optype);
+    case Instruction::DataType::UINT8_TYPE:
+        return getRecvRMWKernel<uint8_t, is_scalar>(optype);
+    case Instruction::DataType::INT8_TYPE:
+        return getRecvRMWKernel<int8_t, is_scalar>(optype);
+    case Instruction::DataType::UINT16_TYPE:
+        return getRecvRMWKernel<uint16_t, is_scalar>(optype);
+    case Instruction::DataType::INT16_TYPE:
+        return getRecvRMWKernel<int16_t, is_scalar>(optype);
+    case Instruction::DataType::FLOAT16_TYPE:
+        return getRecvRMWKernel<float16_t, is_scalar>(optype);
+    case Instruction::DataType::BFLOAT16_TYPE:
+        return getRecvRMWKernel<bfloat16_t, is_scalar>(optype);
+    default:
+        return nullptr;
+    }
+}
+
 ///////////////
 //
 // INDIRECT ACCESS UNIT
@@ -41,6 +255,18 @@ IndirectAccessUnit::IndirectAccessUnit()
     my_RT_req_sent = nullptr;
     my_RT_slice_order = nullptr;
     my_instruction = nullptr;
+    my_recv_kernel = nullptr;
+    my_recv_itrs = nullptr;
+    my_recv_wids = nullptr;
+    my_recv_operands = nullptr;
+    my_recv_fetched = nullptr;
+    my_second_level = nullptr;
+    my_chained_idxs = nullptr;
+    my_combined = nullptr;
+    my_combined_operands = nullptr;
+    my_bitmap_pending = nullptr;
+    my_window_bank_ROWs = nullptr;
+    my_window_slice_ROWs = nullptr;
 }
 IndirectAccessUnit::~IndirectAccessUnit() {
     assert(RT_slice_org != nullptr);
@@ -81,6 +307,28 @@ IndirectAccessUnit::~IndirectAccessUnit() {
     delete[] my_RT_req_sent;
     assert(my_RT_slice_order != nullptr);
     delete[] my_RT_slice_order;
+    assert(my_recv_itrs != nullptr);
+    delete[] my_recv_itrs;
+    assert(my_recv_wids != nullptr);
+    delete[] my_recv_wids;
+    assert(my_recv_operands != nullptr);
+    delete[] my_recv_operands;
+    assert(my_recv_fetched != nullptr);
+    delete[] my_recv_fetched;
+    assert(my_second_level != nullptr);
+    delete[] my_second_level;
+    assert(my_chained_idxs != nullptr);
+    delete[] my_chained_idxs;
+    assert(my_combined != nullptr);
+    delete[] my_combined;
+    assert(my_combined_operands != nullptr);
+    delete[] my_combined_operands;
+    assert(my_bitmap_pending != nullptr);
+    delete[] my_bitmap_pending;
+    assert(my_window_bank_ROWs != nullptr);
+    delete[] my_window_bank_ROWs;
+    assert(my_window_slice_ROWs != nullptr);
+    delete[] my_window_slice_ROWs;
 }
 void IndirectAccessUnit::allocate(int _my_indirect_id,
                                   int _num_tile_elements,
@@ -89,6 +337,7 @@ void IndirectAccessUnit::allocate(int _my_indirect_id,
                                   int _num_row_table_config_cache_entries,
                                   bool _reconfigure_row_table,
                                   bool _reorder_row_table,
+                                  bool _combine_rmw,
                                   int _num_initial_row_table_slice,
                                   Cycles _rowtable_latency,
                                   int _num_channels,
@@ -96,12 +345,14 @@ void IndirectAccessUnit::allocate(int _my_indirect_id,
                                   MAA *_maa) {
     my_indirect_id = _my_indirect_id;
     maa = _maa;
+    my_TLB.allocate(maa->num_tlb_entries, maa->tlb_associativity, maa->tlb_page_size, maa->tlb_hit_latency, maa->tlb_page_table_size, FuncUnitType::INDIRECT, my_indirect_id, maa);
     num_tile_elements = _num_tile_elements;
     num_RT_rows_per_slice = _num_row_table_rows_per_slice;
     num_RT_entries_per_subslice_row = _num_row_table_entries_per_subslice_row;
     num_RT_config_cache_entries = _num_row_table_config_cache_entries;
     reconfigure_RT = _reconfigure_row_table;
     reorder_RT = _reorder_row_table;
+    combine_RMW = _combine_rmw;
     num_initial_RT_slices = _num_initial_row_table_slice;
     rowtable_latency = _rowtable_latency;
     num_channels = _num_channels;
@@ -112,6 +363,36 @@ void IndirectAccessUnit::allocate(int _my_indirect_id,
     dst_tile_id = -1;
     offset_table = new OffsetTable();
     offset_table->allocate(my_indirect_id, num_tile_elements, maa, false);
+    // Each element has at most one request in flight, but a chained load
+    // inserts two addresses per element
+    LoadsCacheHitRespondingTimeHistory.allocate(num_tile_elements);
+    LoadsCacheHitAccessingTimeHistory.allocate(num_tile_elements);
+    LoadsMemAccessingTimeHistory.allocate(num_tile_elements);
+    my_unique_WORD_addrs.allocate(num_tile_elements * 2);
+    my_unique_CL_addrs.allocate(num_tile_elements * 2);
+    my_unique_ROW_addrs.allocate(num_tile_elements * 2);
+    // A received line can match every element of the tile
+    my_recv_itrs = new int[num_tile_elements];
+    my_recv_wids = new int[num_tile_elements];
+    // Compare-and-swaps have two operands per element
+    my_recv_operands = new uint8_t[num_tile_elements * 2 * sizeof(uint64_t)];
+    my_recv_fetched = new uint8_t[num_tile_elements * sizeof(uint64_t)];
+    my_second_level = new bool[num_tile_elements];
+    my_chained_idxs = new uint32_t[num_tile_elements];
+    for (int i = 0; i < num_tile_elements; i++) {
+        my_second_level[i] = false;
+    }
+    my_chained_pending.reserve(num_tile_elements);
+    my_combine_leaders.allocate(num_tile_elements);
+    my_combined = new bool[num_tile_elements];
+    my_combined_operands = new uint8_t[num_tile_elements * sizeof(uint64_t)];
+    for (int i = 0; i < num_tile_elements; i++) {
+        my_combined[i] = false;
+    }
+    my_bitmap_pending = new uint8_t[getCeiling(num_tile_elements, 8)];
+    std::memset(my_bitmap_pending, 0, getCeiling(num_tile_elements, 8));
+    my_chained_pending_head = 0;
+    my_num_chained_outstanding = 0;
 
     // Row Table initialization
     int min_num_RT_slices = maa->m_org[ADDR_CHANNEL_LEVEL] * maa->m_org[ADDR_RANK_LEVEL] * 2;
@@ -212,6 +493,11 @@ void IndirectAccessUnit::allocate(int _my_indirect_id,
     if (reconfigure_RT)
         initial_RT_config = num_RT_configs - 1;
     DPRINTF(MAAIndirect, "I[%d] %s: initial_RT_config(%d)!\n", my_indirect_id, __func__, initial_RT_config);
+
+    // One sample per DRAM bank, the configuration with the most slices has a slice per bank
+    my_window_ROW_addrs.allocate(num_tile_elements * 2);
+    my_window_bank_ROWs = new int[total_num_RT_subslices];
+    my_window_slice_ROWs = new int[total_num_RT_subslices];
 }
 int IndirectAccessUnit::getRowTableIdx(int RT_config, int channel, int rank, int bankgroup, int bank) {
     int RT_index = 0;
@@ -227,6 +513,9 @@ int IndirectAccessUnit::getRowTableIdx(int RT_config, int channel, int rank, int
              my_indirect_id, RT_config, __func__, RT_index, num_RT_slices[RT_config]);
     return RT_index;
 }
+int IndirectAccessUnit::getDramBankIdx(int channel, int rank, int bankgroup, int bank) {
+    return ((channel * maa->m_org[ADDR_RANK_LEVEL] + rank) * maa->m_org[ADDR_BANKGROUP_LEVEL] + bankgroup) * maa->m_org[ADDR_BANK_LEVEL] + bank;
+}
 Addr IndirectAccessUnit::getGrowAddr(int RT_config, int bankgroup, int bank, int row) {
     Addr grow_addr = 0;
     grow_addr = (bankgroup / RT_slice_org[RT_config][ADDR_BANKGROUP_LEVEL]);
@@ -266,52 +555,23 @@ void IndirectAccessUnit::setRowTableConfig(Addr addr, int num_CLs, int num_ROWs)
     if (reconfigure_RT == false)
         return;
 
-    // This approach selects the configuration with as many ROWs as needed
     int new_config = -1;
-    if (num_ROWs >= num_RT_rows_total[num_RT_configs - 1]) {
-        new_config = num_RT_configs - 1;
-    } else {
-        for (int i = 0; i < num_RT_configs; i++) {
-            if (num_ROWs < num_RT_rows_total[i]) {
-                new_config = i;
-                break;
-            }
-        }
-    }
-
-#if 0
-    // This approach selects the configuration with as many ROWs as needed
-    int new_config = -1;
-    if (num_ROWs >= num_RT_rows_total[num_RT_configs - 1]) {
-        new_config = num_RT_configs - 1;
-    } else {
-        for (int i = 0; i < num_RT_configs - 1; i++) {
-            if (num_ROWs < ((num_RT_rows_total[i] + num_RT_rows_total[i + 1]) / 2)) {
-                new_config = i;
-                break;
+    if (maa->row_table_policy == enums::History) {
+        // This approach selects the configuration with as many ROWs as needed
+        if (num_ROWs >= num_RT_rows_total[num_RT_configs - 1]) {
+            new_config = num_RT_configs - 1;
+        } else {
+            for (int i = 0; i < num_RT_configs; i++) {
+                if (num_ROWs < num_RT_rows_total[i]) {
+                    new_config = i;
+                    break;
+                }
             }
         }
-    }
-#endif
-
-#if 0
-    // This approach does not work. If D is too large, there will be many unique CLs
-    // and many unique ROWs. The CL/ROW is still large, but since num_ROWs >> number
-    // of RT banks x RT subslices x rows/subslice, there will be a lot of drains.
-    int num_CLs_per_ROW = num_CLs / num_ROWs;
-    if (num_CLs_per_ROW >= num_RT_slice_columns[0]) {
-        new_config = 0;
-    } else if (num_CLs_per_ROW < num_RT_slice_columns[num_RT_configs - 1]) {
-        new_config = num_RT_configs - 1;
     } else {
-        for (int i = 1; i < num_RT_configs; i++) {
-            if (num_CLs_per_ROW < num_RT_slice_columns[i - 1] &&
-                num_CLs_per_ROW >= num_RT_slice_columns[i]) {
-                new_config = i;
-            }
-        }
+        // The adaptive policies start the next instance where this one ended
+        new_config = my_RT_config;
     }
-#endif
 
     assert(new_config != -1);
     for (int i = 0; i < num_RT_config_cache_entries; i++) {
@@ -321,12 +581,116 @@ void IndirectAccessUnit::setRowTableConfig(Addr addr, int num_CLs, int num_ROWs)
                     my_indirect_id, __func__, addr, new_config,
                     num_CLs, num_RT_slice_columns[new_config] * num_RT_slices[new_config] * num_RT_rows_per_slice,
                     num_ROWs, num_RT_rows_total[new_config],
-                    num_CLs / num_ROWs, num_RT_slice_columns[new_config]);
+                    num_ROWs == 0 ? 0 : num_CLs / num_ROWs, num_RT_slice_columns[new_config]);
             return;
         }
     }
     panic_if(true, "I[%d] %s: addr(0x%lx) not found in the cache!\n", my_indirect_id, __func__, addr);
 }
+double IndirectAccessUnit::getRowTableLoad(int RT_config) {
+    // How many times the fullest slice of RT_config fills up with the
+    // sampled window, a DRAM row with more CLs than the slice columns takes
+    // several rows of the slice. Selecting configurations only by CLs/ROW
+    // does not work, as too many rows in a bank drain the row table anyway.
+    int CLs_per_ROW = getCeiling(my_window_CLs, my_window_ROW_addrs.size);
+    int RT_rows_per_ROW = getCeiling(CLs_per_ROW, num_RT_slice_columns[RT_config]);
+    std::fill(my_window_slice_ROWs, my_window_slice_ROWs + num_RT_slices[RT_config], 0);
+    int max_slice_ROWs = 0;
+    for (int channel = 0; channel < maa->m_org[ADDR_CHANNEL_LEVEL]; channel++) {
+        for (int rank = 0; rank < maa->m_org[ADDR_RANK_LEVEL]; rank++) {
+            for (int bankgroup = 0; bankgroup < maa->m_org[ADDR_BANKGROUP_LEVEL]; bankgroup++) {
+                for (int bank = 0; bank < maa->m_org[ADDR_BANK_LEVEL]; bank++) {
+                    int RT_idx = getRowTableIdx(RT_config, channel, rank, bankgroup, bank);
+                    my_window_slice_ROWs[RT_idx] += my_window_bank_ROWs[getDramBankIdx(channel, rank, bankgroup, bank)] * RT_rows_per_ROW;
+                    max_slice_ROWs = std::max(max_slice_ROWs, my_window_slice_ROWs[RT_idx]);
+                }
+            }
+        }
+    }
+    return (double)max_slice_ROWs / num_RT_rows_per_slice;
+}
+void IndirectAccessUnit::adaptRowTableConfig() {
+    // Called at a drain, where all sent requests are received. The geometry can
+    // only change once the row table is empty, so after a switch is decided,
+    // fill stops inserting until the rows left are sent and received.
+    if (reconfigure_RT == false) {
+        return;
+    }
+    if (my_RT_next_config == -1) {
+        if (my_window_ROW_addrs.size == 0) {
+            return;
+        }
+        int new_config = my_RT_config;
+        switch (maa->row_table_policy) {
+        case enums::History: {
+            break;
+        }
+        case enums::CLDensity: {
+            // The configuration with the fewest predicted drains, the current one on ties
+            double min_load = getRowTableLoad(my_RT_config);
+            for (int i = 0; i < num_RT_configs; i++) {
+                double load = getRowTableLoad(i);
+                if (load < min_load) {
+                    min_load = load;
+                    new_config = i;
+                }
+            }
+            break;
+        }
+        case enums::HillClimb: {
+            // Keep moving while the elements filled per cycle improve, turn back otherwise
+            Cycles window_cycles = maa->getTicksToCycles(curTick() - my_window_start_tick);
+            double throughput = (double)(my_i - my_window_start_i) / std::max((uint64_t)window_cycles, (uint64_t)1);
+            if (throughput < my_RT_climb_throughput) {
+                my_RT_climb_dir = -my_RT_climb_dir;
+            }
+            my_RT_climb_throughput = throughput;
+            if (my_RT_config + my_RT_climb_dir < 0 || my_RT_config + my_RT_climb_dir >= num_RT_configs) {
+                my_RT_climb_dir = -my_RT_climb_dir;
+            }
+            new_config = std::min(std::max(my_RT_config + my_RT_climb_dir, 0), num_RT_configs - 1);
+            break;
+        }
+        default:
+            panic("I[%d] %s: invalid row table policy %d!\n", my_indirect_id, __func__, (int)maa->row_table_policy);
+        }
+        if (new_config == my_RT_config) {
+            resetRowTableWindow();
+            return;
+        }
+        if (maa->row_table_policy == enums::CLDensity) {
+            // Only the CLDensity switches are predicted by the row table load
+            double drains_avoided = getRowTableLoad(my_RT_config) - getRowTableLoad(new_config);
+            (*maa->stats.IND_NumRTDrainsAvoided[my_indirect_id]) += drains_avoided;
+        }
+        DPRINTF(MAATrace, "I[%d] %s: config(%d) switching to config(%d) with %d CLs, %d ROWs!\n",
+                my_indirect_id, __func__, my_RT_config, new_config, my_window_CLs, my_window_ROW_addrs.size);
+        my_RT_next_config = new_config;
+    }
+    for (int i = 0; i < num_RT_slices[my_RT_config]; i++) {
+        if (RT[my_RT_config][i].num_valid_rows != 0) {
+            DPRINTF(MAAIndirect, "I[%d] %s: config(%d) T[%d] has %d rows left to drain!\n", my_indirect_id, __func__, my_RT_config, i, RT[my_RT_config][i].num_valid_rows);
+            return;
+        }
+    }
+    DPRINTF(MAATrace, "I[%d] %s: config(%d) switched to config(%d)!\n", my_indirect_id, __func__, my_RT_config, my_RT_next_config);
+    (*maa->stats.IND_NumRTReconfigs[my_indirect_id])++;
+    my_RT_config = my_RT_next_config;
+    my_RT_next_config = -1;
+    my_RT_idx = -1;
+    for (int i = 0; i < num_RT_slices[my_RT_config]; i++) {
+        RT[my_RT_config][i].reset();
+        my_RT_req_sent[my_RT_config][i] = false;
+    }
+    resetRowTableWindow();
+}
+void IndirectAccessUnit::resetRowTableWindow() {
+    my_window_ROW_addrs.reset();
+    std::fill(my_window_bank_ROWs, my_window_bank_ROWs + total_num_RT_subslices, 0);
+    my_window_CLs = 0;
+    my_window_start_i = my_i;
+    my_window_start_tick = curTick();
+}
 void IndirectAccessUnit::check_reset() {
     for (int i = 0; i < num_RT_configs; i++) {
         for (int j = 0; j < num_RT_slices[i]; j++) {
@@ -380,10 +744,11 @@ Cycles IndirectAccessUnit::updateLatency(int num_spd_read_data_accesses, int num
         (*maa->stats.IND_CyclesRTAccess[my_indirect_id]) += write_access_rowtable_latency;
     }
     Tick finish_tick = std::max(std::max(std::max(my_SPD_read_finish_tick, my_SPD_write_finish_tick), my_RT_read_access_finish_tick), my_RT_write_access_finish_tick);
+    finish_tick = std::max(finish_tick, my_translation_finish_tick);
     return maa->getTicksToCycles(finish_tick - curTick());
 }
 bool IndirectAccessUnit::scheduleNextExecution(bool force) {
-    Tick finish_tick = my_RT_write_access_finish_tick;
+    Tick finish_tick = std::max(my_RT_write_access_finish_tick, my_translation_finish_tick);
     if (state == Status::Response) {
         finish_tick = std::max(std::max(std::max(my_SPD_read_finish_tick, my_SPD_write_finish_tick), my_RT_read_access_finish_tick), my_RT_write_access_finish_tick);
     }
@@ -417,14 +782,30 @@ void IndirectAccessUnit::checkTileReady() {
         }
         panic_if(maa->spd->getSize(my_idx_tile) != my_max, "I[%d] %s: idx size (%d) != max (%d)!\n", my_indirect_id, __func__, maa->spd->getSize(my_idx_tile), my_max);
     }
-    if (my_instruction->opcode != Instruction::OpcodeType::INDIR_LD && my_instruction->opcode != Instruction::OpcodeType::INDIR_ST_SCALAR && my_instruction->opcode != Instruction::OpcodeType::INDIR_RMW_SCALAR && maa->spd->getTileStatus(my_src_tile) == SPD::TileStatus::Finished) {
+    if (my_instruction->opcode != Instruction::OpcodeType::INDIR_LD && my_instruction->opcode != Instruction::OpcodeType::INDIR_LD_CHAINED && my_instruction->opcode != Instruction::OpcodeType::INDIR_PROBE && my_instruction->opcode != Instruction::OpcodeType::INDIR_ST_SCALAR && my_instruction->opcode != Instruction::OpcodeType::INDIR_RMW_SCALAR && maa->spd->getTileStatus(my_src_tile) == SPD::TileStatus::Finished) {
         my_src_tile_ready = true;
     }
 }
 bool IndirectAccessUnit::checkElementReady() {
+    if (my_i < my_ready_end) {
+        return true;
+    }
+    // Finding the run of ready elements starting from my_i
+    my_ready_end = my_max == -1 ? num_tile_elements : my_max;
+    if (my_cond_tile != -1) {
+        my_ready_end = maa->spd->getFirstUnfinished(my_cond_tile, my_i, my_ready_end, 4);
+    }
+    my_ready_end = maa->spd->getFirstUnfinished(my_idx_tile, my_i, my_ready_end, 4);
+    if (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_VECTOR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_VECTOR) {
+        my_ready_end = maa->spd->getFirstUnfinished(my_src_tile, my_i, my_ready_end, my_word_size);
+    }
+    if (my_i < my_ready_end) {
+        return true;
+    }
+    // Registering for the callback of the first tile that is not ready
     bool cond_ready = my_cond_tile == -1 || maa->spd->getElementFinished(my_cond_tile, my_i, 4, (uint8_t)FuncUnitType::INDIRECT, my_indirect_id);
     bool idx_ready = cond_ready && maa->spd->getElementFinished(my_idx_tile, my_i, 4, (uint8_t)FuncUnitType::INDIRECT, my_indirect_id);
-    bool src_ready = idx_ready && (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR || my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR || maa->spd->getElementFinished(my_src_tile, my_i, my_word_size, (uint8_t)FuncUnitType::INDIRECT, my_indirect_id));
+    bool src_ready = idx_ready && (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD || my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED || my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR || my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR || maa->spd->getElementFinished(my_src_tile, my_i, my_word_size, (uint8_t)FuncUnitType::INDIRECT, my_indirect_id));
     if (cond_ready == false) {
         DPRINTF(MAAIndirect, "I[%d] %s: cond tile[%d] element[%d] not ready, returning!\n", my_indirect_id, __func__, my_cond_tile, my_i);
     } else if (idx_ready == false) {
@@ -457,6 +838,100 @@ bool IndirectAccessUnit::checkReadyForFinish() {
     }
     return true;
 }
+bool IndirectAccessUnit::insertRowTable(Addr vaddr, int word_size, int itr, bool second_level, int &num_rowtable_accesses) {
+    Addr block_vaddr = addrBlockAligner(vaddr, block_size);
+    Addr paddr = translatePacket(block_vaddr);
+    Addr block_paddr = addrBlockAligner(paddr, block_size);
+    uint16_t wid = (vaddr - block_vaddr) / word_size;
+    DramCoord addr_vec = maa->map_addr(block_paddr);
+    int RT_idx = getRowTableIdx(my_RT_config, addr_vec[ADDR_CHANNEL_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL]);
+    Addr grow_addr = getGrowAddr(my_RT_config, addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL], addr_vec[ADDR_ROW_LEVEL]);
+    DPRINTF(MAAIndirect, "I[%d] %s: inserting vaddr(0x%lx), paddr(0x%lx), MAP(RO: %d, BA: %d, BG: %d, RA: %d, CO: %d, CH: %d), grow(0x%lx), itr(%d), wid(%d) to T[%d]\n", my_indirect_id, __func__, block_vaddr, block_paddr, addr_vec[ADDR_ROW_LEVEL], addr_vec[ADDR_BANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_COLUMN_LEVEL], addr_vec[ADDR_CHANNEL_LEVEL], grow_addr, itr, wid, RT_idx);
+    bool first_CL_access;
+    bool inserted = RT[my_RT_config][RT_idx].insert(grow_addr, block_paddr, itr, wid, first_CL_access);
+    num_rowtable_accesses++;
+    if (inserted == false) {
+        (*maa->stats.IND_NumRTFull[my_indirect_id])++;
+        my_RT_idx = RT_idx;
+        return false;
+    }
+    // The unique and window counters size the row table and pick direct cache accesses for the
+    // indexed array, the second-level accesses of a chained load target another array
+    if (second_level == false) {
+        // DRAM rows are counted independently of the row table configuration
+        int bank_idx = getDramBankIdx(addr_vec[ADDR_CHANNEL_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL]);
+        Addr row_addr = (Addr)bank_idx * maa->m_org[ADDR_ROW_LEVEL] + addr_vec[ADDR_ROW_LEVEL];
+        my_unique_WORD_addrs.insert(vaddr);
+        my_unique_CL_addrs.insert(block_paddr);
+        my_unique_ROW_addrs.insert(row_addr);
+        if (first_CL_access) {
+            my_window_CLs++;
+        }
+        if (my_window_ROW_addrs.insert(row_addr)) {
+            my_window_bank_ROWs[bank_idx]++;
+        }
+    }
+    if (reorder_RT == false && first_CL_access == true) {
+        DPRINTF(MAAIndirect, "I[%d] %s: Creating packet for bank[%d], addr[0x%lx]!\n", my_indirect_id, __func__, RT_idx, block_paddr);
+        my_expected_responses++;
+        int latency = getCeiling(num_rowtable_accesses, total_num_RT_subslices) * rowtable_latency;
+        if (my_translation_ready_tick > curTick()) {
+            // The request cannot leave before its translation is ready
+            latency = std::max(latency, (int)maa->getTicksToCycles(my_translation_ready_tick - curTick()));
+        }
+        createReadPacket(block_paddr, latency);
+    }
+    return true;
+}
+bool IndirectAccessUnit::checkTranslation(Addr vaddr, bool &waited) {
+    if (my_TLB.isEnabled() == false) {
+        return true;
+    }
+    // A lookup of a page that is already being walked counts as a hit, and the
+    // replay of a blocked lookup after its walk is not counted again
+    Tick ready_tick;
+    TranslationBuffer::Lookup result = my_TLB.lookup(vaddr, ready_tick);
+    if (result == TranslationBuffer::Lookup::Hit) {
+        if (waited == false) {
+            (*maa->stats.IND_TLBHits[my_indirect_id])++;
+        }
+        waited = false;
+        my_translation_ready_tick = ready_tick;
+        my_translation_finish_tick = std::max(my_translation_finish_tick, my_translation_ready_tick);
+        return true;
+    }
+    if (waited == false) {
+        if (result == TranslationBuffer::Lookup::Miss) {
+            (*maa->stats.IND_TLBMisses[my_indirect_id])++;
+        } else {
+            (*maa->stats.IND_TLBHits[my_indirect_id])++;
+        }
+    }
+    DPRINTF(MAAIndirect, "I[%d] %s: vaddr(0x%lx) waits for its page walk!\n", my_indirect_id, __func__, vaddr);
+    waited = true;
+    return false;
+}
+bool IndirectAccessUnit::insertChainedPending(int &num_rowtable_accesses, bool &waitForTranslation) {
+    waitForTranslation = false;
+    // Second-level accesses of the chained load, in the order their indices arrived
+    for (; my_chained_pending_head < my_chained_pending.size(); my_chained_pending_head++) {
+        int itr = my_chained_pending[my_chained_pending_head];
+        uint32_t idx = my_chained_idxs[itr];
+        Addr vaddr = my_base_addr2 + my_word_size * idx;
+        panic_if(vaddr < my_min_addr2 || vaddr >= my_max_addr2, "I[%d] %s: vaddr 0x%lx out of range [0x%lx, 0x%lx)!\n", my_indirect_id, __func__, vaddr, my_min_addr2, my_max_addr2);
+        DPRINTF(MAAIndirect, "I[%d] %s: baseaddr2 = 0x%lx idx = %u wordsize = %d vaddr = 0x%lx!\n", my_indirect_id, __func__, my_base_addr2, idx, my_word_size, vaddr);
+        if (checkTranslation(vaddr, my_chained_translation_waited) == false) {
+            waitForTranslation = true;
+            return false;
+        }
+        if (insertRowTable(vaddr, my_word_size, itr, true, num_rowtable_accesses) == false) {
+            return false;
+        }
+    }
+    my_chained_pending.clear();
+    my_chained_pending_head = 0;
+    return true;
+}
 void IndirectAccessUnit::fillRowTable(bool &finished, bool &waitForFinish, bool &waitForElement, bool &needDrain, int &num_spd_read_condidx_accesses, int &num_rowtable_accesses) {
     finished = false;
     waitForFinish = false;
@@ -465,11 +940,39 @@ void IndirectAccessUnit::fillRowTable(bool &finished, bool &waitForFinish, bool
     num_spd_read_condidx_accesses = 0;
     num_rowtable_accesses = 0;
     checkTileReady();
+    if (my_RT_next_config != -1) {
+        // The row table drains before switching its configuration
+        needDrain = true;
+        return;
+    }
+    bool waitForTranslation;
+    if (insertChainedPending(num_rowtable_accesses, waitForTranslation) == false) {
+        if (waitForTranslation) {
+            waitForElement = true;
+        } else {
+            needDrain = true;
+        }
+        return;
+    }
     while (true) {
         if (my_max != -1 && my_i >= my_max) {
             if (my_dst_tile != -1) {
                 panic_if(my_max != -1 && my_i != my_max, "I[%d] %s: my_i(%d) != my_max(%d)!\n", my_indirect_id, __func__, my_i, my_max);
-                maa->spd->setSize(my_dst_tile, my_i);
+                // Bitmap tile sizes count bytes
+                maa->spd->setSize(my_dst_tile, my_is_bitmap ? getCeiling(my_i, 8) : my_i);
+                if (my_is_bitmap && my_bitmap_tail_cleared == false) {
+                    // Clearing the tail of the last byte, which has no elements
+                    for (int i = my_max; i < getCeiling(my_max, 8) * 8; i++) {
+                        maa->spd->setBit(my_dst_tile, i, false);
+                    }
+                    my_bitmap_tail_cleared = true;
+                    if (my_max % 8 != 0) {
+                        finishBitmapByte(my_max >> 3);
+                    }
+                }
+            }
+            if (my_match_tile != -1) {
+                maa->spd->setSize(my_match_tile, my_i);
             }
             if (checkReadyForFinish()) {
                 finished = true;
@@ -491,40 +994,58 @@ void IndirectAccessUnit::fillRowTable(bool &finished, bool &waitForFinish, bool
         if (my_cond_tile == -1 || maa->spd->getData<uint32_t>(my_cond_tile, my_i) != 0) {
             uint32_t idx = maa->spd->getData<uint32_t>(my_idx_tile, my_i);
             num_spd_read_condidx_accesses++;
-            Addr vaddr = my_base_addr + my_word_size * idx;
+            // The first level of a chained load reads the 4-byte indices array
+            int word_size = my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ? 4 : my_word_size;
+            Addr vaddr = my_is_bitmap ? my_base_addr + (idx >> 3) : my_base_addr + word_size * idx;
+            if (my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
+                // The key is hashed to its head bucket as (key & mask) >> skip
+                vaddr = my_base_addr + ((idx & my_probe_mask) >> my_probe_skip) * my_probe_stride;
+                panic_if(addrBlockAligner(vaddr, block_size) != addrBlockAligner(vaddr + 16 + 8 * my_probe_tuples - 1, block_size),
+                         "I[%d] %s: bucket at vaddr 0x%lx crosses a cache line!\n", my_indirect_id, __func__, vaddr);
+            }
             panic_if(vaddr < my_min_addr || vaddr >= my_max_addr, "I[%d] %s: vaddr 0x%lx out of range [0x%lx, 0x%lx)!\n", my_indirect_id, __func__, vaddr, my_min_addr, my_max_addr);
-            Addr block_vaddr = addrBlockAligner(vaddr, block_size);
-            DPRINTF(MAAIndirect, "I[%d] %s: baseaddr = 0x%lx idx = %u wordsize = %d vaddr = 0x%lx!\n", my_indirect_id, __func__, my_base_addr, idx, my_word_size, vaddr);
-            Addr paddr = translatePacket(block_vaddr);
-            Addr block_paddr = addrBlockAligner(paddr, block_size);
-            DPRINTF(MAAIndirect, "I[%d] %s: idx = %u, addr = 0x%lx!\n", my_indirect_id, __func__, idx, block_paddr);
-            uint16_t wid = (vaddr - block_vaddr) / my_word_size;
-            std::vector<int> addr_vec = maa->map_addr(block_paddr);
-            my_RT_idx = getRowTableIdx(my_RT_config, addr_vec[ADDR_CHANNEL_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL]);
-            Addr grow_addr = getGrowAddr(my_RT_config, addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL], addr_vec[ADDR_ROW_LEVEL]);
-            DPRINTF(MAAIndirect, "I[%d] %s: inserting vaddr(0x%lx), paddr(0x%lx), MAP(RO: %d, BA: %d, BG: %d, RA: %d, CO: %d, CH: %d), grow(0x%lx), itr(%d), idx(%d), wid(%d) to T[%d]\n", my_indirect_id, __func__, block_vaddr, block_paddr, addr_vec[ADDR_ROW_LEVEL], addr_vec[ADDR_BANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_COLUMN_LEVEL], addr_vec[ADDR_CHANNEL_LEVEL], grow_addr, my_i, idx, wid, my_RT_idx);
-            bool first_CL_access;
-            bool inserted = RT[my_RT_config][my_RT_idx].insert(grow_addr, block_paddr, my_i, wid, first_CL_access);
-            num_rowtable_accesses++;
-            if (inserted == false) {
+            DPRINTF(MAAIndirect, "I[%d] %s: baseaddr = 0x%lx idx = %u wordsize = %d vaddr = 0x%lx!\n", my_indirect_id, __func__, my_base_addr, idx, word_size, vaddr);
+            int leader_itr;
+            if (my_combine_RMW && my_combine_leaders.find(vaddr, leader_itr)) {
+                // The word already has a pending update, this one is folded into it
+                combineRMW(leader_itr, my_i);
+                if (my_src_tile != -1) {
+                    num_spd_read_condidx_accesses++;
+                }
+                num_rowtable_accesses++;
+            } else if (checkTranslation(vaddr, my_fill_translation_waited) == false) {
+                waitForElement = true;
+                break;
+            } else if (insertRowTable(vaddr, word_size, my_i, false, num_rowtable_accesses) == false) {
                 needDrain = true;
-                (*maa->stats.IND_NumRTFull[my_indirect_id])++;
                 break;
-            } else {
-                my_unique_WORD_addrs.insert(vaddr);
-                my_unique_CL_addrs.insert(block_paddr);
-                my_unique_ROW_addrs.insert(grow_addr + my_RT_idx * num_RT_possible_grows[my_RT_config]);
-                if (reorder_RT == false && first_CL_access == true) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: Creating packet for bank[%d], addr[0x%lx]!\n", my_indirect_id, __func__, my_RT_idx, block_paddr);
-                    my_expected_responses++;
-                    createReadPacket(block_paddr, getCeiling(num_rowtable_accesses, total_num_RT_subslices) * rowtable_latency);
-                }
+            } else if (my_combine_RMW) {
+                my_combine_leaders.insert(vaddr, my_i);
+            } else if (my_is_bitmap && my_dst_tile != -1) {
+                my_bitmap_pending[my_i >> 3]++;
+            }
+        } else {
+            if (my_dst_tile != -1 && my_is_bitmap) {
+                maa->spd->setBit(my_dst_tile, my_i, false);
+            } else if (my_dst_tile != -1) {
+                DPRINTF(MAAIndirect, "I[%d] %s: SPD[%d][%d] = %u (cond not taken)\n", my_indirect_id, __func__, my_dst_tile, my_i, 0);
+                maa->spd->setFakeData(my_dst_tile, my_i, my_word_size);
+            }
+            if (my_match_tile != -1) {
+                maa->spd->setData<uint32_t>(my_match_tile, my_i, 0);
             }
-        } else if (my_dst_tile != -1) {
-            DPRINTF(MAAIndirect, "I[%d] %s: SPD[%d][%d] = %u (cond not taken)\n", my_indirect_id, __func__, my_dst_tile, my_i, 0);
-            maa->spd->setFakeData(my_dst_tile, my_i, my_word_size);
         }
         my_i++;
+        if (my_is_bitmap && my_dst_tile != -1 && my_i % 8 == 0) {
+            finishBitmapByte((my_i >> 3) - 1);
+        }
+    }
+}
+void IndirectAccessUnit::finishBitmapByte(int byte_id) {
+    // Consumers of the destination can start on a byte as soon as all of its bits are written
+    bool walked = (byte_id + 1) * 8 <= my_i || my_bitmap_tail_cleared;
+    if (walked && my_bitmap_pending[byte_id] == 0) {
+        maa->spd->setElementsFinished(my_dst_tile, byte_id, byte_id + 1, 1);
     }
 }
 void IndirectAccessUnit::executeInstruction() {
@@ -541,6 +1062,7 @@ void IndirectAccessUnit::executeInstruction() {
         DPRINTF(MAAIndirect, "I[%d] %s: decoding %s!\n", my_indirect_id, __func__, my_instruction->print());
 
         // Decoding the instruction
+        my_translation_memo.reset();
         my_base_addr = my_instruction->baseAddr;
         my_idx_tile = my_instruction->src1SpdID;
         my_src_tile = my_instruction->src2SpdID;
@@ -548,6 +1070,8 @@ void IndirectAccessUnit::executeInstruction() {
         my_dst_tile = my_instruction->dst1SpdID;
         my_cond_tile = my_instruction->condSpdID;
         if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE ||
             my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_VECTOR ||
             my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR) {
             my_is_load = true;
@@ -557,7 +1081,9 @@ void IndirectAccessUnit::executeInstruction() {
         } else {
             assert(false);
         }
-        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD) {
+        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
             my_word_size = my_instruction->getWordSize(my_dst_tile);
         } else if (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_VECTOR ||
                    my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_VECTOR) {
@@ -569,9 +1095,26 @@ void IndirectAccessUnit::executeInstruction() {
             assert(false);
         }
         my_words_per_cl = 64 / my_word_size;
+        my_is_bitmap = my_instruction->datatype == Instruction::DataType::BIT_TYPE;
+        panic_if(my_is_bitmap && my_instruction->opcode != Instruction::OpcodeType::INDIR_LD &&
+                     (my_instruction->opcode != Instruction::OpcodeType::INDIR_RMW_SCALAR || my_instruction->optype != Instruction::OPType::OR_OP),
+                 "I[%d] %s: bitmaps support only test and test-and-set, %s!\n", my_indirect_id, __func__, my_instruction->print());
+        // Combined updates do not return their own old values, bitmaps are coalesced per line by the row table
+        my_combine_RMW = combine_RMW && my_dst_tile == -1 && my_is_bitmap == false &&
+                         (my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_VECTOR ||
+                          my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR);
+        my_combine_leaders.reset();
+        if (my_is_bitmap && my_dst_tile != -1) {
+            std::memset(my_bitmap_pending, 0, getCeiling(num_tile_elements, 8));
+        }
+        my_bitmap_tail_cleared = false;
+        my_is_CAS = my_instruction->optype == Instruction::OPType::CAS_OP;
+        setRecvKernel();
         maa->stats.numInst++;
         (*maa->stats.IND_NumInsts[my_indirect_id])++;
-        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD) {
+        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
             maa->stats.numInst_INDRD++;
         } else if (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR ||
                    my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_VECTOR) {
@@ -584,7 +1127,7 @@ void IndirectAccessUnit::executeInstruction() {
         }
         my_cond_tile_ready = (my_cond_tile == -1) ? true : false;
         my_idx_tile_ready = false;
-        my_src_tile_ready = (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD || my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR) ? true : false;
+        my_src_tile_ready = (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD || my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED || my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE || my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR) ? true : false;
         my_RT_config = getRowTableConfig(my_base_addr);
 
         // Initialization
@@ -596,11 +1139,21 @@ void IndirectAccessUnit::executeInstruction() {
             my_RT_req_sent[my_RT_config][i] = false;
         }
         my_i = 0;
+        my_RT_idx = -1;
+        my_ready_end = 0;
         my_max = -1;
+        resetRowTableWindow();
+        my_RT_climb_dir = -1;
+        my_RT_climb_throughput = -1;
+        my_RT_next_config = -1;
         my_SPD_read_finish_tick = curTick();
         my_SPD_write_finish_tick = curTick();
         my_RT_read_access_finish_tick = curTick();
         my_RT_write_access_finish_tick = curTick();
+        my_translation_ready_tick = curTick();
+        my_translation_finish_tick = curTick();
+        my_fill_translation_waited = false;
+        my_chained_translation_waited = false;
         my_decode_start_tick = curTick();
         my_fill_start_tick = 0;
         my_build_start_tick = 0;
@@ -611,6 +1164,34 @@ void IndirectAccessUnit::executeInstruction() {
         my_min_addr = my_instruction->minAddr;
         my_max_addr = my_instruction->maxAddr;
         my_addr_range_id = my_instruction->addrRangeID;
+        my_base_addr2 = my_instruction->baseAddr2;
+        my_min_addr2 = my_instruction->minAddr2;
+        my_max_addr2 = my_instruction->maxAddr2;
+        my_chained_pending.clear();
+        my_chained_pending_head = 0;
+        my_num_chained_outstanding = 0;
+        my_match_tile = -1;
+        if (my_is_CAS) {
+            // The destination tile holds the expected values and gets the old ones. Cores write tiles
+            // only through the non-cacheable range, so the expected values are already in the SPD, and
+            // the destination invalidation drops the cores' stale copies before the old values land.
+            // The target lines are read with ReadExReq under the WRITE region permit, which keeps
+            // other MAAs out of the region until the whole CAS instruction finishes.
+            panic_if(my_dst_tile == -1, "I[%d] %s: CAS without the expected value tile, %s!\n", my_indirect_id, __func__, my_instruction->print());
+            panic_if(my_instruction->accessType != Instruction::AccessType::WRITE, "I[%d] %s: CAS needs the WRITE region permit, %s!\n", my_indirect_id, __func__, my_instruction->print());
+            my_match_tile = my_instruction->dst2SpdID;
+        }
+        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
+            // Buckets are {latch, count, tuples[num_tuples] = {key, payload}, next}, 4-byte keys and payloads
+            panic_if(my_word_size != 4, "I[%d] %s: probe supports only 4-byte keys, %s!\n", my_indirect_id, __func__, my_instruction->print());
+            my_match_tile = my_instruction->dst2SpdID;
+            my_probe_mask = maa->rf->getData<uint32_t>(my_instruction->src1RegID);
+            my_probe_skip = maa->rf->getData<uint32_t>(my_instruction->src2RegID);
+            uint32_t layout = maa->rf->getData<uint32_t>(my_instruction->src3RegID);
+            my_probe_stride = layout & 0xFFFF;
+            my_probe_tuples = layout >> 16;
+            DPRINTF(MAAIndirect, "I[%d] %s: probe mask(0x%x) skip(%u) stride(%d) tuples(%d)!\n", my_indirect_id, __func__, my_probe_mask, my_probe_skip, my_probe_stride, my_probe_tuples);
+        }
 
         // Setting the state of the instruction and stream unit
         my_instruction->state = Instruction::Status::Service;
@@ -684,7 +1265,7 @@ void IndirectAccessUnit::executeInstruction() {
         Addr addr;
         if (my_force_cache_determined == false) {
             my_force_cache_determined = true;
-            if (my_unique_WORD_addrs.size() > my_words_per_cl * my_unique_CL_addrs.size()) {
+            if (my_unique_WORD_addrs.size > my_words_per_cl * my_unique_CL_addrs.size) {
                 DPRINTF(MAAIndirect, "I[%d] %s: Direct cache access is needed!\n", my_indirect_id, __func__);
                 my_force_cache = true;
             } else {
@@ -744,17 +1325,20 @@ void IndirectAccessUnit::executeInstruction() {
                 DPRINTF(MAAIndirect, "I[%d] %s: requesting is still not ready, returning!\n", my_indirect_id, __func__);
                 break;
             }
-            if (my_fill_finished) {
+            if (my_fill_finished && my_num_chained_outstanding == 0) {
                 state = Status::Response;
                 my_fill_finished = false;
             } else {
+                // Second-level accesses of a chained load may still wait for the row table
+                my_fill_finished = false;
                 state = Status::Fill;
+                adaptRowTableConfig();
             }
             DPRINTF(MAAIndirect, "I[%d] %s: all responses received, calling execution again in state %s!\n", my_indirect_id, __func__, status_names[(int)state]);
             scheduleNextExecution(true);
             break;
         }
-        if (my_fill_finished == false) {
+        if (my_fill_finished == false || my_chained_pending_head < my_chained_pending.size()) {
             bool finished, waitForFinish, waitForElement, needDrain;
             int num_spd_read_condidx_accesses, num_rowtable_accesses;
             fillRowTable(finished, waitForFinish, waitForElement, needDrain, num_spd_read_condidx_accesses, num_rowtable_accesses);
@@ -772,22 +1356,27 @@ void IndirectAccessUnit::executeInstruction() {
         panic_if(my_cond_tile_ready == false, "I[%d] %s: cond tile[%d] is not ready!\n", my_indirect_id, __func__, my_cond_tile);
         panic_if(my_idx_tile_ready == false, "I[%d] %s: idx tile[%d] is not ready!\n", my_indirect_id, __func__, my_idx_tile);
         panic_if(my_src_tile_ready == false, "I[%d] %s: src tile[%d] is not ready!\n", my_indirect_id, __func__, my_src_tile);
-        panic_if(LoadsCacheHitRespondingTimeHistory.size() != 0, "I[%d] %s: LoadsCacheHitRespondingTimeHistory is not empty!\n", my_indirect_id, __func__);
-        panic_if(LoadsCacheHitAccessingTimeHistory.size() != 0, "I[%d] %s: LoadsCacheHitAccessingTimeHistory is not empty!\n", my_indirect_id, __func__);
-        panic_if(LoadsMemAccessingTimeHistory.size() != 0, "I[%d] %s: LoadsMemAccessingTimeHistory is not empty!\n", my_indirect_id, __func__);
+        panic_if(my_num_chained_outstanding != 0, "I[%d] %s: %d chained elements are outstanding!\n", my_indirect_id, __func__, my_num_chained_outstanding);
+        panic_if(LoadsCacheHitRespondingTimeHistory.size != 0, "I[%d] %s: LoadsCacheHitRespondingTimeHistory is not empty!\n", my_indirect_id, __func__);
+        panic_if(LoadsCacheHitAccessingTimeHistory.size != 0, "I[%d] %s: LoadsCacheHitAccessingTimeHistory is not empty!\n", my_indirect_id, __func__);
+        panic_if(LoadsMemAccessingTimeHistory.size != 0, "I[%d] %s: LoadsMemAccessingTimeHistory is not empty!\n", my_indirect_id, __func__);
         DPRINTF(MAAIndirect, "I[%d] %s: state set to finish for request %s!\n", my_indirect_id, __func__, my_instruction->print());
         my_instruction->state = Instruction::Status::Finish;
         if (my_request_start_tick != 0) {
             (*maa->stats.IND_CyclesRequest[my_indirect_id]) += maa->getTicksToCycles(curTick() - my_request_start_tick);
             my_request_start_tick = 0;
         }
+        panic_if(my_is_bitmap && my_dst_tile != -1 && maa->spd->getFirstUnfinished(my_dst_tile, 0, getCeiling(my_max, 8), 1) != getCeiling(my_max, 8),
+                 "I[%d] %s: bitmap tile[%d] has unfinished bytes!\n", my_indirect_id, __func__, my_dst_tile);
         Cycles total_cycles = maa->getTicksToCycles(curTick() - my_decode_start_tick);
         maa->stats.cycles += total_cycles;
         my_decode_start_tick = 0;
         state = Status::Idle;
         check_reset();
         maa->finishInstructionCompute(my_instruction);
-        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD) {
+        if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ||
+            my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
             maa->stats.cycles_INDRD += total_cycles;
         } else if (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR ||
                    my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_VECTOR) {
@@ -795,13 +1384,16 @@ void IndirectAccessUnit::executeInstruction() {
         } else {
             maa->stats.cycles_INDRMW += total_cycles;
         }
-        setRowTableConfig(my_base_addr, my_unique_CL_addrs.size(), my_unique_ROW_addrs.size());
-        (*maa->stats.IND_NumUniqueWordsInserted[my_indirect_id]) += my_unique_WORD_addrs.size();
-        (*maa->stats.IND_NumUniqueCacheLineInserted[my_indirect_id]) += my_unique_CL_addrs.size();
-        (*maa->stats.IND_NumUniqueRowsInserted[my_indirect_id]) += my_unique_ROW_addrs.size();
-        my_unique_WORD_addrs.clear();
-        my_unique_CL_addrs.clear();
-        my_unique_ROW_addrs.clear();
+        setRowTableConfig(my_base_addr, my_unique_CL_addrs.size, my_unique_ROW_addrs.size);
+        (*maa->stats.IND_NumUniqueWordsInserted[my_indirect_id]) += my_unique_WORD_addrs.size;
+        (*maa->stats.IND_NumUniqueCacheLineInserted[my_indirect_id]) += my_unique_CL_addrs.size;
+        (*maa->stats.IND_NumUniqueRowsInserted[my_indirect_id]) += my_unique_ROW_addrs.size;
+        my_unique_WORD_addrs.reset();
+        my_unique_CL_addrs.reset();
+        my_unique_ROW_addrs.reset();
+        LoadsCacheHitRespondingTimeHistory.reset();
+        LoadsCacheHitAccessingTimeHistory.reset();
+        LoadsMemAccessingTimeHistory.reset();
         my_instruction = nullptr;
         break;
     }
@@ -825,7 +1417,9 @@ void IndirectAccessUnit::createReadPacket(Addr addr, int latency) {
     RequestPtr real_req = std::make_shared<Request>(addr, block_size, flags, maa->requestorId);
     real_req->setRegion(my_addr_range_id);
     PacketPtr read_pkt;
-    if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD) {
+    if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD ||
+        my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED ||
+        my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
         read_pkt = new Packet(real_req, MemCmd::ReadReq);
     } else {
         read_pkt = new Packet(real_req, MemCmd::ReadExReq);
@@ -838,7 +1432,7 @@ void IndirectAccessUnit::createReadPacket(Addr addr, int latency) {
 void IndirectAccessUnit::memReadPacketSent(Addr addr) {
     DPRINTF(MAAIndirect, "I[%d] %s: mem read packet 0x%lx sent\n", my_indirect_id, __func__, addr);
     (*maa->stats.IND_LoadsMemAccessing[my_indirect_id])++;
-    LoadsMemAccessingTimeHistory[addr] = curTick();
+    LoadsMemAccessingTimeHistory.insert(addr, curTick());
 }
 void IndirectAccessUnit::memWritePacketSent(Addr addr) {
     DPRINTF(MAAIndirect, "I[%d] %s: mem write packet 0x%lx sent\n", my_indirect_id, __func__, addr);
@@ -851,8 +1445,12 @@ void IndirectAccessUnit::memWritePacketSent(Addr addr) {
     }
 }
 void IndirectAccessUnit::cacheReadPacketSent(Addr addr) {
+    if (my_TLB.isWalkAddr(addr)) {
+        DPRINTF(MAAIndirect, "I[%d] %s: page walk read packet 0x%lx sent\n", my_indirect_id, __func__, addr);
+        return;
+    }
     DPRINTF(MAAIndirect, "I[%d] %s: cache read packet 0x%lx sent\n", my_indirect_id, __func__, addr);
-    LoadsCacheHitAccessingTimeHistory[addr] = curTick();
+    LoadsCacheHitAccessingTimeHistory.insert(addr, curTick());
     (*maa->stats.IND_LoadsCacheHitAccessing[my_indirect_id])++;
 }
 void IndirectAccessUnit::cacheWritePacketSent(Addr addr) {
@@ -866,282 +1464,215 @@ void IndirectAccessUnit::cacheWritePacketSent(Addr addr) {
     }
 }
 bool IndirectAccessUnit::recvData(const Addr addr, uint8_t *dataptr, bool is_block_cached) {
-    std::vector addr_vec = maa->map_addr(addr);
+    bool walk_finished;
+    Cycles walk_cycles;
+    if (my_TLB.recvData(addr, walk_finished, walk_cycles)) {
+        if (walk_finished) {
+            DPRINTF(MAAIndirect, "I[%d] %s: page walk finished in %lu cycles, calling execution again in state %s!\n", my_indirect_id, __func__, (uint64_t)walk_cycles, status_names[(int)state]);
+            (*maa->stats.IND_CyclesTLBWalk[my_indirect_id]) += walk_cycles;
+            scheduleNextExecution(true);
+        }
+        return true;
+    }
+    DramCoord addr_vec = maa->map_addr(addr);
     int RT_idx = getRowTableIdx(my_RT_config, addr_vec[ADDR_CHANNEL_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL]);
     Addr grow_addr = getGrowAddr(my_RT_config, addr_vec[ADDR_BANKGROUP_LEVEL], addr_vec[ADDR_BANK_LEVEL], addr_vec[ADDR_ROW_LEVEL]);
-    bool was_full = false;
-    if (RT_idx == my_RT_idx)
-        was_full = RT[my_RT_config][RT_idx].is_full();
-    std::vector<OffsetTableEntry> entries = RT[my_RT_config][RT_idx].get_entry_recv(grow_addr, addr, reorder_RT);
-    bool is_full = false;
-    if (RT_idx == my_RT_idx)
-        is_full = RT[my_RT_config][RT_idx].is_full();
-    DPRINTF(MAAIndirect, "I[%d] %s: %d entries received for addr(0x%lx), grow(x%lx) from T[%d]!\n", my_indirect_id, __func__, entries.size(), addr, grow_addr, RT_idx);
-    if (entries.size() == 0) {
+    // Only the slice the unit waits on can wake it up. The chained re-insertion below
+    // may move my_RT_idx, so the slice and its fullness are captured here
+    bool was_full = RT_idx == my_RT_idx && RT[my_RT_config][RT_idx].is_full();
+    int first_itr = RT[my_RT_config][RT_idx].get_entry_recv(grow_addr, addr, reorder_RT);
+    DPRINTF(MAAIndirect, "I[%d] %s: first itr (%d) received for addr(0x%lx), grow(x%lx) from T[%d]!\n", my_indirect_id, __func__, first_itr, addr, grow_addr, RT_idx);
+    if (first_itr == -1) {
         return false;
     }
+    Tick sent_tick;
     if (is_block_cached) {
-        if (LoadsCacheHitRespondingTimeHistory.find(addr) != LoadsCacheHitRespondingTimeHistory.end()) {
-            (*maa->stats.IND_LoadsCacheHitRespondingLatency[my_indirect_id]) += maa->getTicksToCycles(curTick() - LoadsCacheHitRespondingTimeHistory[addr]);
+        if (LoadsCacheHitRespondingTimeHistory.find(addr, sent_tick)) {
+            (*maa->stats.IND_LoadsCacheHitRespondingLatency[my_indirect_id]) += maa->getTicksToCycles(curTick() - sent_tick);
             LoadsCacheHitRespondingTimeHistory.erase(addr);
-        } else if (LoadsCacheHitAccessingTimeHistory.find(addr) != LoadsCacheHitAccessingTimeHistory.end()) {
-            (*maa->stats.IND_LoadsCacheHitAccessingLatency[my_indirect_id]) += maa->getTicksToCycles(curTick() - LoadsCacheHitAccessingTimeHistory[addr]);
+        } else if (LoadsCacheHitAccessingTimeHistory.find(addr, sent_tick)) {
+            (*maa->stats.IND_LoadsCacheHitAccessingLatency[my_indirect_id]) += maa->getTicksToCycles(curTick() - sent_tick);
             LoadsCacheHitAccessingTimeHistory.erase(addr);
         } else {
             panic("I[%d] %s: addr(0x%lx) is not in the cache hit history!\n", my_indirect_id, __func__, addr);
         }
     } else {
-        panic_if(LoadsMemAccessingTimeHistory.find(addr) == LoadsMemAccessingTimeHistory.end(), "I[%d] %s: addr(0x%lx) is not in the memory accessing history!\n", my_indirect_id, __func__, addr);
-        (*maa->stats.IND_LoadsMemAccessingLatency[my_indirect_id]) += maa->getTicksToCycles(curTick() - LoadsMemAccessingTimeHistory[addr]);
+        panic_if(LoadsMemAccessingTimeHistory.find(addr, sent_tick) == false, "I[%d] %s: addr(0x%lx) is not in the memory accessing history!\n", my_indirect_id, __func__, addr);
+        (*maa->stats.IND_LoadsMemAccessingLatency[my_indirect_id]) += maa->getTicksToCycles(curTick() - sent_tick);
         LoadsMemAccessingTimeHistory.erase(addr);
     }
     uint8_t new_data[block_size];
-    uint32_t *dataptr_u32_typed = (uint32_t *)new_data;
-    uint64_t *dataptr_u64_typed = (uint64_t *)new_data;
     std::memcpy(new_data, dataptr, block_size);
     int num_recv_spd_read_accesses = 0;
     int num_recv_spd_write_accesses = 0;
-    int num_recv_rt_accesses = entries.size();
-    for (auto entry : entries) {
-        int itr = entry.itr;
-        int wid = entry.wid;
-        DPRINTF(MAAIndirect, "I[%d] %s: itr (%d) wid (%d) matched!\n", my_indirect_id, __func__, itr, wid);
-        if (my_dst_tile != -1) {
-            if (my_word_size == 4) {
-                maa->spd->setData<uint32_t>(my_dst_tile, itr, dataptr_u32_typed[wid]);
-                DPRINTF(MAAIndirect, "I[%d] %s: SPD[%d][%d] = %u/%d/%f!\n", my_indirect_id, __func__, my_dst_tile, itr, ((uint32_t *)new_data)[wid], ((int32_t *)new_data)[wid], ((float *)new_data)[wid]);
-            } else {
-                maa->spd->setData<uint64_t>(my_dst_tile, itr, dataptr_u64_typed[wid]);
-                DPRINTF(MAAIndirect, "I[%d] %s: SPD[%d][%d] = %lu/%ld/%lf!\n", my_indirect_id, __func__, my_dst_tile, itr, ((uint64_t *)new_data)[wid], ((int64_t *)new_data)[wid], ((double *)new_data)[wid]);
-            }
-            num_recv_spd_write_accesses++;
-        }
-        switch (my_instruction->opcode) {
-        case Instruction::OpcodeType::INDIR_LD: {
-            assert(my_dst_tile != -1);
-            break;
-        }
-        case Instruction::OpcodeType::INDIR_ST_VECTOR: {
-            if (my_word_size == 4) {
-                ((uint32_t *)new_data)[wid] = maa->spd->getData<uint32_t>(my_src_tile, itr);
-                DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] = SPD[%d][%d] = %u/%d/%f!\n", my_indirect_id, __func__, wid, my_src_tile, itr, ((uint32_t *)new_data)[wid], ((int32_t *)new_data)[wid], ((float *)new_data)[wid]);
-            } else {
-                ((uint64_t *)new_data)[wid] = maa->spd->getData<uint64_t>(my_src_tile, itr);
-                DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] = SPD[%d][%d] = %lu/%ld/%lf!\n", my_indirect_id, __func__, wid, my_src_tile, itr, ((uint64_t *)new_data)[wid], ((int64_t *)new_data)[wid], ((double *)new_data)[wid]);
-            }
-            num_recv_spd_read_accesses++;
-            break;
-        }
-        case Instruction::OpcodeType::INDIR_ST_SCALAR: {
-            if (my_word_size == 4) {
-                ((uint32_t *)new_data)[wid] = maa->rf->getData<uint32_t>(my_src_reg);
+    int num_recv_rt_accesses = 0;
+    int num_recv_rt_write_accesses = 0;
+    int num_words = 0;
+    // Walking the offset table chain in place, it is sorted by itr
+    for (int itr = first_itr; itr != -1; num_words++) {
+        my_recv_itrs[num_words] = itr;
+        itr = offset_table->get_entry_recv(itr, my_recv_wids[num_words]);
+        num_recv_rt_accesses++;
+    }
+    DPRINTF(MAAIndirect, "I[%d] %s: %d itrs matched, first itr (%d) wid (%d)!\n", my_indirect_id, __func__, num_words, my_recv_itrs[0], my_recv_wids[0]);
+
+    if (my_instruction->opcode == Instruction::OpcodeType::INDIR_LD_CHAINED) {
+        // First-level words are indices into the second array and are inserted
+        // back into the row table, second-level words go to the destination tile
+        for (int i = 0; i < num_words; i++) {
+            int itr = my_recv_itrs[i];
+            if (my_second_level[itr] == false) {
+                my_chained_idxs[itr] = ((uint32_t *)new_data)[my_recv_wids[i]];
+                my_second_level[itr] = true;
+                my_chained_pending.push_back(itr);
+                my_num_chained_outstanding++;
             } else {
-                ((uint64_t *)new_data)[wid] = maa->rf->getData<uint64_t>(my_src_reg);
+                maa->spd->setWord(my_dst_tile, itr, my_word_size, new_data + my_recv_wids[i] * my_word_size);
+                my_second_level[itr] = false;
+                my_num_chained_outstanding--;
+                num_recv_spd_write_accesses++;
             }
-            break;
         }
-        case Instruction::OpcodeType::INDIR_RMW_VECTOR: {
-            switch (my_instruction->datatype) {
-            case Instruction::DataType::UINT32_TYPE: {
-                uint32_t word_data = maa->spd->getData<uint32_t>(my_src_tile, itr);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%u) += SPD[%d][%d] (%u) = %u!\n",
-                            my_indirect_id, __func__, wid, ((uint32_t *)new_data)[wid], my_src_tile, itr, word_data, ((uint32_t *)new_data)[wid] + word_data);
-                    ((uint32_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((uint32_t *)new_data)[wid] = ((uint32_t *)new_data)[wid] < word_data ? ((uint32_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((uint32_t *)new_data)[wid] = ((uint32_t *)new_data)[wid] > word_data ? ((uint32_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
+        // A second-level access waiting for a page walk is retried by the fill
+        bool waitForTranslation;
+        insertChainedPending(num_recv_rt_write_accesses, waitForTranslation);
+    } else if (my_instruction->opcode == Instruction::OpcodeType::INDIR_PROBE) {
+        // Comparing the keys of the head bucket, the match tile is 0 on a miss, 1 on a hit,
+        // 2 if the key may be in the overflow chain that the core must walk, and 3 on a hit
+        // in a bucket with an overflow chain, which may hold more tuples of a duplicate key
+        for (int i = 0; i < num_words; i++) {
+            int itr = my_recv_itrs[i];
+            const uint8_t *bucket = new_data + my_recv_wids[i] * my_word_size;
+            uint32_t key = maa->spd->getData<uint32_t>(my_idx_tile, itr);
+            uint32_t count, bucket_key, payload = 0, match = 0;
+            std::memcpy(&count, bucket + 4, sizeof(uint32_t));
+            count = std::min(count, (uint32_t)my_probe_tuples);
+            for (int j = 0; j < count; j++) {
+                std::memcpy(&bucket_key, bucket + 8 + 8 * j, sizeof(uint32_t));
+                if (bucket_key == key) {
+                    std::memcpy(&payload, bucket + 12 + 8 * j, sizeof(uint32_t));
+                    match = 1;
+                    break;
                 }
-                break;
             }
-            case Instruction::DataType::INT32_TYPE: {
-                int32_t word_data = maa->spd->getData<int32_t>(my_src_tile, itr);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%d) += SPD[%d][%d] (%d) = %d!\n",
-                            my_indirect_id, __func__, wid, ((int32_t *)new_data)[wid], my_src_tile, itr, word_data, ((int32_t *)new_data)[wid] + word_data);
-                    ((int32_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((int32_t *)new_data)[wid] = ((int32_t *)new_data)[wid] < word_data ? ((int32_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((int32_t *)new_data)[wid] = ((int32_t *)new_data)[wid] > word_data ? ((int32_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+            uint64_t next;
+            std::memcpy(&next, bucket + 8 + 8 * my_probe_tuples, sizeof(uint64_t));
+            if (next != 0) {
+                match = match == 1 ? 3 : 2;
             }
-            case Instruction::DataType::FLOAT32_TYPE: {
-                float word_data = maa->spd->getData<float>(my_src_tile, itr);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%f) += SPD[%d][%d] (%f) = %f!\n",
-                            my_indirect_id, __func__, wid, ((float *)new_data)[wid], my_src_tile, itr, word_data, ((float *)new_data)[wid] + word_data);
-                    ((float *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((float *)new_data)[wid] = ((float *)new_data)[wid] < word_data ? ((float *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((float *)new_data)[wid] = ((float *)new_data)[wid] > word_data ? ((float *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+            DPRINTF(MAAIndirect, "I[%d] %s: itr(%d) key(%u) count(%u) match(%u) payload(%u)!\n", my_indirect_id, __func__, itr, key, count, match, payload);
+            maa->spd->setData<uint32_t>(my_dst_tile, itr, payload);
+            if (my_match_tile != -1) {
+                maa->spd->setData<uint32_t>(my_match_tile, itr, match);
+                num_recv_spd_write_accesses++;
             }
-            case Instruction::DataType::UINT64_TYPE: {
-                uint64_t word_data = maa->spd->getData<uint64_t>(my_src_tile, itr);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%lu) += SPD[%d][%d] (%lu) = %lu!\n",
-                            my_indirect_id, __func__, wid, ((uint64_t *)new_data)[wid], my_src_tile, itr, word_data, ((uint64_t *)new_data)[wid] + word_data);
-                    ((uint64_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((uint64_t *)new_data)[wid] = ((uint64_t *)new_data)[wid] < word_data ? ((uint64_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((uint64_t *)new_data)[wid] = ((uint64_t *)new_data)[wid] > word_data ? ((uint64_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        }
+        num_recv_spd_read_accesses += num_words;
+        num_recv_spd_write_accesses += num_words;
+    } else if (my_is_CAS) {
+        for (int i = 0; i < num_words; i++) {
+            int itr = my_recv_itrs[i];
+            std::memcpy(my_recv_operands + 2 * i * my_word_size, maa->spd->getTileDataPtr(my_dst_tile, my_word_size) + itr * my_word_size, my_word_size);
+            if (my_src_tile != -1) {
+                std::memcpy(my_recv_operands + (2 * i + 1) * my_word_size, maa->spd->getTileDataPtr(my_src_tile, my_word_size) + itr * my_word_size, my_word_size);
+            } else {
+                std::memcpy(my_recv_operands + (2 * i + 1) * my_word_size, maa->rf->getDataPtr(my_src_reg), my_word_size);
             }
-            case Instruction::DataType::INT64_TYPE: {
-                int64_t word_data = maa->spd->getData<int64_t>(my_src_tile, itr);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%ld) += SPD[%d][%d] (%ld) = %ld!\n",
-                            my_indirect_id, __func__, wid, ((int64_t *)new_data)[wid], my_src_tile, itr, word_data, ((int64_t *)new_data)[wid] + word_data);
-                    ((int64_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((int64_t *)new_data)[wid] = ((int64_t *)new_data)[wid] < word_data ? ((int64_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((int64_t *)new_data)[wid] = ((int64_t *)new_data)[wid] > word_data ? ((int64_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        }
+        num_recv_spd_read_accesses += my_src_tile != -1 ? 2 * num_words : num_words;
+    } else if (my_is_bitmap) {
+        for (int i = 0; i < num_words; i++) {
+            my_recv_operands[i] = 1 << (maa->spd->getData<uint32_t>(my_idx_tile, my_recv_itrs[i]) & 7);
+        }
+        num_recv_spd_read_accesses += num_words;
+    } else if (my_combine_RMW == false && (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_VECTOR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_VECTOR)) {
+        if (my_word_size == 4) {
+            for (int i = 0; i < num_words; i++) {
+                ((uint32_t *)my_recv_operands)[i] = maa->spd->getData<uint32_t>(my_src_tile, my_recv_itrs[i]);
             }
-            case Instruction::DataType::FLOAT64_TYPE: {
-                double word_data = maa->spd->getData<double>(my_src_tile, itr);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%lf) += SPD[%d][%d] (%lf) = %lf!\n",
-                            my_indirect_id, __func__, wid, ((double *)new_data)[wid], my_src_tile, itr, word_data, ((double *)new_data)[wid] + word_data);
-                    ((double *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((double *)new_data)[wid] = ((double *)new_data)[wid] < word_data ? ((double *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((double *)new_data)[wid] = ((double *)new_data)[wid] > word_data ? ((double *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        } else if (my_word_size == 8) {
+            for (int i = 0; i < num_words; i++) {
+                ((uint64_t *)my_recv_operands)[i] = maa->spd->getData<uint64_t>(my_src_tile, my_recv_itrs[i]);
             }
-            default:
-                assert(false);
+        } else {
+            for (int i = 0; i < num_words; i++) {
+                maa->spd->getWord(my_src_tile, my_recv_itrs[i], my_word_size, my_recv_operands + i * my_word_size);
             }
-            break;
         }
-        case Instruction::OpcodeType::INDIR_RMW_SCALAR: {
-            switch (my_instruction->datatype) {
-            case Instruction::DataType::UINT32_TYPE: {
-                uint32_t word_data = maa->rf->getData<uint32_t>(my_src_reg);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%u) += RF[%d] (%u) = %u!\n",
-                            my_indirect_id, __func__, wid, ((uint32_t *)new_data)[wid], my_src_reg, word_data, ((uint32_t *)new_data)[wid] + word_data);
-                    ((uint32_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((uint32_t *)new_data)[wid] = ((uint32_t *)new_data)[wid] < word_data ? ((uint32_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((uint32_t *)new_data)[wid] = ((uint32_t *)new_data)[wid] > word_data ? ((uint32_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        num_recv_spd_read_accesses += num_words;
+    } else if (my_combine_RMW) {
+        // Leaders carry the combined operand of their word, and later RMWs to
+        // the word start a new combination as this line is already updated
+        for (int i = 0; i < num_words; i++) {
+            int itr = my_recv_itrs[i];
+            std::memcpy(my_recv_operands + i * my_word_size, getRMWOperand(itr), my_word_size);
+            if (my_combined[itr] == false && my_src_tile != -1) {
+                num_recv_spd_read_accesses++;
             }
-            case Instruction::DataType::INT32_TYPE: {
-                int32_t word_data = maa->rf->getData<int32_t>(my_src_reg);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%d) += RF[%d] (%d) = %d!\n",
-                            my_indirect_id, __func__, wid, ((int32_t *)new_data)[wid], my_src_reg, word_data, ((int32_t *)new_data)[wid] + word_data);
-                    ((int32_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((int32_t *)new_data)[wid] = ((int32_t *)new_data)[wid] < word_data ? ((int32_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((int32_t *)new_data)[wid] = ((int32_t *)new_data)[wid] > word_data ? ((int32_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+            my_combined[itr] = false;
+            Addr vaddr = my_base_addr + my_word_size * maa->spd->getData<uint32_t>(my_idx_tile, itr);
+            bool erased = my_combine_leaders.erase(vaddr);
+            panic_if(erased == false, "I[%d] %s: itr(%d) vaddr(0x%lx) is not a combine leader!\n", my_indirect_id, __func__, itr, vaddr);
+        }
+    } else if (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR) {
+        if (my_word_size == 8) {
+            ((uint64_t *)my_recv_operands)[0] = maa->rf->getData<uint64_t>(my_src_reg);
+        } else {
+            // Sub-word scalars are in the low bytes of the register
+            std::memcpy(my_recv_operands, maa->rf->getDataPtr(my_src_reg), my_word_size);
+        }
+    }
+
+    // Applying the instruction to all matched words of the line in one pass
+    if (my_recv_kernel != nullptr) {
+        (*my_recv_kernel)(new_data, my_recv_wids, my_recv_operands, my_dst_tile != -1 ? my_recv_fetched : nullptr, num_words);
+    }
+
+    // Writing the fetched words to the destination tile
+    if (my_dst_tile != -1 && my_recv_kernel != nullptr) {
+        if (my_is_bitmap) {
+            for (int i = 0; i < num_words; i++) {
+                int byte_id = my_recv_itrs[i] >> 3;
+                maa->spd->setBit(my_dst_tile, my_recv_itrs[i], my_recv_fetched[i] != 0);
+                assert(my_bitmap_pending[byte_id] > 0);
+                my_bitmap_pending[byte_id]--;
+                finishBitmapByte(byte_id);
             }
-            case Instruction::DataType::FLOAT32_TYPE: {
-                float word_data = maa->rf->getData<float>(my_src_reg);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%f) += RF[%d] (%f) = %f!\n",
-                            my_indirect_id, __func__, wid, ((float *)new_data)[wid], my_src_reg, word_data, ((float *)new_data)[wid] + word_data);
-                    ((float *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((float *)new_data)[wid] = ((float *)new_data)[wid] < word_data ? ((float *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((float *)new_data)[wid] = ((float *)new_data)[wid] > word_data ? ((float *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        } else if (my_word_size == 4) {
+            for (int i = 0; i < num_words; i++) {
+                maa->spd->setData<uint32_t>(my_dst_tile, my_recv_itrs[i], ((uint32_t *)my_recv_fetched)[i]);
             }
-            case Instruction::DataType::UINT64_TYPE: {
-                uint64_t word_data = maa->rf->getData<uint64_t>(my_src_reg);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%lu) += RF[%d] (%lu) = %lu!\n",
-                            my_indirect_id, __func__, wid, ((uint64_t *)new_data)[wid], my_src_reg, word_data, ((uint64_t *)new_data)[wid] + word_data);
-                    ((uint64_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((uint64_t *)new_data)[wid] = ((uint64_t *)new_data)[wid] < word_data ? ((uint64_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((uint64_t *)new_data)[wid] = ((uint64_t *)new_data)[wid] > word_data ? ((uint64_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        } else if (my_word_size == 8) {
+            for (int i = 0; i < num_words; i++) {
+                maa->spd->setData<uint64_t>(my_dst_tile, my_recv_itrs[i], ((uint64_t *)my_recv_fetched)[i]);
             }
-            case Instruction::DataType::INT64_TYPE: {
-                int64_t word_data = maa->rf->getData<int64_t>(my_src_reg);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%ld) += RF[%d] (%ld) = %ld!\n",
-                            my_indirect_id, __func__, wid, ((int64_t *)new_data)[wid], my_src_reg, word_data, ((int64_t *)new_data)[wid] + word_data);
-                    ((int64_t *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((int64_t *)new_data)[wid] = ((int64_t *)new_data)[wid] < word_data ? ((int64_t *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((int64_t *)new_data)[wid] = ((int64_t *)new_data)[wid] > word_data ? ((int64_t *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        } else {
+            for (int i = 0; i < num_words; i++) {
+                maa->spd->setWord(my_dst_tile, my_recv_itrs[i], my_word_size, my_recv_fetched + i * my_word_size);
             }
-            case Instruction::DataType::FLOAT64_TYPE: {
-                double word_data = maa->rf->getData<double>(my_src_reg);
-                if (my_instruction->optype == Instruction::OPType::ADD_OP) {
-                    DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] (%lf) += RF[%d] (%lf) = %lf!\n",
-                            my_indirect_id, __func__, wid, ((double *)new_data)[wid], my_src_reg, word_data, ((double *)new_data)[wid] + word_data);
-                    ((double *)new_data)[wid] += word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MIN_OP) {
-                    ((double *)new_data)[wid] = ((double *)new_data)[wid] < word_data ? ((double *)new_data)[wid] : word_data;
-                } else if (my_instruction->optype == Instruction::OPType::MAX_OP) {
-                    ((double *)new_data)[wid] = ((double *)new_data)[wid] > word_data ? ((double *)new_data)[wid] : word_data;
-                } else {
-                    panic_if(true, "I[%d] %s: unknown optype %s!\n", my_indirect_id, __func__, my_instruction->print());
-                }
-                break;
+        }
+        num_recv_spd_write_accesses += num_words;
+    }
+
+    // A swap succeeded if the old word was the expected one
+    if (my_is_CAS) {
+        for (int i = 0; i < num_words; i++) {
+            bool success = std::memcmp(my_recv_fetched + i * my_word_size, my_recv_operands + 2 * i * my_word_size, my_word_size) == 0;
+            if (success == false) {
+                (*maa->stats.IND_NumCASFailed[my_indirect_id])++;
             }
-            default:
-                assert(false);
+            if (my_match_tile != -1) {
+                maa->spd->setData<uint32_t>(my_match_tile, my_recv_itrs[i], success ? 1 : 0);
             }
-            break;
         }
-        default:
-            assert(false);
+        if (my_match_tile != -1) {
+            num_recv_spd_write_accesses += num_words;
         }
     }
 
     // Row table parallelism = total #banks.
     // We will have total #banks offset table walkers.
-    Cycles total_latency = updateLatency(num_recv_spd_read_accesses, 0, num_recv_spd_write_accesses, num_recv_rt_accesses, 0, total_num_RT_subslices);
+    Cycles total_latency = updateLatency(num_recv_spd_read_accesses, 0, num_recv_spd_write_accesses, num_recv_rt_accesses, num_recv_rt_write_accesses, total_num_RT_subslices);
     if (my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_VECTOR || my_instruction->opcode == Instruction::OpcodeType::INDIR_ST_SCALAR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_VECTOR || my_instruction->opcode == Instruction::OpcodeType::INDIR_RMW_SCALAR) {
         RequestPtr real_req = std::make_shared<Request>(addr, block_size, flags, maa->requestorId);
         real_req->setRegion(my_addr_range_id);
@@ -1151,8 +1682,10 @@ bool IndirectAccessUnit::recvData(const Addr addr, uint8_t *dataptr, bool is_blo
         for (int i = 0; i < block_size / my_word_size; i++) {
             if (my_word_size == 4)
                 DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] = %f!\n", my_indirect_id, __func__, i, write_pkt->getPtr<float>()[i]);
-            else
+            else if (my_word_size == 8)
                 DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] = %f!\n", my_indirect_id, __func__, i, write_pkt->getPtr<double>()[i]);
+            else
+                DPRINTF(MAAIndirect, "I[%d] %s: new_data[%d] = 0x%x!\n", my_indirect_id, __func__, i, my_word_size == 2 ? write_pkt->getPtr<uint16_t>()[i] : write_pkt->getPtr<uint8_t>()[i]);
         }
         DPRINTF(MAAIndirect, "I[%d] %s: created %s to send in %d cycles\n", my_indirect_id, __func__, write_pkt->print(), total_latency);
         maa->sendPacket(FuncUnitType::INDIRECT, my_indirect_id, write_pkt, maa->getClockEdge(total_latency), my_force_cache);
@@ -1166,6 +1699,8 @@ bool IndirectAccessUnit::recvData(const Addr addr, uint8_t *dataptr, bool is_blo
             DPRINTF(MAAIndirect, "I[%d] %s: expected: %d, received: %d responses!\n", my_indirect_id, __func__, my_expected_responses, my_received_responses);
         }
     }
+    // Checked after the chained re-insertion, which may have refilled the freed slice
+    bool is_full = RT[my_RT_config][RT_idx].is_full();
     if (was_full && !is_full) {
         DPRINTF(MAAIndirect, "I[%d] %s: RT[%d] was full, now not full, calling execution again!\n", my_indirect_id, __func__, RT_idx);
         panic_if(state != Status::Request && state != Status::Fill, "I[%d] %s: state is %s!\n", my_indirect_id, __func__, status_names[(int)state]);
@@ -1174,6 +1709,10 @@ bool IndirectAccessUnit::recvData(const Addr addr, uint8_t *dataptr, bool is_blo
     return true;
 }
 Addr IndirectAccessUnit::translatePacket(Addr vaddr) {
+    Addr paddr;
+    if (my_translation_memo.find(vaddr, paddr)) {
+        return paddr;
+    }
     /**** Address translation ****/
     RequestPtr translation_req = std::make_shared<Request>(vaddr, block_size, flags, maa->requestorId, my_instruction->PC, my_instruction->CID);
     ThreadContext *tc = maa->system->threads[my_instruction->CID];
@@ -1181,6 +1720,7 @@ Addr IndirectAccessUnit::translatePacket(Addr vaddr) {
     // The above function immediately does the translation and calls the finish function
     assert(my_translation_done);
     my_translation_done = false;
+    my_translation_memo.insert(vaddr, my_translated_addr);
     return my_translated_addr;
 }
 void IndirectAccessUnit::finish(const Fault &fault, const RequestPtr &req, ThreadContext *tc, BaseMMU::Mode mode) {
@@ -1189,6 +1729,79 @@ void IndirectAccessUnit::finish(const Fault &fault, const RequestPtr &req, Threa
     my_translation_done = true;
     my_translated_addr = req->getPaddr();
 }
+void IndirectAccessUnit::setRecvKernel() {
+    // Loads and stores only move words, so they are selected by the word size
+    switch (my_instruction->opcode) {
+    case Instruction::OpcodeType::INDIR_LD: {
+        my_recv_kernel = my_is_bitmap ? &recvBitKernel<false> : getRecvLoadKernel(my_word_size);
+        break;
+    }
+    case Instruction::OpcodeType::INDIR_LD_CHAINED: {
+        // The two levels have different word sizes, recvData handles them itself
+        my_recv_kernel = nullptr;
+        return;
+    }
+    case Instruction::OpcodeType::INDIR_PROBE: {
+        // Buckets are compared key by key in recvData
+        my_recv_kernel = nullptr;
+        return;
+    }
+    case Instruction::OpcodeType::INDIR_ST_VECTOR: {
+        my_recv_kernel = getRecvStoreKernel<false>(my_word_size);
+        break;
+    }
+    case Instruction::OpcodeType::INDIR_ST_SCALAR: {
+        my_recv_kernel = getRecvStoreKernel<true>(my_word_size);
+        break;
+    }
+    case Instruction::OpcodeType::INDIR_RMW_VECTOR: {
+        my_recv_kernel = getRecvRMWKernel<false>(my_instruction->datatype, my_instruction->optype);
+        if (my_is_CAS) {
+            my_recv_kernel = getRecvCASKernel(my_word_size);
+        }
+        break;
+    }
+    case Instruction::OpcodeType::INDIR_RMW_SCALAR: {
+        // Combined words have their own operands, so the operands are per word
+        my_recv_kernel = getRecvRMWKernel<true>(my_instruction->datatype, my_instruction->optype);
+        if (my_is_bitmap) {
+            my_recv_kernel = &recvBitKernel<true>;
+        } else if (my_combine_RMW) {
+            my_recv_kernel = getRecvRMWKernel<false>(my_instruction->datatype, my_instruction->optype);
+        } else if (my_is_CAS) {
+            my_recv_kernel = getRecvCASKernel(my_word_size);
+        }
+        break;
+    }
+    default:
+        assert(false);
+    }
+    panic_if(my_recv_kernel == nullptr, "I[%d] %s: unsupported instruction %s!\n", my_indirect_id, __func__, my_instruction->print());
+    my_combine_kernel = nullptr;
+    if (my_combine_RMW) {
+        my_combine_kernel = getCombineRMWKernel(my_instruction->datatype, my_instruction->optype);
+        panic_if(my_combine_kernel == nullptr, "I[%d] %s: unsupported instruction %s!\n", my_indirect_id, __func__, my_instruction->print());
+    }
+}
+const uint8_t *IndirectAccessUnit::getRMWOperand(int itr) {
+    if (my_combined[itr]) {
+        return my_combined_operands + itr * my_word_size;
+    } else if (my_src_tile != -1) {
+        return maa->spd->getTileDataPtr(my_src_tile, my_word_size) + itr * my_word_size;
+    } else {
+        return maa->rf->getDataPtr(my_src_reg);
+    }
+}
+void IndirectAccessUnit::combineRMW(int leader_itr, int itr) {
+    uint8_t *acc = my_combined_operands + leader_itr * my_word_size;
+    if (my_combined[leader_itr] == false) {
+        std::memcpy(acc, getRMWOperand(leader_itr), my_word_size);
+        my_combined[leader_itr] = true;
+    }
+    (*my_combine_kernel)(acc, getRMWOperand(itr));
+    (*maa->stats.IND_NumRMWCombined[my_indirect_id])++;
+    DPRINTF(MAAIndirect, "I[%d] %s: itr(%d) combined into itr(%d)!\n", my_indirect_id, __func__, itr, leader_itr);
+}
 void IndirectAccessUnit::setInstruction(Instruction *_instruction) {
     assert(my_instruction == nullptr);
     my_instruction = _instruction;
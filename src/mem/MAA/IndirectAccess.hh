@@ -5,8 +5,6 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
-#include <map>
-#include <set>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -24,6 +22,13 @@ class Instruction;
 
 class IndirectAccessUnit : public BaseMMU::Translation {
 public:
+    // Applies the instruction to the words of a received cache line. Entry i
+    // updates word wids[i] with operands[i] (or operands[0] for scalars), and
+    // if fetched is not null, saves the word's value before the update.
+    typedef void (*RecvKernel)(uint8_t *line, const int *wids, const uint8_t *operands, uint8_t *fetched, int num_words);
+    // Folds operand into the pending operand acc of an RMW to the same word
+    typedef void (*CombineKernel)(uint8_t *acc, const uint8_t *operand);
+
     enum class Status : uint8_t {
         Idle = 0,
         Decode = 1,
@@ -64,15 +69,16 @@ protected:
     int num_cores;
     bool reconfigure_RT;
     bool reorder_RT;
+    bool combine_RMW;
     int num_initial_RT_slices;
     Status state;
     RowTableSlice **RT;
     OffsetTable *offset_table;
     int dst_tile_id;
     Cycles rowtable_latency;
-    std::map<Addr, Tick> LoadsCacheHitRespondingTimeHistory;
-    std::map<Addr, Tick> LoadsCacheHitAccessingTimeHistory;
-    std::map<Addr, Tick> LoadsMemAccessingTimeHistory;
+    AddrTable LoadsCacheHitRespondingTimeHistory;
+    AddrTable LoadsCacheHitAccessingTimeHistory;
+    AddrTable LoadsMemAccessingTimeHistory;
 
 public:
     MAA *maa;
@@ -85,6 +91,7 @@ public:
                   int _num_row_table_config_cache_entries,
                   bool _reconfigure_row_table,
                   bool _reorder_row_table,
+                  bool _combine_rmw,
                   int _num_initial_row_table_slice,
                   Cycles _rowtable_latency,
                   int _num_channels,
@@ -94,6 +101,7 @@ public:
     bool scheduleNextExecution(bool force = false);
     void scheduleExecuteInstructionEvent(int latency = 0);
     void setInstruction(Instruction *_instruction);
+    void flushTLB() { my_TLB.flush(); }
     void memWritePacketSent(Addr addr);
     void memReadPacketSent(Addr addr);
     void cacheWritePacketSent(Addr addr);
@@ -122,13 +130,23 @@ protected:
     std::vector<int> my_sorted_indices;
     bool **my_RT_req_sent;
     std::vector<int> *my_RT_slice_order;
-    int my_i, my_RT_idx;
+    int my_i;
+    // Row table slice the last failed insertion found full, the unit waits for it to drain
+    int my_RT_idx;
+    int my_ready_end;
     bool my_fill_finished;
     bool my_force_cache_determined;
     bool my_force_cache;
 
     bool my_translation_done;
     Addr my_translated_addr;
+    TranslationMemo my_translation_memo;
+    TranslationBuffer my_TLB;
+    Tick my_translation_ready_tick;
+    Tick my_translation_finish_tick;
+    // Set while the fill or the chained re-insertion is blocked on a page walk
+    bool my_fill_translation_waited;
+    bool my_chained_translation_waited;
     int my_indirect_id;
     Tick my_SPD_read_finish_tick;
     Tick my_SPD_write_finish_tick;
@@ -138,19 +156,76 @@ protected:
     Tick my_fill_start_tick;
     Tick my_build_start_tick;
     Tick my_request_start_tick;
-    std::set<Addr> my_unique_WORD_addrs;
-    std::set<Addr> my_unique_CL_addrs;
-    std::set<Addr> my_unique_ROW_addrs;
+    AddrTable my_unique_WORD_addrs;
+    AddrTable my_unique_CL_addrs;
+    AddrTable my_unique_ROW_addrs;
+    // Row table policy: the CLs, DRAM rows, and DRAM rows per bank inserted
+    // since the last drain, and the hill climbing direction and throughput
+    AddrTable my_window_ROW_addrs;
+    int *my_window_bank_ROWs;
+    int *my_window_slice_ROWs;
+    int my_window_CLs;
+    int my_window_start_i;
+    Tick my_window_start_tick;
+    int my_RT_climb_dir;
+    double my_RT_climb_throughput;
+    // Configuration the row table switches to once it drains, -1 if none
+    int my_RT_next_config;
+    RecvKernel my_recv_kernel;
+    int *my_recv_itrs;
+    int *my_recv_wids;
+    uint8_t *my_recv_operands;
+    uint8_t *my_recv_fetched;
+    // INDIR_LD_CHAINED: per element, whether its first-level word has been
+    // received and the loaded index is being served from the second array
+    bool *my_second_level;
+    uint32_t *my_chained_idxs;
+    std::vector<int> my_chained_pending;
+    int my_chained_pending_head;
+    int my_num_chained_outstanding;
+    Addr my_base_addr2, my_min_addr2, my_max_addr2;
+    // INDIR_PROBE: hash of the key, bucket layout, and the match tile
+    // INDIR_RMW with CAS_OP: the match tile gets 1 for each swap that succeeded
+    uint32_t my_probe_mask, my_probe_skip;
+    int my_probe_stride, my_probe_tuples;
+    int my_match_tile;
+    // INDIR_RMW without a destination tile: word address -> the pending element
+    // (leader) that later RMWs to the same word are combined into
+    bool my_combine_RMW;
+    bool my_is_CAS;
+    // BIT_TYPE: element idx is bit (idx & 7) of byte (idx >> 3), INDIR_LD tests
+    // the bits and INDIR_RMW_SCALAR with OR_OP tests and sets them
+    bool my_is_bitmap;
+    // Per destination byte, the bits inserted to the row table and not yet received. A byte
+    // is finished once fill has walked all of its elements and none of its bits is pending
+    uint8_t *my_bitmap_pending;
+    bool my_bitmap_tail_cleared;
+    CombineKernel my_combine_kernel;
+    // Word vaddr -> element index of its combine leader
+    AddrValueTable<int> my_combine_leaders;
+    bool *my_combined;
+    uint8_t *my_combined_operands;
 
     Addr translatePacket(Addr vaddr);
     bool checkAndResetAllRowTablesSent();
     int getRowTableIdx(int RT_config, int channel, int rank, int bankgroup, int bank);
     Addr getGrowAddr(int RT_config, int bankgroup, int bank, int row);
+    int getDramBankIdx(int channel, int rank, int bankgroup, int bank);
     int getRowTableConfig(Addr addr);
     void setRowTableConfig(Addr addr, int num_CLs, int num_ROWs);
+    double getRowTableLoad(int RT_config);
+    void adaptRowTableConfig();
+    void resetRowTableWindow();
+    void setRecvKernel();
+    const uint8_t *getRMWOperand(int itr);
+    void combineRMW(int leader_itr, int itr);
     void checkTileReady();
     bool checkElementReady();
     bool checkReadyForFinish();
+    bool insertRowTable(Addr vaddr, int word_size, int itr, bool second_level, int &num_rowtable_accesses);
+    bool checkTranslation(Addr vaddr, bool &waited);
+    bool insertChainedPending(int &num_rowtable_accesses, bool &waitForTranslation);
+    void finishBitmapByte(int byte_id);
     void fillRowTable(bool &finished, bool &waitForFinish, bool &waitForElement, bool &needDrain, int &num_spd_read_condidx_accesses, int &num_rowtable_accesses);
     void executeInstruction();
     EventFunctionWrapper executeInstructionEvent;
@@ -420,10 +420,7 @@ bool Invalidator::recvData(int tile_id, int element_id, uint8_t *dataptr) {
     cl_status[cl_id] = CLStatus::Uncached;
     DPRINTF(MAAInvalidator, "%s T[%d] E[%d-%d] CL[%d]: uncached\n", __func__, tile_id, element_id, element_id + 15, cl_id);
     my_received_responses++;
-    uint32_t *dataptr_u32_typed = (uint32_t *)dataptr;
-    for (int i = 0; i < 16; i++) {
-        maa->spd->setData<uint32_t>(tile_id, element_id + i, dataptr_u32_typed[i]);
-    }
+    maa->spd->setData<uint32_t>(tile_id, element_id, 16, (uint32_t *)dataptr);
     if (state == Status::Response && my_received_responses == my_total_invalidations_sent) {
         DPRINTF(MAAInvalidator, "%s: all words received, calling execution again!\n", __func__);
         scheduleExecuteInstructionEvent();
@@ -18,6 +18,7 @@
 #include "debug/MAAMemPort.hh"
 #include "debug/MAAController.hh"
 #include "sim/cur_tick.hh"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <string>
@@ -52,19 +53,27 @@ MAA::MAA(const MAAParams &p)
       num_tile_elements(p.num_tile_elements),
       num_regs(p.num_regs_per_core * p.num_cores),
       num_instructions_per_core(p.num_instructions_per_core),
+      num_loop_instructions_per_core(p.num_loop_instructions_per_core),
       num_row_table_rows_per_slice(p.num_row_table_rows_per_slice),
       num_row_table_entries_per_subslice_row(p.num_row_table_entries_per_subslice_row),
       num_row_table_config_cache_entries(p.num_row_table_config_cache_entries),
       reconfigure_row_table(p.reconfigure_row_table),
+      row_table_policy(p.row_table_policy),
       reorder_row_table(p.no_reorder == false ? true : false),
+      combine_rmw(p.no_rmw_combine == false ? true : false),
       force_cache_access(p.force_cache_access),
       num_initial_row_table_slices(p.num_initial_row_table_slices),
       num_request_table_addresses(p.num_request_table_addresses),
       num_request_table_entries_per_address(p.num_request_table_entries_per_address),
+      num_tlb_entries(p.num_tlb_entries),
+      tlb_associativity(p.tlb_associativity),
+      tlb_page_size(p.tlb_page_size),
+      tlb_page_table_size(p.tlb_page_table_size),
       num_memory_channels(p.num_memory_channels),
       num_cores(p.num_cores),
       num_maas(p.num_maas),
       rowtable_latency(p.rowtable_latency),
+      tlb_hit_latency(p.tlb_hit_latency),
       addrRegions(MAX_CMD_REGIONS, {0, 0}),
       maxRegionID(-1),
       system(p.system),
@@ -77,6 +86,7 @@ MAA::MAA(const MAAParams &p)
       sendMemEvent([this] { sendOutstandingMemPacket(); }, name()) {
 
     m_core_addr_bits = calc_log2(num_cores);
+    m_addr_mapping = p.dram_addr_mapping;
     panic_if(num_cores % num_maas != 0, "Number of cores %d must be a multiple of the number of MAAs %s\n", num_cores, num_maas);
     num_cores_per_maas = num_cores / num_maas;
     requestorId = p.system->getRequestorId(this);
@@ -84,7 +94,16 @@ MAA::MAA(const MAAParams &p)
     rf = new RF(num_regs);
     num_instructions_per_maa = num_instructions_per_core * num_cores_per_maas;
     num_instructions_total = num_instructions_per_maa * num_maas;
-    ifile = new IF(num_instructions_per_maa, num_maas, this);
+    ifile = new IF(num_instructions_per_maa, num_maas, p.issue_policy, this);
+    my_loops.resize(num_cores);
+    for (int i = 0; i < num_cores; i++) {
+        my_loops[i].recording = false;
+        my_loops[i].replaying = false;
+        my_loops[i].instructions.reserve(num_loop_instructions_per_core);
+        my_loops[i].written_tiles.resize(num_tiles, false);
+        my_loops[i].written_regs.resize(num_regs, false);
+        my_loops[i].end_pkt = nullptr;
+    }
     streamAccessUnits = new StreamAccessUnit[num_maas];
     streamAccessIdle = new bool[num_maas];
     for (int i = 0; i < num_maas; i++) {
@@ -170,12 +189,17 @@ MAA::MAA(const MAAParams &p)
 
     my_last_idle_tick = curTick();
     my_last_reset_tick = curTick();
+    my_issue_func_unit_base = 0;
+    my_issue_maa_base = 0;
     my_num_outstanding_indirect_pkts = new uint32_t[num_maas];
     my_num_outstanding_stream_pkts = new uint32_t[num_maas];
     for (int i = 0; i < num_maas; i++) {
         my_num_outstanding_indirect_pkts[i] = 0;
         my_num_outstanding_stream_pkts[i] = 0;
     }
+    // Each unit has at most one outstanding packet per tile element
+    my_free_outstanding_pkts = nullptr;
+    my_outstanding_pkt_map.reserve(num_maas * num_tile_elements);
 }
 
 void MAA::init() {
@@ -195,6 +219,8 @@ MAA::~MAA() {
         delete port;
     delete[] my_num_outstanding_indirect_pkts;
     delete[] my_num_outstanding_stream_pkts;
+    for (auto outstanding_pkt : my_outstanding_pkt_pool)
+        delete outstanding_pkt;
 }
 
 void MAA::addAddrRegion(Addr start, Addr end, int8_t id) {
@@ -222,6 +248,11 @@ void MAA::clearAddrRegion() {
     for (int i = 0; i < MAX_CMD_REGIONS; i++) {
         addrRegions[i] = {0, 0};
     }
+    // New regions may be remapped, so the unit TLBs are flushed
+    for (int i = 0; i < num_maas; i++) {
+        streamAccessUnits[i].flushTLB();
+        indirectAccessUnits[i].flushTLB();
+    }
 }
 
 int MAA::getAddrRegion(Addr addr) {
@@ -281,7 +312,42 @@ void MAA::addRamulator(memory::Ramulator2 *_ramulator2) {
             m_addr_bits[ADDR_COLUMN_LEVEL],
             m_addr_bits[ADDR_CHANNEL_LEVEL],
             m_tx_offset);
-    assert(m_num_levels == 6);
+    assert(m_num_levels == ADDR_MAX_LEVEL);
+    // Precomputing the decoder of map_addr, levels are listed from the lowest address bits
+    std::vector<int> levels;
+    int shift = 0;
+    int col_low_bits = 0;
+    switch (m_addr_mapping) {
+    case enums::RoBaRaCoCh: {
+        levels = {ADDR_CHANNEL_LEVEL, ADDR_COLUMN_LEVEL, ADDR_RANK_LEVEL, ADDR_BANKGROUP_LEVEL, ADDR_BANK_LEVEL, ADDR_ROW_LEVEL};
+        break;
+    }
+    case enums::ChRaBaRoCo: {
+        levels = {ADDR_COLUMN_LEVEL, ADDR_ROW_LEVEL, ADDR_BANK_LEVEL, ADDR_BANKGROUP_LEVEL, ADDR_RANK_LEVEL, ADDR_CHANNEL_LEVEL};
+        break;
+    }
+    case enums::MOP4CLXOR: {
+        // The lowest 2 column bits are below the channel, decoded by map_addr
+        col_low_bits = 2;
+        shift = col_low_bits;
+        levels = {ADDR_CHANNEL_LEVEL, ADDR_RANK_LEVEL, ADDR_BANKGROUP_LEVEL, ADDR_BANK_LEVEL, ADDR_COLUMN_LEVEL, ADDR_ROW_LEVEL};
+        break;
+    }
+    default:
+        panic("Invalid DRAM address mapping %d!\n", (int)m_addr_mapping);
+    }
+    for (int level : levels) {
+        int bits = level == ADDR_COLUMN_LEVEL ? m_addr_bits[level] - col_low_bits : m_addr_bits[level];
+        m_addr_shift[level] = shift;
+        m_addr_mask[level] = ((Addr)1 << bits) - 1;
+        shift += bits;
+    }
+    // Each level above the column is XORed with the next column bits
+    int xor_shift = 0;
+    for (int level = 0; level < ADDR_COLUMN_LEVEL; level++) {
+        m_addr_xor_shift[level] = xor_shift;
+        xor_shift += m_addr_bits[level];
+    }
     num_channels = m_org[ADDR_CHANNEL_LEVEL];
     panic_if(memSidePorts.size() != num_channels, "Number of memory channels %d != number of memside ports %d\n", num_channels, memSidePorts.size());
     mem_channels_blocked = new bool[num_channels];
@@ -302,40 +368,48 @@ void MAA::addRamulator(memory::Ramulator2 *_ramulator2) {
                                         num_row_table_config_cache_entries,
                                         reconfigure_row_table,
                                         reorder_row_table,
+                                        combine_rmw,
                                         num_initial_row_table_slices,
                                         rowtable_latency,
                                         num_channels,
                                         num_cores,
                                         this);
     }
-    my_outstanding_indirect_cache_read_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_cores];
-    my_outstanding_indirect_cache_write_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_cores];
-    my_outstanding_indirect_mem_write_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_channels];
-    my_outstanding_indirect_mem_read_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_channels];
-    my_outstanding_stream_cache_read_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_cores];
-    my_outstanding_stream_cache_write_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_cores];
-    my_outstanding_stream_mem_write_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_cores];
-    my_outstanding_stream_mem_read_pkts = new std::multiset<OutstandingPacket, CompareByTick>[num_cores];
+    my_outstanding_indirect_cache_read_pkts = new OutstandingPacketQueue[num_cores];
+    my_outstanding_indirect_cache_write_pkts = new OutstandingPacketQueue[num_cores];
+    my_outstanding_indirect_mem_write_pkts = new OutstandingPacketQueue[num_channels];
+    my_outstanding_indirect_mem_read_pkts = new OutstandingPacketQueue[num_channels];
+    my_outstanding_stream_cache_read_pkts = new OutstandingPacketQueue[num_cores];
+    my_outstanding_stream_cache_write_pkts = new OutstandingPacketQueue[num_cores];
+    my_outstanding_stream_mem_write_pkts = new OutstandingPacketQueue[num_cores];
+    my_outstanding_stream_mem_read_pkts = new OutstandingPacketQueue[num_cores];
 }
-// RoBaRaCoCh address mapping taking from the Ramulator2
 int slice_lower_bits(uint64_t &addr, int bits) {
     int lbits = addr & ((1 << bits) - 1);
     addr >>= bits;
     return lbits;
 }
-std::vector<int> MAA::map_addr(Addr addr) {
-    std::vector<int> addr_vec(m_num_levels, -1);
+// Address mappings taken from the Ramulator2 linear mappers
+DramCoord MAA::map_addr(Addr addr) const {
+    DramCoord coord;
     addr = addr >> m_tx_offset;
-    addr_vec[0] = slice_lower_bits(addr, m_addr_bits[0]);
-    addr_vec[m_addr_bits.size() - 1] = slice_lower_bits(addr, m_addr_bits[m_addr_bits.size() - 1]);
-    for (int i = 1; i <= m_row_bits_idx; i++) {
-        addr_vec[i] = slice_lower_bits(addr, m_addr_bits[i]);
+    for (int level = 0; level < ADDR_MAX_LEVEL; level++) {
+        coord.level[level] = (addr >> m_addr_shift[level]) & m_addr_mask[level];
     }
-    return addr_vec;
+    if (m_addr_mapping == enums::MOP4CLXOR) {
+        Addr col = (addr & 3) | ((Addr)coord.level[ADDR_COLUMN_LEVEL] << 2);
+        coord.level[ADDR_COLUMN_LEVEL] = col;
+        for (int level = 0; level < ADDR_COLUMN_LEVEL; level++) {
+            coord.level[level] ^= (col >> m_addr_xor_shift[level]) & m_addr_mask[level];
+        }
+    }
+    return coord;
 }
-int MAA::channel_addr(Addr addr) {
-    addr = addr >> m_tx_offset;
-    return slice_lower_bits(addr, m_addr_bits[0]);
+int MAA::channel_addr(Addr addr) const {
+    if (m_addr_mapping == enums::MOP4CLXOR) {
+        return map_addr(addr)[ADDR_CHANNEL_LEVEL];
+    }
+    return ((addr >> m_tx_offset) >> m_addr_shift[ADDR_CHANNEL_LEVEL]) & m_addr_mask[ADDR_CHANNEL_LEVEL];
 }
 int MAA::core_addr(Addr addr) {
     addr = addr >> m_tx_offset;
@@ -382,12 +456,10 @@ void MAA::issueInstruction() {
                 invalidatorIdle = false;
             }
         }
-        int func_unit_type_base = rand() % 4;
         for (int func_unit_type_offset = 0; func_unit_type_offset < 4; func_unit_type_offset++) {
-            int func_unit_type = (func_unit_type_base + func_unit_type_offset) % 4;
-            int maa_id_base = rand() % num_maas;
+            int func_unit_type = (my_issue_func_unit_base + func_unit_type_offset) % 4;
             for (int maa_id_offset = 0; maa_id_offset < num_maas; maa_id_offset++) {
-                int maa_id = (maa_id_base + maa_id_offset) % num_maas;
+                int maa_id = (my_issue_maa_base + maa_id_offset) % num_maas;
                 switch (func_unit_type) {
                 case 0: {
                     if (streamAccessIdle[maa_id]) {
@@ -468,6 +540,8 @@ void MAA::issueInstruction() {
             }
         }
     }
+    my_issue_func_unit_base = (my_issue_func_unit_base + 1) % 4;
+    my_issue_maa_base = (my_issue_maa_base + 1) % num_maas;
     if (were_all_units_idle && !are_all_units_idle) {
         stats.cycles_IDLE += getTicksToCycles(curTick() - my_last_idle_tick);
     }
@@ -515,7 +589,21 @@ void MAA::dispatchRegister() {
     while (pkt_it != my_register_pkts.end() && register_it != my_registers.end()) {
         RegisterPtr reg = *register_it;
         PacketPtr pkt = *pkt_it;
+        LoopBuffer &loop = my_loops[reg->core_id];
+        if (loop.replaying) {
+            // Writes after LOOP_END must not race with the induction register updates of the replay
+            DPRINTF(MAAController, "%s: Reg write %d waits for core[%d] loop!\n", __func__, reg->register_id, reg->core_id);
+            pkt_it++;
+            register_it++;
+            continue;
+        }
         if (ifile->canPushRegister(*reg)) {
+            if (loop.recording) {
+                panic_if(reg->register_id == loop.induction_reg || reg->register_id == loop.alt_induction_reg ||
+                             reg->register_id == loop.bound_reg || reg->register_id == loop.stride_reg,
+                         "core[%d] wrote loop register %d inside the loop body!\n", reg->core_id, reg->register_id);
+                loop.written_regs[reg->register_id] = true;
+            }
             DPRINTF(MAAController, "%s: register %d write dispatched!\n", __func__, reg->register_id);
             if (reg->size == 4) {
                 rf->setData<uint32_t>(reg->register_id, reg->data_UINT32);
@@ -536,8 +624,209 @@ void MAA::dispatchRegister() {
         }
     }
 }
+bool MAA::pushInstruction(InstructionPtr instruction) {
+    instruction->src1Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->src1SpdID, false);
+    instruction->src2Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->src2SpdID, false);
+    instruction->condStatus = (Instruction::TileStatus)getTileStatus(instruction, instruction->condSpdID, false);
+    // assume that we can read from any tile, so invalidate all destinations
+    // Instructions with DST1: stream and indirect load, range loop, ALU
+    instruction->dst1Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->dst1SpdID, true);
+    // Instructions with DST2: range loop
+    instruction->dst2Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->dst2SpdID, true);
+    if (ifile->pushInstruction(*instruction) == false) {
+        DPRINTF(MAAController, "%s: %s failed to dipatch!\n", __func__, instruction->print());
+        return false;
+    }
+    DPRINTF(MAAController, "%s: %s dispatched!\n", __func__, instruction->print());
+    if (instruction->dst1SpdID != -1) {
+        assert(instruction->dst1SpdID != instruction->src1SpdID);
+        assert(instruction->dst1SpdID != instruction->src2SpdID);
+        spd->setTileIdle(instruction->dst1SpdID, instruction->getWordSize(instruction->dst1SpdID));
+        spd->setTileNotReady(instruction->dst1SpdID, instruction->getWordSize(instruction->dst1SpdID));
+    }
+    if (instruction->dst2SpdID != -1) {
+        assert(instruction->dst2SpdID != instruction->src1SpdID);
+        assert(instruction->dst2SpdID != instruction->src2SpdID);
+        spd->setTileIdle(instruction->dst2SpdID, instruction->getWordSize(instruction->dst2SpdID));
+        spd->setTileNotReady(instruction->dst2SpdID, instruction->getWordSize(instruction->dst2SpdID));
+    }
+    if (instruction->src1SpdID != -1) {
+        spd->setTileNotReady(instruction->src1SpdID, instruction->getWordSize(instruction->src1SpdID));
+    }
+    if (instruction->src2SpdID != -1) {
+        spd->setTileNotReady(instruction->src2SpdID, instruction->getWordSize(instruction->src2SpdID));
+    }
+    scheduleIssueInstructionEvent(1);
+    return true;
+}
+void MAA::recordLoopInstruction(InstructionPtr instruction, PacketPtr pkt) {
+    LoopBuffer &loop = my_loops[instruction->core_id];
+    bool respond = true;
+    switch (instruction->opcode) {
+    case Instruction::OpcodeType::LOOP_BEGIN: {
+        panic_if(loop.recording || loop.replaying, "%s: nested loops are not supported!\n", instruction->print());
+        panic_if(instruction->src1RegID == -1 || instruction->src2RegID == -1 || instruction->src3RegID == -1,
+                 "%s: loop requires induction, bound, and stride registers!\n", instruction->print());
+        panic_if(instruction->datatype != Instruction::DataType::UINT32_TYPE && instruction->datatype != Instruction::DataType::INT32_TYPE &&
+                     instruction->datatype != Instruction::DataType::UINT64_TYPE && instruction->datatype != Instruction::DataType::INT64_TYPE,
+                 "%s: loop induction must be an integer!\n", instruction->print());
+        loop.recording = true;
+        loop.datatype = instruction->datatype;
+        loop.induction_reg = instruction->src1RegID;
+        loop.bound_reg = instruction->src2RegID;
+        loop.stride_reg = instruction->src3RegID;
+        loop.alt_induction_reg = instruction->dst1RegID;
+        loop.alt_tile_offset = instruction->dst1SpdID == -1 ? 0 : instruction->dst1SpdID;
+        loop.instructions.clear();
+        std::fill(loop.written_tiles.begin(), loop.written_tiles.end(), false);
+        std::fill(loop.written_regs.begin(), loop.written_regs.end(), false);
+        DPRINTF(MAAController, "%s: core[%d] recording loop %s!\n", __func__, instruction->core_id, instruction->print());
+        break;
+    }
+    case Instruction::OpcodeType::LOOP_END: {
+        panic_if(loop.recording == false, "%s: received without LOOP_BEGIN!\n", instruction->print());
+        loop.recording = false;
+        if (loop.datatype == Instruction::DataType::UINT32_TYPE) {
+            loop.induction = rf->getData<uint32_t>(loop.induction_reg);
+            loop.bound = rf->getData<uint32_t>(loop.bound_reg);
+            loop.stride = rf->getData<uint32_t>(loop.stride_reg);
+        } else if (loop.datatype == Instruction::DataType::INT32_TYPE) {
+            loop.induction = rf->getData<int32_t>(loop.induction_reg);
+            loop.bound = rf->getData<int32_t>(loop.bound_reg);
+            loop.stride = rf->getData<int32_t>(loop.stride_reg);
+        } else {
+            loop.induction = rf->getData<int64_t>(loop.induction_reg);
+            loop.bound = rf->getData<int64_t>(loop.bound_reg);
+            loop.stride = rf->getData<int64_t>(loop.stride_reg);
+        }
+        panic_if(loop.stride <= 0, "%s: loop stride %ld must be positive!\n", instruction->print(), loop.stride);
+        // The core wrote these registers once while recording, every replayed iteration would read that value
+        for (Instruction &body_instruction : loop.instructions) {
+            for (int reg_id : {body_instruction.src1RegID, body_instruction.src2RegID, body_instruction.src3RegID}) {
+                panic_if(reg_id != -1 && loop.written_regs[reg_id],
+                         "%s: loop body reads register %d that the core writes per iteration, write it before LOOP_BEGIN!\n",
+                         body_instruction.print(), reg_id);
+            }
+        }
+        // Alternate tiles must not be used by the loop itself
+        std::vector<bool> used_tiles(num_tiles, false);
+        for (Instruction &body_instruction : loop.instructions) {
+            for (int tile_id : {body_instruction.src1SpdID, body_instruction.src2SpdID, body_instruction.condSpdID, body_instruction.dst1SpdID, body_instruction.dst2SpdID}) {
+                if (tile_id != -1) {
+                    used_tiles[tile_id] = true;
+                    if (body_instruction.getWordSize(tile_id) == 8) {
+                        used_tiles[tile_id + 1] = true;
+                    }
+                }
+            }
+        }
+        for (int tile_id = 0; tile_id < num_tiles && loop.alt_tile_offset != 0; tile_id++) {
+            if (loop.written_tiles[tile_id]) {
+                int alt_tile_id = tile_id + loop.alt_tile_offset;
+                panic_if(alt_tile_id >= num_tiles || used_tiles[alt_tile_id],
+                         "%s: alternate tile %d of tile %d is invalid!\n", instruction->print(), alt_tile_id, tile_id);
+            }
+        }
+        loop.iteration = 0;
+        loop.next_instruction = 0;
+        loop.replaying = true;
+        loop.end_pkt = pkt;
+        respond = false;
+        DPRINTF(MAAController, "%s: core[%d] replaying %d instructions from %ld to %ld by %ld!\n", __func__, instruction->core_id,
+                loop.instructions.size(), loop.induction, loop.bound, loop.stride);
+        break;
+    }
+    default: {
+        panic_if(loop.instructions.size() == num_loop_instructions_per_core, "%s: loop replay buffer is full!\n", instruction->print());
+        for (int reg_id : {instruction->dst1RegID, instruction->dst2RegID}) {
+            panic_if(reg_id != -1 && (reg_id == loop.induction_reg || reg_id == loop.alt_induction_reg),
+                     "%s: loop body cannot write the induction registers!\n", instruction->print());
+        }
+        for (int tile_id : {instruction->dst1SpdID, instruction->dst2SpdID}) {
+            if (tile_id != -1) {
+                loop.written_tiles[tile_id] = true;
+                if (instruction->getWordSize(tile_id) == 8) {
+                    loop.written_tiles[tile_id + 1] = true;
+                }
+            }
+        }
+        loop.instructions.push_back(*instruction);
+        DPRINTF(MAAController, "%s: %s recorded!\n", __func__, instruction->print());
+        break;
+    }
+    }
+    if (respond) {
+        pkt->makeTimingResponse();
+        pkt->headerDelay = pkt->payloadDelay = 0;
+        cpuSidePorts[0]->schedTimingResp(pkt, getClockEdge(Cycles(1)));
+    } else {
+        replayLoop(instruction->core_id);
+    }
+}
+void MAA::replayLoop(int core_id) {
+    LoopBuffer &loop = my_loops[core_id];
+    while (loop.replaying) {
+        bool is_alternate = loop.iteration % 2 == 1;
+        int induction_reg = (is_alternate && loop.alt_induction_reg != -1) ? loop.alt_induction_reg : loop.induction_reg;
+        if (loop.next_instruction == 0) {
+            if (loop.induction >= loop.bound || loop.instructions.empty()) {
+                DPRINTF(MAAController, "%s: core[%d] loop finished after %d iterations!\n", __func__, core_id, loop.iteration);
+                loop.replaying = false;
+                loop.end_pkt->makeTimingResponse();
+                loop.end_pkt->headerDelay = loop.end_pkt->payloadDelay = 0;
+                cpuSidePorts[0]->schedTimingResp(loop.end_pkt, getClockEdge(Cycles(1)));
+                loop.end_pkt = nullptr;
+                scheduleDispatchRegisterEvent();
+                break;
+            }
+            // The previous user of this induction register must have read it
+            Register induction_register;
+            induction_register.register_id = induction_reg;
+            induction_register.size = Instruction::DataTypeSize(loop.datatype);
+            induction_register.core_id = core_id;
+            induction_register.maa_id = core_id % num_maas;
+            if (ifile->canPushRegister(induction_register) == false) {
+                break;
+            }
+            if (induction_register.size == 4) {
+                rf->setData<uint32_t>(induction_reg, (uint32_t)loop.induction);
+            } else {
+                rf->setData<uint64_t>(induction_reg, (uint64_t)loop.induction);
+            }
+        }
+        Instruction instruction = loop.instructions[loop.next_instruction];
+        if (is_alternate) {
+            for (int16_t *tile_id : {&instruction.src1SpdID, &instruction.src2SpdID, &instruction.condSpdID, &instruction.dst1SpdID, &instruction.dst2SpdID}) {
+                if (*tile_id != -1 && loop.written_tiles[*tile_id]) {
+                    *tile_id += loop.alt_tile_offset;
+                }
+            }
+            for (int16_t *reg_id : {&instruction.src1RegID, &instruction.src2RegID, &instruction.src3RegID}) {
+                if (*reg_id == loop.induction_reg) {
+                    *reg_id = induction_reg;
+                }
+            }
+        }
+        if (pushInstruction(&instruction) == false) {
+            break;
+        }
+        stats.numInst_REPLAY++;
+        loop.next_instruction++;
+        if (loop.next_instruction == loop.instructions.size()) {
+            loop.next_instruction = 0;
+            loop.iteration++;
+            loop.induction += loop.stride;
+            stats.numLoopIterations++;
+        }
+    }
+}
 void MAA::dispatchInstruction() {
     DPRINTF(MAAController, "%s: dispatching instruction...!\n", __func__);
+    for (int core_id = 0; core_id < num_cores; core_id++) {
+        if (my_loops[core_id].replaying) {
+            replayLoop(core_id);
+        }
+    }
     assert(my_instruction_pkts.size() == my_instructions.size());
     assert(my_instruction_recvs.size() == my_instructions.size());
     assert(my_instruction_RIDs.size() == my_instructions.size());
@@ -550,45 +839,26 @@ void MAA::dispatchInstruction() {
         if (*recv_it == true) {
             InstructionPtr instruction = *instruction_it;
             PacketPtr pkt = *pkt_it;
-            instruction->src1Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->src1SpdID, false);
-            instruction->src2Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->src2SpdID, false);
-            instruction->condStatus = (Instruction::TileStatus)getTileStatus(instruction, instruction->condSpdID, false);
-            // assume that we can read from any tile, so invalidate all destinations
-            // Instructions with DST1: stream and indirect load, range loop, ALU
-            instruction->dst1Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->dst1SpdID, true);
-            // Instructions with DST2: range loop
-            instruction->dst2Status = (Instruction::TileStatus)getTileStatus(instruction, instruction->dst2SpdID, true);
-            if (ifile->pushInstruction(*instruction)) {
-                DPRINTF(MAAController, "%s: %s dispatched!\n", __func__, instruction->print());
-                if (instruction->dst1SpdID != -1) {
-                    assert(instruction->dst1SpdID != instruction->src1SpdID);
-                    assert(instruction->dst1SpdID != instruction->src2SpdID);
-                    spd->setTileIdle(instruction->dst1SpdID, instruction->getWordSize(instruction->dst1SpdID));
-                    spd->setTileNotReady(instruction->dst1SpdID, instruction->getWordSize(instruction->dst1SpdID));
-                }
-                if (instruction->dst2SpdID != -1) {
-                    assert(instruction->dst2SpdID != instruction->src1SpdID);
-                    assert(instruction->dst2SpdID != instruction->src2SpdID);
-                    spd->setTileIdle(instruction->dst2SpdID, instruction->getWordSize(instruction->dst2SpdID));
-                    spd->setTileNotReady(instruction->dst2SpdID, instruction->getWordSize(instruction->dst2SpdID));
-                }
-                if (instruction->src1SpdID != -1) {
-                    spd->setTileNotReady(instruction->src1SpdID, instruction->getWordSize(instruction->src1SpdID));
-                }
-                if (instruction->src2SpdID != -1) {
-                    spd->setTileNotReady(instruction->src2SpdID, instruction->getWordSize(instruction->src2SpdID));
-                }
+            bool dispatched = false;
+            if (instruction->opcode == Instruction::OpcodeType::LOOP_BEGIN ||
+                instruction->opcode == Instruction::OpcodeType::LOOP_END ||
+                my_loops[instruction->core_id].recording) {
+                recordLoopInstruction(instruction, pkt);
+                dispatched = true;
+            } else if (my_loops[instruction->core_id].replaying == false && pushInstruction(instruction)) {
+                // Instructions after a loop wait for all of its iterations to be dispatched
                 pkt->makeTimingResponse();
                 pkt->headerDelay = pkt->payloadDelay = 0;
                 cpuSidePorts[0]->schedTimingResp(pkt, getClockEdge(Cycles(1)));
-                scheduleIssueInstructionEvent(1);
+                dispatched = true;
+            }
+            if (dispatched) {
                 pkt_it = my_instruction_pkts.erase(pkt_it);
                 recv_it = my_instruction_recvs.erase(recv_it);
                 rid_it = my_instruction_RIDs.erase(rid_it);
                 instruction_it = my_instructions.erase(instruction_it);
                 delete instruction;
             } else {
-                DPRINTF(MAAController, "%s: %s failed to dipatch!\n", __func__, instruction->print());
                 pkt_it++;
                 recv_it++;
                 rid_it++;
@@ -773,8 +1043,14 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
       ADD_STAT(numInst_ALUS, statistics::units::Count::get(), "number of ALU Scalar instructions"),
       ADD_STAT(numInst_ALUV, statistics::units::Count::get(), "number of ALU Vector instructions"),
       ADD_STAT(numInst_ALUR, statistics::units::Count::get(), "number of ALU Reduction instructions"),
+      ADD_STAT(numInst_ALUC, statistics::units::Count::get(), "number of ALU Compaction instructions"),
+      ADD_STAT(numInst_ALUSC, statistics::units::Count::get(), "number of ALU Scan instructions"),
+      ADD_STAT(numInst_ALUH, statistics::units::Count::get(), "number of ALU Histogram instructions"),
+      ADD_STAT(numInst_ALUCV, statistics::units::Count::get(), "number of ALU Convert instructions"),
       ADD_STAT(numInst_INV, statistics::units::Count::get(), "number of Invalidation for instructions"),
       ADD_STAT(numInst, statistics::units::Count::get(), "total number of instructions"),
+      ADD_STAT(numInst_REPLAY, statistics::units::Count::get(), "number of instructions pushed from the loop replay buffer"),
+      ADD_STAT(numLoopIterations, statistics::units::Count::get(), "number of replayed loop iterations"),
       ADD_STAT(cycles_INDRD, statistics::units::Count::get(), "number of indirect read instruction cycles"),
       ADD_STAT(cycles_INDWR, statistics::units::Count::get(), "number of indirect write instruction cycles"),
       ADD_STAT(cycles_INDRMW, statistics::units::Count::get(), "number of indirect read-modify-write instruction cycles"),
@@ -784,6 +1060,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
       ADD_STAT(cycles_ALUS, statistics::units::Count::get(), "number of ALU Scalar instruction cycles"),
       ADD_STAT(cycles_ALUV, statistics::units::Count::get(), "number of ALU Vector instruction cycles"),
       ADD_STAT(cycles_ALUR, statistics::units::Count::get(), "number of ALU Reduction instruction cycles"),
+      ADD_STAT(cycles_ALUC, statistics::units::Count::get(), "number of ALU Compaction instruction cycles"),
+      ADD_STAT(cycles_ALUSC, statistics::units::Count::get(), "number of ALU Scan instruction cycles"),
+      ADD_STAT(cycles_ALUH, statistics::units::Count::get(), "number of ALU Histogram instruction cycles"),
+      ADD_STAT(cycles_ALUCV, statistics::units::Count::get(), "number of ALU Convert instruction cycles"),
       ADD_STAT(cycles_INV, statistics::units::Count::get(), "number of Invalidation for instruction cycles"),
       ADD_STAT(cycles_IDLE, statistics::units::Count::get(), "number of idle cycles"),
       ADD_STAT(cycles_BUSY, statistics::units::Count::get(), "number of busy cycles"),
@@ -798,6 +1078,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
       ADD_STAT(avgCPI_ALUS, statistics::units::Count::get(), "average CPI for ALU Scalar instructions"),
       ADD_STAT(avgCPI_ALUV, statistics::units::Count::get(), "average CPI for ALU Vector instructions"),
       ADD_STAT(avgCPI_ALUR, statistics::units::Count::get(), "average CPI for ALU Reduction instructions"),
+      ADD_STAT(avgCPI_ALUC, statistics::units::Count::get(), "average CPI for ALU Compaction instructions"),
+      ADD_STAT(avgCPI_ALUSC, statistics::units::Count::get(), "average CPI for ALU Scan instructions"),
+      ADD_STAT(avgCPI_ALUH, statistics::units::Count::get(), "average CPI for ALU Histogram instructions"),
+      ADD_STAT(avgCPI_ALUCV, statistics::units::Count::get(), "average CPI for ALU Convert instructions"),
       ADD_STAT(avgCPI_INV, statistics::units::Count::get(), "average CPI for Invalidation for instructions"),
       ADD_STAT(avgCPI, statistics::units::Count::get(), "average CPI for all instructions"),
       ADD_STAT(port_cache_WR_packets, statistics::units::Count::get(), "number of cache write packets"),
@@ -822,8 +1106,14 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
     numInst_ALUS.flags(statistics::nozero);
     numInst_ALUV.flags(statistics::nozero);
     numInst_ALUR.flags(statistics::nozero);
+    numInst_ALUC.flags(statistics::nozero);
+    numInst_ALUSC.flags(statistics::nozero);
+    numInst_ALUH.flags(statistics::nozero);
+    numInst_ALUCV.flags(statistics::nozero);
     numInst_INV.flags(statistics::nozero);
     numInst.flags(statistics::nozero);
+    numInst_REPLAY.flags(statistics::nozero);
+    numLoopIterations.flags(statistics::nozero);
     cycles_INDRD.flags(statistics::nozero);
     cycles_INDWR.flags(statistics::nozero);
     cycles_INDRMW.flags(statistics::nozero);
@@ -833,6 +1123,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
     cycles_ALUS.flags(statistics::nozero);
     cycles_ALUV.flags(statistics::nozero);
     cycles_ALUR.flags(statistics::nozero);
+    cycles_ALUC.flags(statistics::nozero);
+    cycles_ALUSC.flags(statistics::nozero);
+    cycles_ALUH.flags(statistics::nozero);
+    cycles_ALUCV.flags(statistics::nozero);
     cycles_INV.flags(statistics::nozero);
     cycles_IDLE.flags(statistics::nozero);
     cycles_TOTAL.flags(statistics::nozero);
@@ -852,6 +1146,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
     avgCPI_ALUS = cycles_ALUS / numInst_ALUS;
     avgCPI_ALUV = cycles_ALUV / numInst_ALUV;
     avgCPI_ALUR = cycles_ALUR / numInst_ALUR;
+    avgCPI_ALUC = cycles_ALUC / numInst_ALUC;
+    avgCPI_ALUSC = cycles_ALUSC / numInst_ALUSC;
+    avgCPI_ALUH = cycles_ALUH / numInst_ALUH;
+    avgCPI_ALUCV = cycles_ALUCV / numInst_ALUCV;
     avgCPI_INV = cycles_INV / numInst_INV;
     avgCPI = cycles_TOTAL / numInst;
     port_cache_packets = port_cache_WR_packets + port_cache_RD_packets;
@@ -873,6 +1171,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
     avgCPI_ALUS.flags(statistics::nonan | statistics::nozero);
     avgCPI_ALUV.flags(statistics::nonan | statistics::nozero);
     avgCPI_ALUR.flags(statistics::nonan | statistics::nozero);
+    avgCPI_ALUC.flags(statistics::nonan | statistics::nozero);
+    avgCPI_ALUSC.flags(statistics::nonan | statistics::nozero);
+    avgCPI_ALUH.flags(statistics::nonan | statistics::nozero);
+    avgCPI_ALUCV.flags(statistics::nonan | statistics::nozero);
     avgCPI_INV.flags(statistics::nonan | statistics::nozero);
     avgCPI.flags(statistics::nonan | statistics::nozero);
     port_cache_WR_BW.flags(statistics::nonan | statistics::nozero);
@@ -891,6 +1193,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         IND_NumUniqueCacheLineInserted.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumUniqueCacheLineInserted"), statistics::units::Count::get(), "number of unique cachelines inserted to the row table"));
         IND_NumUniqueRowsInserted.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumUniqueRowsInserted"), statistics::units::Count::get(), "number of unique rows inserted to the row table"));
         IND_NumRTFull.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumRTFull"), statistics::units::Count::get(), "number of row table full events"));
+        IND_NumRMWCombined.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumRMWCombined"), statistics::units::Count::get(), "number of RMW updates combined with a pending update to the same word"));
+        IND_NumCASFailed.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumCASFailed"), statistics::units::Count::get(), "number of compare-and-swaps that found an unexpected value"));
+        IND_NumSameBankRowSwitches.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumSameBankRowSwitches"), statistics::units::Count::get(), "number of row table rows sent right after another row of the same bank"));
+        IND_NumBankConflictsAvoided.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumBankConflictsAvoided"), statistics::units::Count::get(), "number of row table rows of the last sent bank skipped for a row of another bank"));
         IND_AvgWordsPerCacheLine.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgWordsPerCacheLine"), statistics::units::Count::get(), "average number of words per cacheline"));
         IND_AvgCacheLinesPerRow.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgCacheLinesPerRow"), statistics::units::Count::get(), "average number of cachelines per row"));
         IND_AvgRowsPerInst.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgRowsPerInst"), statistics::units::Count::get(), "average number of rows per indirect instruction"));
@@ -898,6 +1204,8 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         IND_AvgUniqueCacheLinesPerRow.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgUniqueCacheLinesPerRow"), statistics::units::Count::get(), "average number of unique cachelines per row"));
         IND_AvgUniqueRowsPerInst.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgUniqueRowsPerInst"), statistics::units::Count::get(), "average number of unique rows per indirect instruction"));
         IND_AvgRTFullsPerInst.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgRTFullsPerInst"), statistics::units::Count::get(), "average number of row table full events per indirect instruction"));
+        IND_NumRTReconfigs.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumRTReconfigs"), statistics::units::Count::get(), "number of row table geometry switches at drains by the row table policy"));
+        IND_NumRTDrainsAvoided.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_NumRTDrainsAvoided"), statistics::units::Count::get(), "estimated number of row table drains avoided by the geometry switches of the row table policy, negative if added"));
         IND_CyclesFill.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_CyclesFill"), statistics::units::Count::get(), "number of cycles in the FILL stage"));
         IND_CyclesBuild.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_CyclesBuild"), statistics::units::Count::get(), "number of cycles in the BUILD stage"));
         IND_CyclesRequest.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_CyclesRequest"), statistics::units::Count::get(), "number of cycles in the REQUEST stage"));
@@ -926,6 +1234,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         IND_AvgStoresMemAccessingPerInst.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgStoresMemAccessingPerInst"), statistics::units::Count::get(), "average number of writes accessed from memory per indirect instruction"));
         IND_Evicts.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_Evicts"), statistics::units::Count::get(), "number of evict accesses to the cache side port"));
         IND_AvgEvictssPerInst.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgEvictssPerInst"), statistics::units::Count::get(), "average number of evict accesses to the cache side port per indirect instruction"));
+        IND_TLBHits.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_TLBHits"), statistics::units::Count::get(), "number of TLB hits"));
+        IND_TLBMisses.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_TLBMisses"), statistics::units::Count::get(), "number of TLB misses"));
+        IND_CyclesTLBWalk.push_back(new statistics::Scalar(this, MAKE_INDIRECT_STAT_NAME("IND_CyclesTLBWalk"), statistics::units::Count::get(), "number of cycles from TLB misses until their page walks finish"));
+        IND_AvgCyclesTLBWalkPerMiss.push_back(new statistics::Formula(this, MAKE_INDIRECT_STAT_NAME("IND_AvgCyclesTLBWalkPerMiss"), statistics::units::Count::get(), "average number of cycles from a TLB miss until its page walk finishes"));
 
         (*IND_NumInsts[indirect_id]).flags(statistics::nozero);
         (*IND_NumWordsInserted[indirect_id]).flags(statistics::nozero);
@@ -935,6 +1247,12 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         (*IND_NumUniqueCacheLineInserted[indirect_id]).flags(statistics::nozero);
         (*IND_NumUniqueRowsInserted[indirect_id]).flags(statistics::nozero);
         (*IND_NumRTFull[indirect_id]).flags(statistics::nozero);
+        (*IND_NumRTReconfigs[indirect_id]).flags(statistics::nozero);
+        (*IND_NumRTDrainsAvoided[indirect_id]).flags(statistics::nozero);
+        (*IND_NumRMWCombined[indirect_id]).flags(statistics::nozero);
+        (*IND_NumCASFailed[indirect_id]).flags(statistics::nozero);
+        (*IND_NumSameBankRowSwitches[indirect_id]).flags(statistics::nozero);
+        (*IND_NumBankConflictsAvoided[indirect_id]).flags(statistics::nozero);
         (*IND_CyclesFill[indirect_id]).flags(statistics::nozero);
         (*IND_CyclesBuild[indirect_id]).flags(statistics::nozero);
         (*IND_CyclesRequest[indirect_id]).flags(statistics::nozero);
@@ -949,6 +1267,9 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         (*IND_LoadsMemAccessingLatency[indirect_id]).flags(statistics::nozero);
         (*IND_StoresMemAccessing[indirect_id]).flags(statistics::nozero);
         (*IND_Evicts[indirect_id]).flags(statistics::nozero);
+        (*IND_TLBHits[indirect_id]).flags(statistics::nozero);
+        (*IND_TLBMisses[indirect_id]).flags(statistics::nozero);
+        (*IND_CyclesTLBWalk[indirect_id]).flags(statistics::nozero);
 
         (*IND_AvgWordsPerCacheLine[indirect_id]) = (*IND_NumWordsInserted[indirect_id]) / (*IND_NumCacheLineInserted[indirect_id]);
         (*IND_AvgCacheLinesPerRow[indirect_id]) = (*IND_NumCacheLineInserted[indirect_id]) / (*IND_NumRowsInserted[indirect_id]);
@@ -974,6 +1295,7 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         (*IND_AvgLoadsMemAccessingLatency[indirect_id]) = (*IND_LoadsMemAccessingLatency[indirect_id]) / (*IND_LoadsMemAccessing[indirect_id]);
         (*IND_AvgStoresMemAccessingPerInst[indirect_id]) = (*IND_StoresMemAccessing[indirect_id]) / (*IND_NumInsts[indirect_id]);
         (*IND_AvgEvictssPerInst[indirect_id]) = (*IND_Evicts[indirect_id]) / (*IND_NumInsts[indirect_id]);
+        (*IND_AvgCyclesTLBWalkPerMiss[indirect_id]) = (*IND_CyclesTLBWalk[indirect_id]) / (*IND_TLBMisses[indirect_id]);
 
         (*IND_AvgWordsPerCacheLine[indirect_id]).flags(statistics::nozero | statistics::nonan);
         (*IND_AvgCacheLinesPerRow[indirect_id]).flags(statistics::nozero | statistics::nonan);
@@ -996,6 +1318,7 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         (*IND_AvgLoadsMemAccessingLatency[indirect_id]).flags(statistics::nozero | statistics::nonan);
         (*IND_AvgStoresMemAccessingPerInst[indirect_id]).flags(statistics::nozero | statistics::nonan);
         (*IND_AvgEvictssPerInst[indirect_id]).flags(statistics::nozero | statistics::nonan);
+        (*IND_AvgCyclesTLBWalkPerMiss[indirect_id]).flags(statistics::nozero | statistics::nonan);
     }
     for (int stream_id = 0; stream_id < num_maas; stream_id++) {
         STR_NumInsts.push_back(new statistics::Scalar(this, MAKE_STREAM_STAT_NAME("STR_NumInsts"), statistics::units::Count::get(), "number of instructions"));
@@ -1017,6 +1340,10 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         STR_AvgLoadsCacheAccessingPerInst.push_back(new statistics::Formula(this, MAKE_STREAM_STAT_NAME("STR_AvgLoadsCacheAccessingPerInst"), statistics::units::Count::get(), "average number of loads accessed from cache per stream instruction"));
         STR_Evicts.push_back(new statistics::Scalar(this, MAKE_STREAM_STAT_NAME("STR_Evicts"), statistics::units::Count::get(), "number of evict accesses to the cache side port"));
         STR_AvgEvictssPerInst.push_back(new statistics::Formula(this, MAKE_STREAM_STAT_NAME("STR_AvgEvictssPerInst"), statistics::units::Count::get(), "average number of evict accesses to the cache side port per stream instruction"));
+        STR_TLBHits.push_back(new statistics::Scalar(this, MAKE_STREAM_STAT_NAME("STR_TLBHits"), statistics::units::Count::get(), "number of TLB hits"));
+        STR_TLBMisses.push_back(new statistics::Scalar(this, MAKE_STREAM_STAT_NAME("STR_TLBMisses"), statistics::units::Count::get(), "number of TLB misses"));
+        STR_CyclesTLBWalk.push_back(new statistics::Scalar(this, MAKE_STREAM_STAT_NAME("STR_CyclesTLBWalk"), statistics::units::Count::get(), "number of cycles from TLB misses until their page walks finish"));
+        STR_AvgCyclesTLBWalkPerMiss.push_back(new statistics::Formula(this, MAKE_STREAM_STAT_NAME("STR_AvgCyclesTLBWalkPerMiss"), statistics::units::Count::get(), "average number of cycles from a TLB miss until its page walk finishes"));
 
         (*STR_NumInsts[stream_id]).flags(statistics::nozero);
         (*STR_NumWordsInserted[stream_id]).flags(statistics::nozero);
@@ -1028,6 +1355,9 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         (*STR_CyclesSPDWriteAccess[stream_id]).flags(statistics::nozero);
         (*STR_LoadsCacheAccessing[stream_id]).flags(statistics::nozero);
         (*STR_Evicts[stream_id]).flags(statistics::nozero);
+        (*STR_TLBHits[stream_id]).flags(statistics::nozero);
+        (*STR_TLBMisses[stream_id]).flags(statistics::nozero);
+        (*STR_CyclesTLBWalk[stream_id]).flags(statistics::nozero);
 
         (*STR_AvgWordsPerCacheLine[stream_id]) = (*STR_NumWordsInserted[stream_id]) / (*STR_NumCacheLineInserted[stream_id]);
         (*STR_AvgCacheLinesPerInst[stream_id]) = (*STR_NumCacheLineInserted[stream_id]) / (*STR_NumInsts[stream_id]);
@@ -1040,6 +1370,7 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
 
         (*STR_AvgLoadsCacheAccessingPerInst[stream_id]) = (*STR_LoadsCacheAccessing[stream_id]) / (*STR_NumInsts[stream_id]);
         (*STR_AvgEvictssPerInst[stream_id]) = (*STR_Evicts[stream_id]) / (*STR_NumInsts[stream_id]);
+        (*STR_AvgCyclesTLBWalkPerMiss[stream_id]) = (*STR_CyclesTLBWalk[stream_id]) / (*STR_TLBMisses[stream_id]);
 
         (*STR_AvgWordsPerCacheLine[stream_id]).flags(statistics::nozero | statistics::nonan);
         (*STR_AvgCacheLinesPerInst[stream_id]).flags(statistics::nozero | statistics::nonan);
@@ -1050,6 +1381,7 @@ MAA::MAAStats::MAAStats(statistics::Group *parent, int num_maas, MAA *_maa)
         (*STR_AvgCyclesSPDWriteAccessPerInst[stream_id]).flags(statistics::nozero | statistics::nonan);
         (*STR_AvgLoadsCacheAccessingPerInst[stream_id]).flags(statistics::nozero | statistics::nonan);
         (*STR_AvgEvictssPerInst[stream_id]).flags(statistics::nozero | statistics::nonan);
+        (*STR_AvgCyclesTLBWalkPerMiss[stream_id]).flags(statistics::nozero | statistics::nonan);
     }
     for (int range_id = 0; range_id < num_maas; range_id++) {
         RNG_NumInsts.push_back(new statistics::Scalar(this, MAKE_RANGE_STAT_NAME("RNG_NumInsts"), statistics::units::Count::get(), "number of instructions"));
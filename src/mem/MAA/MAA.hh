@@ -20,6 +20,8 @@
 #include "sim/clocked_object.hh"
 #include "sim/system.hh"
 #include "arch/generic/mmu.hh"
+#include "enums/MAADramAddrMapping.hh"
+#include "enums/MAARowTablePolicy.hh"
 
 #define ADDR_CHANNEL_LEVEL   0
 #define ADDR_RANK_LEVEL      1
@@ -31,6 +33,12 @@
 
 namespace gem5 {
 
+// DRAM coordinates of a physical address, indexed by the ADDR_*_LEVEL levels
+struct DramCoord {
+    int level[ADDR_MAX_LEVEL];
+    int operator[](int lvl) const { return level[lvl]; }
+};
+
 struct MAAParams;
 class IF;
 class RF;
@@ -283,12 +291,18 @@ public:
     int m_tx_offset;
     int m_col_bits_idx;
     int m_row_bits_idx;
+    // Decoder of map_addr precomputed in addRamulator, per level: the
+    // position and mask of its bits above m_tx_offset, and the position of
+    // the column bits XORed into it by hashed mappings
+    enums::MAADramAddrMapping m_addr_mapping;
+    int m_addr_shift[ADDR_MAX_LEVEL];
+    Addr m_addr_mask[ADDR_MAX_LEVEL];
+    int m_addr_xor_shift[ADDR_MAX_LEVEL];
 
 public:
-    std::vector<int> map_addr(Addr addr);
-    int channel_addr(Addr addr);
+    DramCoord map_addr(Addr addr) const;
+    int channel_addr(Addr addr) const;
     int core_addr(Addr addr);
-    Addr calc_Grow_addr(std::vector<int> addr_vec);
     void addRamulator(memory::Ramulator2 *_ramulator2);
     bool sendPacketMem(PacketPtr pkt);
     bool sendPacketCache(PacketPtr pkt);
@@ -386,17 +400,24 @@ public:
     unsigned int num_tile_elements;
     unsigned int num_regs;
     unsigned int num_instructions_per_core;
+    unsigned int num_loop_instructions_per_core;
     unsigned int num_instructions_per_maa;
     unsigned int num_instructions_total;
     unsigned int num_row_table_rows_per_slice;
     unsigned int num_row_table_entries_per_subslice_row;
     unsigned int num_row_table_config_cache_entries;
     bool reconfigure_row_table;
+    enums::MAARowTablePolicy row_table_policy;
     bool reorder_row_table;
+    bool combine_rmw;
     bool force_cache_access;
     unsigned int num_initial_row_table_slices;
     unsigned int num_request_table_addresses;
     unsigned int num_request_table_entries_per_address;
+    unsigned int num_tlb_entries;
+    unsigned int tlb_associativity;
+    Addr tlb_page_size;
+    Addr tlb_page_table_size;
     unsigned int num_memory_channels;
     unsigned int num_cores;
     unsigned int num_channels;
@@ -405,6 +426,7 @@ public:
     unsigned int m_core_addr_bits;
 
     Cycles rowtable_latency;
+    Cycles tlb_hit_latency;
     RequestorID requestorId;
 
     std::vector<AddrRegion> addrRegions;
@@ -451,7 +473,32 @@ protected:
     std::vector<PacketPtr> my_register_pkts;
     std::vector<int> my_ready_tile_ids;
     std::vector<InstructionPtr> my_instructions;
+    // Replay buffer of each core, holds the instructions between LOOP_BEGIN and LOOP_END
+    // The block is pushed once per iteration of REG[induction] from its value at LOOP_END
+    // up to REG[bound] in steps of REG[stride]. Odd iterations read the alternate induction
+    // register and rename the tiles written by the block by the alternate tile offset, so the
+    // next iteration does not wait for the tiles and registers of the current one to drain.
+    // Register writes of the core wait while its loop replays, and the ones received while it
+    // records are part of the body, so the body must not read them.
+    struct LoopBuffer {
+        bool recording;
+        bool replaying;
+        Instruction::DataType datatype;
+        int induction_reg, alt_induction_reg, bound_reg, stride_reg;
+        int alt_tile_offset;
+        int64_t induction, bound, stride;
+        int iteration;
+        int next_instruction;
+        std::vector<Instruction> instructions;
+        std::vector<bool> written_tiles;
+        std::vector<bool> written_regs;
+        PacketPtr end_pkt;
+    };
+    std::vector<LoopBuffer> my_loops;
     uint8_t getTileStatus(InstructionPtr instruction, int tile_id, bool is_dst);
+    bool pushInstruction(InstructionPtr instruction);
+    void recordLoopInstruction(InstructionPtr instruction, PacketPtr pkt);
+    void replayLoop(int core_id);
     void issueInstruction();
     void dispatchInstruction();
     void dispatchRegister();
@@ -463,6 +510,9 @@ protected:
     bool *aluUnitsIdle;
     bool *rangeUnitsIdle;
     bool invalidatorIdle;
+    // First function unit type and MAA instance tried by the next issue, rotated on every issue
+    int my_issue_func_unit_base;
+    int my_issue_maa_base;
     std::unique_ptr<Packet> pendingDelete;
 
 public:
@@ -488,8 +538,14 @@ public:
         statistics::Scalar numInst_ALUS;
         statistics::Scalar numInst_ALUV;
         statistics::Scalar numInst_ALUR;
+        statistics::Scalar numInst_ALUC;
+        statistics::Scalar numInst_ALUSC;
+        statistics::Scalar numInst_ALUH;
+        statistics::Scalar numInst_ALUCV;
         statistics::Scalar numInst_INV;
         statistics::Scalar numInst;
+        statistics::Scalar numInst_REPLAY;
+        statistics::Scalar numLoopIterations;
 
         /** Cycles of instructions. */
         statistics::Scalar cycles_INDRD;
@@ -501,6 +557,10 @@ public:
         statistics::Scalar cycles_ALUS;
         statistics::Scalar cycles_ALUV;
         statistics::Scalar cycles_ALUR;
+        statistics::Scalar cycles_ALUC;
+        statistics::Scalar cycles_ALUSC;
+        statistics::Scalar cycles_ALUH;
+        statistics::Scalar cycles_ALUCV;
         statistics::Scalar cycles_INV;
         statistics::Scalar cycles_IDLE;
         statistics::Formula cycles_BUSY;
@@ -517,6 +577,10 @@ public:
         statistics::Formula avgCPI_ALUS;
         statistics::Formula avgCPI_ALUV;
         statistics::Formula avgCPI_ALUR;
+        statistics::Formula avgCPI_ALUC;
+        statistics::Formula avgCPI_ALUSC;
+        statistics::Formula avgCPI_ALUH;
+        statistics::Formula avgCPI_ALUCV;
         statistics::Formula avgCPI_INV;
         statistics::Formula avgCPI;
 
@@ -543,6 +607,10 @@ public:
         std::vector<statistics::Scalar *> IND_NumUniqueCacheLineInserted;
         std::vector<statistics::Scalar *> IND_NumUniqueRowsInserted;
         std::vector<statistics::Scalar *> IND_NumRTFull;
+        std::vector<statistics::Scalar *> IND_NumRMWCombined;
+        std::vector<statistics::Scalar *> IND_NumCASFailed;
+        std::vector<statistics::Scalar *> IND_NumSameBankRowSwitches;
+        std::vector<statistics::Scalar *> IND_NumBankConflictsAvoided;
         std::vector<statistics::Formula *> IND_AvgWordsPerCacheLine;
         std::vector<statistics::Formula *> IND_AvgCacheLinesPerRow;
         std::vector<statistics::Formula *> IND_AvgRowsPerInst;
@@ -550,6 +618,8 @@ public:
         std::vector<statistics::Formula *> IND_AvgUniqueCacheLinesPerRow;
         std::vector<statistics::Formula *> IND_AvgUniqueRowsPerInst;
         std::vector<statistics::Formula *> IND_AvgRTFullsPerInst;
+        std::vector<statistics::Scalar *> IND_NumRTReconfigs;
+        std::vector<statistics::Scalar *> IND_NumRTDrainsAvoided;
 
         /** Indirect Unit -- Cycles of stages. */
         std::vector<statistics::Scalar *> IND_CyclesFill;
@@ -587,6 +657,12 @@ public:
         std::vector<statistics::Scalar *> IND_Evicts;
         std::vector<statistics::Formula *> IND_AvgEvictssPerInst;
 
+        /** Indirect Unit -- Address translation. */
+        std::vector<statistics::Scalar *> IND_TLBHits;
+        std::vector<statistics::Scalar *> IND_TLBMisses;
+        std::vector<statistics::Scalar *> IND_CyclesTLBWalk;
+        std::vector<statistics::Formula *> IND_AvgCyclesTLBWalkPerMiss;
+
         /** Stream Unit -- Row-Table Statistics. */
         std::vector<statistics::Scalar *> STR_NumInsts;
         std::vector<statistics::Scalar *> STR_NumWordsInserted;
@@ -614,6 +690,12 @@ public:
         std::vector<statistics::Scalar *> STR_Evicts;
         std::vector<statistics::Formula *> STR_AvgEvictssPerInst;
 
+        /** Stream Unit -- Address translation. */
+        std::vector<statistics::Scalar *> STR_TLBHits;
+        std::vector<statistics::Scalar *> STR_TLBMisses;
+        std::vector<statistics::Scalar *> STR_CyclesTLBWalk;
+        std::vector<statistics::Formula *> STR_AvgCyclesTLBWalkPerMiss;
+
         /** Range Fuser Unit -- Cycles of stages. */
         std::vector<statistics::Scalar *> RNG_NumInsts;
         std::vector<statistics::Scalar *> RNG_CyclesCompute;
@@ -652,6 +734,7 @@ protected:
             return std::hash<T1>{}(p.first) ^ (std::hash<T2>{}(p.second) << 1);
         }
     };
+    // One pooled record per outstanding address, holding all units coalesced on it
     class OutstandingPacket {
     public:
         PacketPtr packet;
@@ -660,40 +743,61 @@ protected:
         MemCmd cmd;
         bool cached;
         bool sent;
-        std::vector<uint8_t> maaIDs;
-        std::vector<FuncUnitType> funcUnits;
-        OutstandingPacket(PacketPtr _packet, Addr _paddr, Tick _tick, MemCmd _cmd)
-            : packet(_packet), paddr(_paddr), tick(_tick), cmd(_cmd), cached(false), sent(false) {}
-        OutstandingPacket() {}
-        OutstandingPacket(const OutstandingPacket &other) {
-            packet = other.packet;
-            paddr = other.paddr;
-            tick = other.tick;
-            cmd = other.cmd;
-            funcUnits = other.funcUnits;
-            maaIDs = other.maaIDs;
-            sent = other.sent;
-            cached = other.cached;
+        int num_units;
+        uint8_t *maaIDs;
+        FuncUnitType *funcUnits;
+        // Intrusive links of the send queue, next also links the free pool
+        OutstandingPacket *prev;
+        OutstandingPacket *next;
+        OutstandingPacket(int max_units) {
+            maaIDs = new uint8_t[max_units];
+            funcUnits = new FuncUnitType[max_units];
         }
-        bool operator<(const OutstandingPacket &rhs) const {
-            return tick < rhs.tick;
+        ~OutstandingPacket() {
+            delete[] maaIDs;
+            delete[] funcUnits;
         }
-        OutstandingPacket &operator=(const OutstandingPacket &other) = default;
-    };
-    struct CompareByTick {
-        bool operator()(const OutstandingPacket &lhs, const OutstandingPacket &rhs) const {
-            return lhs.tick < rhs.tick;
+        void init(PacketPtr _packet, Addr _paddr, Tick _tick, MemCmd _cmd) {
+            packet = _packet;
+            paddr = _paddr;
+            tick = _tick;
+            cmd = _cmd;
+            cached = false;
+            sent = false;
+            num_units = 0;
+            prev = nullptr;
+            next = nullptr;
+        }
+        void addUnit(uint8_t maaID, FuncUnitType funcUnit) {
+            maaIDs[num_units] = maaID;
+            funcUnits[num_units] = funcUnit;
+            num_units++;
         }
     };
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_indirect_cache_read_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_indirect_cache_write_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_indirect_mem_write_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_indirect_mem_read_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_stream_cache_read_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_stream_cache_write_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_stream_mem_write_pkts;
-    std::multiset<OutstandingPacket, CompareByTick> *my_outstanding_stream_mem_read_pkts;
-    std::unordered_map<Addr, OutstandingPacket> my_outstanding_pkt_map;
+    // Intrusive send queue ordered by tick, FIFO among the same ticks
+    class OutstandingPacketQueue {
+    public:
+        OutstandingPacket *head;
+        OutstandingPacket *tail;
+        OutstandingPacketQueue() : head(nullptr), tail(nullptr) {}
+        bool empty() const { return head == nullptr; }
+        OutstandingPacket *front() const { return head; }
+        void insert(OutstandingPacket *outstanding_pkt);
+        void pop_front();
+    };
+    OutstandingPacketQueue *my_outstanding_indirect_cache_read_pkts;
+    OutstandingPacketQueue *my_outstanding_indirect_cache_write_pkts;
+    OutstandingPacketQueue *my_outstanding_indirect_mem_write_pkts;
+    OutstandingPacketQueue *my_outstanding_indirect_mem_read_pkts;
+    OutstandingPacketQueue *my_outstanding_stream_cache_read_pkts;
+    OutstandingPacketQueue *my_outstanding_stream_cache_write_pkts;
+    OutstandingPacketQueue *my_outstanding_stream_mem_write_pkts;
+    OutstandingPacketQueue *my_outstanding_stream_mem_read_pkts;
+    std::unordered_map<Addr, OutstandingPacket *> my_outstanding_pkt_map;
+    std::vector<OutstandingPacket *> my_outstanding_pkt_pool;
+    OutstandingPacket *my_free_outstanding_pkts;
+    OutstandingPacket *allocateOutstandingPacket(PacketPtr packet, Addr paddr, Tick tick, MemCmd cmd);
+    void releaseOutstandingPacket(OutstandingPacket *outstanding_pkt);
     uint32_t *my_num_outstanding_indirect_pkts;
     uint32_t *my_num_outstanding_stream_pkts;
     bool allIndirectEmpty();
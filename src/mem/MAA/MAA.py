@@ -4,6 +4,15 @@ from m5.proxy import *
 from m5.objects.X86MMU import X86MMU
 from m5.SimObject import *
 
+class MAAIssuePolicy(Enum):
+    vals = ["OldestFirst", "CriticalPath", "RoundRobin"]
+
+class MAARowTablePolicy(Enum):
+    vals = ["History", "CLDensity", "HillClimb"]
+
+class MAADramAddrMapping(Enum):
+    vals = ["RoBaRaCoCh", "ChRaBaRoCo", "MOP4CLXOR"]
+
 class MAA(ClockedObject):
     type = "MAA"
     cxx_header = "mem/MAA/MAA.hh"
@@ -14,13 +23,20 @@ class MAA(ClockedObject):
     num_tile_elements = Param.Unsigned(16384, "Number of elements in each tile")
     num_regs_per_core = Param.Unsigned(8, "Number of 32-bit scalar registers per core attached to the DX100 instance")
     num_instructions_per_core = Param.Unsigned(8, "Number of instructions in the instruction file per core attached to the DX100 instance")
+    num_loop_instructions_per_core = Param.Unsigned(16, "Number of instructions in the loop replay buffer per core attached to the DX100 instance")
     num_row_table_rows_per_slice = Param.Unsigned(64, "Number of rows in each row table slice")
     num_row_table_entries_per_subslice_row = Param.Unsigned(8, "Number of row table entries (bursts) per each sub-slice of row table")
     num_row_table_config_cache_entries = Param.Unsigned(16, "Number of row table entry history in the configuration cache")
     num_request_table_addresses = Param.Unsigned(128, "Number of addresses in the request table")
-    num_request_table_entries_per_address = Param.Unsigned(16, "Number of entries in the request table per address")
+    num_request_table_entries_per_address = Param.Unsigned(16, "Number of entries in the request table per address, 32 are needed for 2-byte and 64 for 1-byte stream words")
+    num_tlb_entries = Param.Unsigned(0, "Number of TLB entries per stream and indirect unit, 0 models ideal address translation")
+    tlb_associativity = Param.Unsigned(4, "Associativity of the TLB of each stream and indirect unit")
+    tlb_page_size = Param.MemorySize("4KiB", "Page size backing the accessed data in the TLB model: 4KiB, 2MiB, or 1GiB")
+    tlb_page_table_size = Param.MemorySize("64MiB", "Size of the region at the top of physical memory holding the synthetic PTEs read by the TLB page walks")
     reconfigure_row_table = Param.Bool(False, "Reconfigure row table")
+    row_table_policy = Param.MAARowTablePolicy("History", "Row table geometry policy if reconfigure_row_table is set: the unique rows of the last instance of the base address, the fewest drains predicted from the CLs per row and rows per bank sampled between drains, or hill climbing on the fill throughput between drains")
     no_reorder = Param.Bool(False, "Do not reorder accesses using row table")
+    no_rmw_combine = Param.Bool(False, "Do not combine indirect RMW updates to the same word in the row table")
     force_cache_access = Param.Bool(False, "Force cache access instead of direct memory access for the indirect access unit")
     num_initial_row_table_slices = Param.Unsigned(32, "Number of initial row table slices if row table is not reconfigurable")
     spd_read_latency = Param.Cycles(1, "SPD read latency")
@@ -28,6 +44,7 @@ class MAA(ClockedObject):
     num_spd_read_ports_per_maa = Param.Unsigned(4, "Number of SPD read ports per DX100 instance")
     num_spd_write_ports_per_maa = Param.Unsigned(4, "Number of SPD write ports per DX100 instance")
     rowtable_latency = Param.Cycles(1, "Row table latency")
+    tlb_hit_latency = Param.Cycles(1, "TLB hit latency")
     ALU_lane_latency = Param.Cycles(1, "ALU lane latency")
     num_ALU_lanes = Param.Unsigned(16, "Number of ALU lanes")
     cache_snoop_latency = Param.Cycles(1, "Cache snoop latency")
@@ -36,6 +53,8 @@ class MAA(ClockedObject):
     num_memory_channels = Param.Unsigned(2, "Number of memory channels")
     num_cores = Param.Unsigned(4, "Number of cores")
     num_maas = Param.Unsigned(1, "Number of MAA instances")
+    issue_policy = Param.MAAIssuePolicy("OldestFirst", "Order in which ready instructions are issued to the function units: oldest first, most dependent tiles first, or round-robin over the instruction file")
+    dram_addr_mapping = Param.MAADramAddrMapping("RoBaRaCoCh", "DRAM address mapping used to decode channels, banks, and rows, must match the AddrMapper of Ramulator2")
 
 
     cpu_sides = VectorResponsePort("Vector port for connecting to the CPU and/or device")
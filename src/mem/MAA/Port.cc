@@ -26,35 +26,85 @@
 #define TRACING_ON 1
 #endif
 namespace gem5 {
+MAA::OutstandingPacket *MAA::allocateOutstandingPacket(PacketPtr packet, Addr paddr, Tick tick, MemCmd cmd) {
+    OutstandingPacket *outstanding_pkt = my_free_outstanding_pkts;
+    if (outstanding_pkt == nullptr) {
+        // Each (unit, maaID) pair can be coalesced at most once on a packet
+        outstanding_pkt = new OutstandingPacket(2 * num_maas);
+        my_outstanding_pkt_pool.push_back(outstanding_pkt);
+    } else {
+        my_free_outstanding_pkts = outstanding_pkt->next;
+    }
+    outstanding_pkt->init(packet, paddr, tick, cmd);
+    return outstanding_pkt;
+}
+void MAA::releaseOutstandingPacket(OutstandingPacket *outstanding_pkt) {
+    outstanding_pkt->prev = nullptr;
+    outstanding_pkt->next = my_free_outstanding_pkts;
+    my_free_outstanding_pkts = outstanding_pkt;
+}
+void MAA::OutstandingPacketQueue::insert(OutstandingPacket *outstanding_pkt) {
+    // Ticks are mostly increasing, so we look for the position from the tail
+    OutstandingPacket *prev_pkt = tail;
+    while (prev_pkt != nullptr && prev_pkt->tick > outstanding_pkt->tick) {
+        prev_pkt = prev_pkt->prev;
+    }
+    outstanding_pkt->prev = prev_pkt;
+    outstanding_pkt->next = (prev_pkt == nullptr) ? head : prev_pkt->next;
+    if (outstanding_pkt->next == nullptr) {
+        tail = outstanding_pkt;
+    } else {
+        outstanding_pkt->next->prev = outstanding_pkt;
+    }
+    if (prev_pkt == nullptr) {
+        head = outstanding_pkt;
+    } else {
+        prev_pkt->next = outstanding_pkt;
+    }
+}
+void MAA::OutstandingPacketQueue::pop_front() {
+    assert(head != nullptr);
+    OutstandingPacket *outstanding_pkt = head;
+    head = outstanding_pkt->next;
+    if (head == nullptr) {
+        tail = nullptr;
+    } else {
+        head->prev = nullptr;
+    }
+    outstanding_pkt->prev = nullptr;
+    outstanding_pkt->next = nullptr;
+}
 void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick tick, bool force_cache) {
     Addr paddr = pkt->req->getPaddr();
     panic_if(pkt->getAddr() != paddr, "%s: paddr 0x%lx and addr 0x%lx do not match for packet %s\n", __func__, paddr, pkt->getAddr(), pkt->print());
-    if (my_outstanding_pkt_map.find(paddr) != my_outstanding_pkt_map.end()) {
+    auto map_it = my_outstanding_pkt_map.find(paddr);
+    if (map_it != my_outstanding_pkt_map.end()) {
+        OutstandingPacket *outstanding_pkt = map_it->second;
         DPRINTF(MAAPort, "%s: found %s in outstanding packets\n", __func__, pkt->print());
-        if (my_outstanding_pkt_map[paddr].cmd == MemCmd::WritebackDirty && pkt->cmd == MemCmd::ReadExReq) {
-            DPRINTF(MAAPort, "%s: store to load forwarding for outstanding write packet %s and new read packet %s\n", __func__, my_outstanding_pkt_map[paddr].packet->print(), pkt->print());
-            panic_if(my_outstanding_pkt_map[paddr].maaIDs.size() != 1, "%s: multiple units on outstanding write packet %s\n", __func__, my_outstanding_pkt_map[paddr].packet->print());
-            panic_if(my_outstanding_pkt_map[paddr].funcUnits[0] != funcUnit || my_outstanding_pkt_map[paddr].maaIDs[0] != maaID, "%s: outstanding write maaID %d, funcUnit %s, packet %s do not match with new read maaID %d, funcUnit %s, packet %s\n", __func__, my_outstanding_pkt_map[paddr].maaIDs[0], func_unit_names[(uint8_t)my_outstanding_pkt_map[paddr].funcUnits[0]], my_outstanding_pkt_map[paddr].packet->print(), maaID, func_unit_names[(uint8_t)funcUnit], pkt->print());
+        if (outstanding_pkt->cmd == MemCmd::WritebackDirty && pkt->cmd == MemCmd::ReadExReq) {
+            DPRINTF(MAAPort, "%s: store to load forwarding for outstanding write packet %s and new read packet %s\n", __func__, outstanding_pkt->packet->print(), pkt->print());
+            panic_if(outstanding_pkt->num_units != 1, "%s: multiple units on outstanding write packet %s\n", __func__, outstanding_pkt->packet->print());
+            panic_if(outstanding_pkt->funcUnits[0] != funcUnit || outstanding_pkt->maaIDs[0] != maaID, "%s: outstanding write maaID %d, funcUnit %s, packet %s do not match with new read maaID %d, funcUnit %s, packet %s\n", __func__, outstanding_pkt->maaIDs[0], func_unit_names[(uint8_t)outstanding_pkt->funcUnits[0]], outstanding_pkt->packet->print(), maaID, func_unit_names[(uint8_t)funcUnit], pkt->print());
             if (funcUnit == FuncUnitType::INDIRECT) {
-                if (my_outstanding_pkt_map[paddr].cached) {
+                if (outstanding_pkt->cached) {
                     indirectAccessUnits[maaID].cacheReadPacketSent(paddr);
                 } else {
                     indirectAccessUnits[maaID].memReadPacketSent(paddr);
                 }
-                panic_if(indirectAccessUnits[maaID].recvData(paddr, my_outstanding_pkt_map[paddr].packet->getPtr<uint8_t>(), my_outstanding_pkt_map[paddr].cached) == false, "%s: received %s but rejected from indirectAccessUnits[%d]\n", __func__, my_outstanding_pkt_map[paddr].packet->print(), maaID);
+                panic_if(indirectAccessUnits[maaID].recvData(paddr, outstanding_pkt->packet->getPtr<uint8_t>(), outstanding_pkt->cached) == false, "%s: received %s but rejected from indirectAccessUnits[%d]\n", __func__, outstanding_pkt->packet->print(), maaID);
             } else if (funcUnit == FuncUnitType::STREAM) {
                 streamAccessUnits[maaID].readPacketSent(paddr);
-                panic_if(streamAccessUnits[maaID].recvData(paddr, my_outstanding_pkt_map[paddr].packet->getPtr<uint8_t>()) == false, "%s: received %s but rejected from streamAccessUnits[%d]\n", __func__, my_outstanding_pkt_map[paddr].packet->print(), maaID);
+                panic_if(streamAccessUnits[maaID].recvData(paddr, outstanding_pkt->packet->getPtr<uint8_t>()) == false, "%s: received %s but rejected from streamAccessUnits[%d]\n", __func__, outstanding_pkt->packet->print(), maaID);
             } else {
                 panic("Invalid func unit type\n");
             }
-        } else if (my_outstanding_pkt_map[paddr].cmd == MemCmd::WritebackDirty && pkt->cmd == MemCmd::WritebackDirty) {
-            DPRINTF(MAAPort, "%s: store to store replacement for outstanding write packet %s and new write packet %s\n", __func__, my_outstanding_pkt_map[paddr].packet->print(), pkt->print());
-            panic_if(my_outstanding_pkt_map[paddr].maaIDs.size() != 1, "%s: multiple units on outstanding write packet %s\n", __func__, my_outstanding_pkt_map[paddr].packet->print());
-            panic_if(my_outstanding_pkt_map[paddr].funcUnits[0] != funcUnit || my_outstanding_pkt_map[paddr].maaIDs[0] != maaID, "%s: outstanding write maaID %d, funcUnit %s, packet %s do not match with new write maaID %d, funcUnit %s, packet %s\n", __func__, my_outstanding_pkt_map[paddr].maaIDs[0], func_unit_names[(uint8_t)my_outstanding_pkt_map[paddr].funcUnits[0]], my_outstanding_pkt_map[paddr].packet->print(), maaID, func_unit_names[(uint8_t)funcUnit], pkt->print());
-            my_outstanding_pkt_map[paddr].packet->setData(pkt->getPtr<uint8_t>());
+        } else if (outstanding_pkt->cmd == MemCmd::WritebackDirty && pkt->cmd == MemCmd::WritebackDirty) {
+            DPRINTF(MAAPort, "%s: store to store replacement for outstanding write packet %s and new write packet %s\n", __func__, outstanding_pkt->packet->print(), pkt->print());
+            panic_if(outstanding_pkt->num_units != 1, "%s: multiple units on outstanding write packet %s\n", __func__, outstanding_pkt->packet->print());
+            panic_if(outstanding_pkt->funcUnits[0] != funcUnit || outstanding_pkt->maaIDs[0] != maaID, "%s: outstanding write maaID %d, funcUnit %s, packet %s do not match with new write maaID %d, funcUnit %s, packet %s\n", __func__, outstanding_pkt->maaIDs[0], func_unit_names[(uint8_t)outstanding_pkt->funcUnits[0]], outstanding_pkt->packet->print(), maaID, func_unit_names[(uint8_t)funcUnit], pkt->print());
+            outstanding_pkt->packet->setData(pkt->getPtr<uint8_t>());
             if (funcUnit == FuncUnitType::INDIRECT) {
-                if (my_outstanding_pkt_map[paddr].cached) {
+                if (outstanding_pkt->cached) {
                     indirectAccessUnits[maaID].cacheWritePacketSent(paddr);
                 } else {
                     indirectAccessUnits[maaID].memWritePacketSent(paddr);
@@ -65,18 +115,15 @@ void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick t
                 panic("Invalid func unit type\n");
             }
         } else {
-            panic_if(my_outstanding_pkt_map[paddr].cmd != pkt->cmd, "%s Outstanding command %s from packet %s does not match with command %s from packet %s\n", __func__, my_outstanding_pkt_map[paddr].cmd.toString(), my_outstanding_pkt_map[paddr].packet->print(), pkt->cmdString(), pkt->print());
-            panic_if(pkt->isWrite(), "%s cannot have duplicated writes %s and %s\n", __func__, my_outstanding_pkt_map[paddr].packet->print(), pkt->print());
+            panic_if(outstanding_pkt->cmd != pkt->cmd, "%s Outstanding command %s from packet %s does not match with command %s from packet %s\n", __func__, outstanding_pkt->cmd.toString(), outstanding_pkt->packet->print(), pkt->cmdString(), pkt->print());
+            panic_if(pkt->isWrite(), "%s cannot have duplicated writes %s and %s\n", __func__, outstanding_pkt->packet->print(), pkt->print());
             panic_if(pkt->isRead() == false, "%s: packet %s is not read!\n", __func__, pkt->print());
-            for (int i = 0; i < my_outstanding_pkt_map[paddr].maaIDs.size(); i++) {
-                panic_if(my_outstanding_pkt_map[paddr].maaIDs[i] == maaID && my_outstanding_pkt_map[paddr].funcUnits[i] == funcUnit, "%s: maaID %d and funcUnit %s already in the outstanding packet %s\n", __func__, maaID, func_unit_names[(uint8_t)funcUnit], pkt->print());
+            for (int i = 0; i < outstanding_pkt->num_units; i++) {
+                panic_if(outstanding_pkt->maaIDs[i] == maaID && outstanding_pkt->funcUnits[i] == funcUnit, "%s: maaID %d and funcUnit %s already in the outstanding packet %s\n", __func__, maaID, func_unit_names[(uint8_t)funcUnit], pkt->print());
             }
-            my_outstanding_pkt_map[paddr].maaIDs.push_back(maaID);
-            my_outstanding_pkt_map[paddr].funcUnits.push_back(funcUnit);
-            if (my_outstanding_pkt_map[paddr].sent == false) {
-                if (my_outstanding_pkt_map[paddr].tick < tick) {
-                    my_outstanding_pkt_map[paddr].tick = tick;
-                }
+            outstanding_pkt->addUnit(maaID, funcUnit);
+            if (outstanding_pkt->sent == false) {
+                // The packet keeps its position (tick) in the send queue
                 if (funcUnit == FuncUnitType::INDIRECT) {
                     my_num_outstanding_indirect_pkts[maaID]++;
                 } else if (funcUnit == FuncUnitType::STREAM) {
@@ -86,7 +133,7 @@ void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick t
                 }
             } else {
                 if (funcUnit == FuncUnitType::INDIRECT) {
-                    if (my_outstanding_pkt_map[paddr].cached) {
+                    if (outstanding_pkt->cached) {
                         indirectAccessUnits[maaID].cacheReadPacketSent(paddr);
                     } else {
                         indirectAccessUnits[maaID].memReadPacketSent(paddr);
@@ -99,7 +146,8 @@ void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick t
             }
         }
     } else {
-        my_outstanding_pkt_map[paddr] = OutstandingPacket(pkt, paddr, tick, pkt->cmd);
+        OutstandingPacket *outstanding_pkt = allocateOutstandingPacket(pkt, paddr, tick, pkt->cmd);
+        my_outstanding_pkt_map[paddr] = outstanding_pkt;
         bool hit_cache = true;
         if (force_cache_access == false && force_cache == false) {
             RequestPtr snoop_req = std::make_shared<Request>(pkt->req->getPaddr(), pkt->req->getSize(), pkt->req->getFlags(), pkt->req->requestorId());
@@ -111,30 +159,29 @@ void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick t
             DPRINTF(MAAPort, "%s: force_cache is false, snoop request for %s determined %s\n", __func__, pkt->print(), hit_cache ? "cached" : "not cached");
             delete snoop_pkt;
         }
-        my_outstanding_pkt_map[paddr].maaIDs.push_back(maaID);
-        my_outstanding_pkt_map[paddr].funcUnits.push_back(funcUnit);
+        outstanding_pkt->addUnit(maaID, funcUnit);
         int core_id = core_addr(paddr);
         int channel_id = channel_addr(paddr);
         if (funcUnit == FuncUnitType::INDIRECT) {
             my_num_outstanding_indirect_pkts[maaID]++;
             if (hit_cache) {
-                my_outstanding_pkt_map[paddr].cached = true;
+                outstanding_pkt->cached = true;
                 if (pkt->isRead()) {
-                    my_outstanding_indirect_cache_read_pkts[core_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_indirect_cache_read_pkts[core_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_indirect_cache_read_pkts[%s\n", __func__, core_id);
                 } else if (pkt->isWrite()) {
-                    my_outstanding_indirect_cache_write_pkts[core_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_indirect_cache_write_pkts[core_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_indirect_cache_write_pkts[%s\n", __func__, core_id);
                 } else {
                     panic("Invalid packet type\n");
                 }
             } else {
-                my_outstanding_pkt_map[paddr].cached = false;
+                outstanding_pkt->cached = false;
                 if (pkt->isRead()) {
-                    my_outstanding_indirect_mem_read_pkts[channel_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_indirect_mem_read_pkts[channel_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_indirect_mem_read_pkts[%s\n", __func__, channel_id);
                 } else if (pkt->isWrite()) {
-                    my_outstanding_indirect_mem_write_pkts[channel_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_indirect_mem_write_pkts[channel_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_indirect_mem_write_pkts[%s\n", __func__, channel_id);
                 } else {
                     panic("Invalid packet type\n");
@@ -142,23 +189,23 @@ void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick t
             }
         } else if (funcUnit == FuncUnitType::STREAM) {
             my_num_outstanding_stream_pkts[maaID]++;
-            my_outstanding_pkt_map[paddr].cached = true;
+            outstanding_pkt->cached = true;
             if (hit_cache) {
                 if (pkt->isRead()) {
-                    my_outstanding_stream_cache_read_pkts[core_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_stream_cache_read_pkts[core_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_stream_cache_read_pkts[%s\n", __func__, core_id);
                 } else if (pkt->isWrite()) {
-                    my_outstanding_stream_cache_write_pkts[core_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_stream_cache_write_pkts[core_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_stream_cache_write_pkts[%s\n", __func__, core_id);
                 } else {
                     panic("Invalid packet type\n");
                 }
             } else {
                 if (pkt->isRead()) {
-                    my_outstanding_stream_mem_read_pkts[core_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_stream_mem_read_pkts[core_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_stream_mem_read_pkts[%s\n", __func__, core_id);
                 } else if (pkt->isWrite()) {
-                    my_outstanding_stream_mem_write_pkts[core_id].insert(my_outstanding_pkt_map[paddr]);
+                    my_outstanding_stream_mem_write_pkts[core_id].insert(outstanding_pkt);
                     DPRINTF(MAAPort, "%s: inserting my_outstanding_stream_mem_write_pkts[%s\n", __func__, core_id);
                 } else {
                     panic("Invalid packet type\n");
@@ -167,7 +214,7 @@ void MAA::sendPacket(FuncUnitType funcUnit, uint8_t maaID, PacketPtr pkt, Tick t
         } else {
             panic("Invalid func unit type\n");
         }
-        if (my_outstanding_pkt_map[paddr].cached) {
+        if (outstanding_pkt->cached) {
             scheduleNextSendCache();
         } else {
             scheduleNextSendMem();
@@ -182,18 +229,18 @@ bool MAA::scheduleNextSendMem() {
             continue;
         if (my_outstanding_indirect_mem_read_pkts[ch].empty() == false) {
             if (return_val == false) {
-                tick = my_outstanding_indirect_mem_read_pkts[ch].begin()->tick;
+                tick = my_outstanding_indirect_mem_read_pkts[ch].front()->tick;
                 return_val = true;
             } else {
-                tick = std::min(tick, my_outstanding_indirect_mem_read_pkts[ch].begin()->tick);
+                tick = std::min(tick, my_outstanding_indirect_mem_read_pkts[ch].front()->tick);
             }
         }
         if (my_outstanding_indirect_mem_write_pkts[ch].empty() == false) {
             if (return_val == false) {
-                tick = my_outstanding_indirect_mem_write_pkts[ch].begin()->tick;
+                tick = my_outstanding_indirect_mem_write_pkts[ch].front()->tick;
                 return_val = true;
             } else {
-                tick = std::min(tick, my_outstanding_indirect_mem_write_pkts[ch].begin()->tick);
+                tick = std::min(tick, my_outstanding_indirect_mem_write_pkts[ch].front()->tick);
             }
         }
     }
@@ -224,51 +271,51 @@ bool MAA::scheduleNextSendCache() {
             continue;
         if (my_outstanding_indirect_cache_read_pkts[core_id].empty() == false) {
             if (return_val == false) {
-                tick = my_outstanding_indirect_cache_read_pkts[core_id].begin()->tick;
+                tick = my_outstanding_indirect_cache_read_pkts[core_id].front()->tick;
                 return_val = true;
             } else {
-                tick = std::min(tick, my_outstanding_indirect_cache_read_pkts[core_id].begin()->tick);
+                tick = std::min(tick, my_outstanding_indirect_cache_read_pkts[core_id].front()->tick);
             }
         }
         if (my_outstanding_indirect_cache_write_pkts[core_id].empty() == false) {
             if (return_val == false) {
-                tick = my_outstanding_indirect_cache_write_pkts[core_id].begin()->tick;
+                tick = my_outstanding_indirect_cache_write_pkts[core_id].front()->tick;
                 return_val = true;
             } else {
-                tick = std::min(tick, my_outstanding_indirect_cache_write_pkts[core_id].begin()->tick);
+                tick = std::min(tick, my_outstanding_indirect_cache_write_pkts[core_id].front()->tick);
             }
         }
         if (my_outstanding_stream_cache_read_pkts[core_id].empty() == false) {
             if (return_val == false) {
-                tick = my_outstanding_stream_cache_read_pkts[core_id].begin()->tick;
+                tick = my_outstanding_stream_cache_read_pkts[core_id].front()->tick;
                 return_val = true;
             } else {
-                tick = std::min(tick, my_outstanding_stream_cache_read_pkts[core_id].begin()->tick);
+                tick = std::min(tick, my_outstanding_stream_cache_read_pkts[core_id].front()->tick);
             }
         }
         if (my_outstanding_stream_cache_write_pkts[core_id].empty() == false) {
             if (return_val == false) {
-                tick = my_outstanding_stream_cache_write_pkts[core_id].begin()->tick;
+                tick = my_outstanding_stream_cache_write_pkts[core_id].front()->tick;
                 return_val = true;
             } else {
-                tick = std::min(tick, my_outstanding_stream_cache_write_pkts[core_id].begin()->tick);
+                tick = std::min(tick, my_outstanding_stream_cache_write_pkts[core_id].front()->tick);
             }
         }
         if (all_indirect_empty) {
             if (my_outstanding_stream_mem_read_pkts[core_id].empty() == false) {
                 if (return_val == false) {
-                    tick = my_outstanding_stream_mem_read_pkts[core_id].begin()->tick;
+                    tick = my_outstanding_stream_mem_read_pkts[core_id].front()->tick;
                     return_val = true;
                 } else {
-                    tick = std::min(tick, my_outstanding_stream_mem_read_pkts[core_id].begin()->tick);
+                    tick = std::min(tick, my_outstanding_stream_mem_read_pkts[core_id].front()->tick);
                 }
             }
             if (my_outstanding_stream_mem_write_pkts[core_id].empty() == false) {
                 if (return_val == false) {
-                    tick = my_outstanding_stream_mem_write_pkts[core_id].begin()->tick;
+                    tick = my_outstanding_stream_mem_write_pkts[core_id].front()->tick;
                     return_val = true;
                 } else {
-                    tick = std::min(tick, my_outstanding_stream_mem_write_pkts[core_id].begin()->tick);
+                    tick = std::min(tick, my_outstanding_stream_mem_write_pkts[core_id].front()->tick);
                 }
             }
         }
@@ -304,59 +351,59 @@ bool MAA::sendOutstandingMemPacket() {
     for (int ch = 0; ch < num_channels; ch++) {
         if (mem_channels_blocked[ch])
             continue;
-        for (auto it = my_outstanding_indirect_mem_write_pkts[ch].begin(); it != my_outstanding_indirect_mem_write_pkts[ch].end();) {
-            if (it->tick > curTick()) {
-                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to memory\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+        while (my_outstanding_indirect_mem_write_pkts[ch].empty() == false) {
+            OutstandingPacket *outstanding_pkt = my_outstanding_indirect_mem_write_pkts[ch].front();
+            if (outstanding_pkt->tick > curTick()) {
+                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to memory\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                 packet_remaining = true;
                 break;
             }
-            DPRINTF(MAAPort, "%s: trying sending %s to memory\n", __func__, it->packet->print());
-            if (sendPacketMem(it->packet) == false) {
+            DPRINTF(MAAPort, "%s: trying sending %s to memory\n", __func__, outstanding_pkt->packet->print());
+            if (sendPacketMem(outstanding_pkt->packet) == false) {
                 DPRINTF(MAAPort, "%s: send failed for channel %d\n", __func__, ch);
                 mem_channels_blocked[ch] = true;
                 break;
             } else {
-                Addr paddr = it->paddr;
-                panic_if(it->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, it->packet->print());
-                OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
+                Addr paddr = outstanding_pkt->paddr;
+                panic_if(outstanding_pkt->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, outstanding_pkt->packet->print());
                 my_outstanding_pkt_map.erase(paddr);
-                panic_if(tmp.maaIDs.size() != 1, "%s multiple write packes coalesced into one!\n", __func__);
-                panic_if(tmp.funcUnits[0] != FuncUnitType::INDIRECT, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)tmp.funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::INDIRECT]);
-                my_num_outstanding_indirect_pkts[tmp.maaIDs[0]]--;
-                indirectAccessUnits[tmp.maaIDs[0]].memWritePacketSent(it->paddr);
-                it = my_outstanding_indirect_mem_write_pkts[ch].erase(it);
+                panic_if(outstanding_pkt->num_units != 1, "%s multiple write packes coalesced into one!\n", __func__);
+                panic_if(outstanding_pkt->funcUnits[0] != FuncUnitType::INDIRECT, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)outstanding_pkt->funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::INDIRECT]);
+                my_num_outstanding_indirect_pkts[outstanding_pkt->maaIDs[0]]--;
+                indirectAccessUnits[outstanding_pkt->maaIDs[0]].memWritePacketSent(outstanding_pkt->paddr);
+                my_outstanding_indirect_mem_write_pkts[ch].pop_front();
+                releaseOutstandingPacket(outstanding_pkt);
                 stats.port_mem_WR_packets += 1;
             }
         }
         if (mem_channels_blocked[ch])
             continue;
-        for (auto it = my_outstanding_indirect_mem_read_pkts[ch].begin(); it != my_outstanding_indirect_mem_read_pkts[ch].end();) {
-            if (it->tick > curTick()) {
-                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to memory\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+        while (my_outstanding_indirect_mem_read_pkts[ch].empty() == false) {
+            OutstandingPacket *outstanding_pkt = my_outstanding_indirect_mem_read_pkts[ch].front();
+            if (outstanding_pkt->tick > curTick()) {
+                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to memory\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                 packet_remaining = true;
                 break;
             }
-            DPRINTF(MAAPort, "%s: trying sending %s to memory\n", __func__, it->packet->print());
-            if (sendPacketMem(it->packet) == false) {
+            DPRINTF(MAAPort, "%s: trying sending %s to memory\n", __func__, outstanding_pkt->packet->print());
+            if (sendPacketMem(outstanding_pkt->packet) == false) {
                 DPRINTF(MAAPort, "%s: send failed for channel %d\n", __func__, ch);
                 mem_channels_blocked[ch] = true;
                 break;
             } else {
-                Addr paddr = it->paddr;
-                OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
-                for (int i = 0; i < tmp.maaIDs.size(); i++) {
-                    if (tmp.funcUnits[i] == FuncUnitType::INDIRECT) {
-                        my_num_outstanding_indirect_pkts[tmp.maaIDs[i]]--;
-                        indirectAccessUnits[tmp.maaIDs[i]].memReadPacketSent(it->paddr);
-                    } else if (tmp.funcUnits[i] == FuncUnitType::STREAM) {
-                        my_num_outstanding_stream_pkts[tmp.maaIDs[i]]--;
-                        streamAccessUnits[tmp.maaIDs[i]].readPacketSent(it->paddr);
+                for (int i = 0; i < outstanding_pkt->num_units; i++) {
+                    if (outstanding_pkt->funcUnits[i] == FuncUnitType::INDIRECT) {
+                        my_num_outstanding_indirect_pkts[outstanding_pkt->maaIDs[i]]--;
+                        indirectAccessUnits[outstanding_pkt->maaIDs[i]].memReadPacketSent(outstanding_pkt->paddr);
+                    } else if (outstanding_pkt->funcUnits[i] == FuncUnitType::STREAM) {
+                        my_num_outstanding_stream_pkts[outstanding_pkt->maaIDs[i]]--;
+                        streamAccessUnits[outstanding_pkt->maaIDs[i]].readPacketSent(outstanding_pkt->paddr);
                     } else {
                         panic("Invalid func unit type\n");
                     }
                 }
-                my_outstanding_pkt_map[paddr].sent = true;
-                it = my_outstanding_indirect_mem_read_pkts[ch].erase(it);
+                outstanding_pkt->sent = true;
+                my_outstanding_indirect_mem_read_pkts[ch].pop_front();
                 stats.port_mem_RD_packets += 1;
             }
         }
@@ -378,176 +425,176 @@ bool MAA::sendOutstandingCachePacket() {
     for (int core = 0; core < num_cores; core++) {
         if (cache_bus_blocked[core])
             continue;
-        for (auto it = my_outstanding_indirect_cache_write_pkts[core].begin(); it != my_outstanding_indirect_cache_write_pkts[core].end();) {
-            if (it->tick > curTick()) {
-                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+        while (my_outstanding_indirect_cache_write_pkts[core].empty() == false) {
+            OutstandingPacket *outstanding_pkt = my_outstanding_indirect_cache_write_pkts[core].front();
+            if (outstanding_pkt->tick > curTick()) {
+                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                 packet_remaining = true;
                 break;
             }
-            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, it->packet->print());
-            if (sendPacketCache(it->packet) == false) {
+            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, outstanding_pkt->packet->print());
+            if (sendPacketCache(outstanding_pkt->packet) == false) {
                 DPRINTF(MAAPort, "%s: send failed for bus %d\n", __func__, core);
                 cache_bus_blocked[core] = true;
                 break;
             } else {
-                Addr paddr = it->paddr;
-                panic_if(it->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, it->packet->print());
-                OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
+                Addr paddr = outstanding_pkt->paddr;
+                panic_if(outstanding_pkt->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, outstanding_pkt->packet->print());
                 my_outstanding_pkt_map.erase(paddr);
-                panic_if(tmp.maaIDs.size() != 1, "%s multiple write packes coalesced into one!\n", __func__);
-                panic_if(tmp.funcUnits[0] != FuncUnitType::INDIRECT, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)tmp.funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::INDIRECT]);
-                my_num_outstanding_indirect_pkts[tmp.maaIDs[0]]--;
-                indirectAccessUnits[tmp.maaIDs[0]].cacheWritePacketSent(it->paddr);
-                it = my_outstanding_indirect_cache_write_pkts[core].erase(it);
+                panic_if(outstanding_pkt->num_units != 1, "%s multiple write packes coalesced into one!\n", __func__);
+                panic_if(outstanding_pkt->funcUnits[0] != FuncUnitType::INDIRECT, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)outstanding_pkt->funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::INDIRECT]);
+                my_num_outstanding_indirect_pkts[outstanding_pkt->maaIDs[0]]--;
+                indirectAccessUnits[outstanding_pkt->maaIDs[0]].cacheWritePacketSent(outstanding_pkt->paddr);
+                my_outstanding_indirect_cache_write_pkts[core].pop_front();
+                releaseOutstandingPacket(outstanding_pkt);
                 stats.port_cache_WR_packets += 1;
             }
         }
         if (cache_bus_blocked[core])
             continue;
-        for (auto it = my_outstanding_indirect_cache_read_pkts[core].begin(); it != my_outstanding_indirect_cache_read_pkts[core].end();) {
-            if (it->tick > curTick()) {
-                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+        while (my_outstanding_indirect_cache_read_pkts[core].empty() == false) {
+            OutstandingPacket *outstanding_pkt = my_outstanding_indirect_cache_read_pkts[core].front();
+            if (outstanding_pkt->tick > curTick()) {
+                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                 packet_remaining = true;
                 break;
             }
-            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, it->packet->print());
-            if (sendPacketCache(it->packet) == false) {
+            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, outstanding_pkt->packet->print());
+            if (sendPacketCache(outstanding_pkt->packet) == false) {
                 DPRINTF(MAAPort, "%s: send failed for bus %d\n", __func__, core);
                 cache_bus_blocked[core] = true;
                 break;
             } else {
-                Addr paddr = it->paddr;
-                OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
-                for (int i = 0; i < tmp.maaIDs.size(); i++) {
-                    if (tmp.funcUnits[i] == FuncUnitType::INDIRECT) {
-                        my_num_outstanding_indirect_pkts[tmp.maaIDs[i]]--;
-                        indirectAccessUnits[tmp.maaIDs[i]].cacheReadPacketSent(it->paddr);
-                    } else if (tmp.funcUnits[i] == FuncUnitType::STREAM) {
-                        my_num_outstanding_stream_pkts[tmp.maaIDs[i]]--;
-                        streamAccessUnits[tmp.maaIDs[i]].readPacketSent(it->paddr);
+                for (int i = 0; i < outstanding_pkt->num_units; i++) {
+                    if (outstanding_pkt->funcUnits[i] == FuncUnitType::INDIRECT) {
+                        my_num_outstanding_indirect_pkts[outstanding_pkt->maaIDs[i]]--;
+                        indirectAccessUnits[outstanding_pkt->maaIDs[i]].cacheReadPacketSent(outstanding_pkt->paddr);
+                    } else if (outstanding_pkt->funcUnits[i] == FuncUnitType::STREAM) {
+                        my_num_outstanding_stream_pkts[outstanding_pkt->maaIDs[i]]--;
+                        streamAccessUnits[outstanding_pkt->maaIDs[i]].readPacketSent(outstanding_pkt->paddr);
                     } else {
                         panic("Invalid func unit type\n");
                     }
                 }
-                my_outstanding_pkt_map[paddr].sent = true;
-                it = my_outstanding_indirect_cache_read_pkts[core].erase(it);
+                outstanding_pkt->sent = true;
+                my_outstanding_indirect_cache_read_pkts[core].pop_front();
                 stats.port_cache_RD_packets += 1;
             }
         }
         if (cache_bus_blocked[core])
             continue;
-        for (auto it = my_outstanding_stream_cache_write_pkts[core].begin(); it != my_outstanding_stream_cache_write_pkts[core].end();) {
-            if (it->tick > curTick()) {
-                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+        while (my_outstanding_stream_cache_write_pkts[core].empty() == false) {
+            OutstandingPacket *outstanding_pkt = my_outstanding_stream_cache_write_pkts[core].front();
+            if (outstanding_pkt->tick > curTick()) {
+                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                 packet_remaining = true;
                 break;
             }
-            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, it->packet->print());
-            if (sendPacketCache(it->packet) == false) {
+            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, outstanding_pkt->packet->print());
+            if (sendPacketCache(outstanding_pkt->packet) == false) {
                 DPRINTF(MAAPort, "%s: send failed for bus %d\n", __func__, core);
                 cache_bus_blocked[core] = true;
                 break;
             } else {
-                Addr paddr = it->paddr;
-                panic_if(it->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, it->packet->print());
-                OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
+                Addr paddr = outstanding_pkt->paddr;
+                panic_if(outstanding_pkt->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, outstanding_pkt->packet->print());
                 my_outstanding_pkt_map.erase(paddr);
-                panic_if(tmp.maaIDs.size() != 1, "%s multiple write packes coalesced into one!\n", __func__);
-                panic_if(tmp.funcUnits[0] != FuncUnitType::STREAM, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)tmp.funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::STREAM]);
-                my_num_outstanding_stream_pkts[tmp.maaIDs[0]]--;
-                streamAccessUnits[tmp.maaIDs[0]].writePacketSent(it->paddr);
-                it = my_outstanding_stream_cache_write_pkts[core].erase(it);
+                panic_if(outstanding_pkt->num_units != 1, "%s multiple write packes coalesced into one!\n", __func__);
+                panic_if(outstanding_pkt->funcUnits[0] != FuncUnitType::STREAM, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)outstanding_pkt->funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::STREAM]);
+                my_num_outstanding_stream_pkts[outstanding_pkt->maaIDs[0]]--;
+                streamAccessUnits[outstanding_pkt->maaIDs[0]].writePacketSent(outstanding_pkt->paddr);
+                my_outstanding_stream_cache_write_pkts[core].pop_front();
+                releaseOutstandingPacket(outstanding_pkt);
                 stats.port_cache_WR_packets += 1;
             }
         }
         if (cache_bus_blocked[core])
             continue;
-        for (auto it = my_outstanding_stream_cache_read_pkts[core].begin(); it != my_outstanding_stream_cache_read_pkts[core].end();) {
-            if (it->tick > curTick()) {
-                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+        while (my_outstanding_stream_cache_read_pkts[core].empty() == false) {
+            OutstandingPacket *outstanding_pkt = my_outstanding_stream_cache_read_pkts[core].front();
+            if (outstanding_pkt->tick > curTick()) {
+                DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                 packet_remaining = true;
                 break;
             }
-            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, it->packet->print());
-            if (sendPacketCache(it->packet) == false) {
+            DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, outstanding_pkt->packet->print());
+            if (sendPacketCache(outstanding_pkt->packet) == false) {
                 DPRINTF(MAAPort, "%s: send failed for bus %d\n", __func__, core);
                 cache_bus_blocked[core] = true;
                 break;
             } else {
-                Addr paddr = it->paddr;
-                OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
-                for (int i = 0; i < tmp.maaIDs.size(); i++) {
-                    if (tmp.funcUnits[i] == FuncUnitType::INDIRECT) {
-                        my_num_outstanding_indirect_pkts[tmp.maaIDs[i]]--;
-                        indirectAccessUnits[tmp.maaIDs[i]].cacheReadPacketSent(it->paddr);
-                    } else if (tmp.funcUnits[i] == FuncUnitType::STREAM) {
-                        my_num_outstanding_stream_pkts[tmp.maaIDs[i]]--;
-                        streamAccessUnits[tmp.maaIDs[i]].readPacketSent(it->paddr);
+                for (int i = 0; i < outstanding_pkt->num_units; i++) {
+                    if (outstanding_pkt->funcUnits[i] == FuncUnitType::INDIRECT) {
+                        my_num_outstanding_indirect_pkts[outstanding_pkt->maaIDs[i]]--;
+                        indirectAccessUnits[outstanding_pkt->maaIDs[i]].cacheReadPacketSent(outstanding_pkt->paddr);
+                    } else if (outstanding_pkt->funcUnits[i] == FuncUnitType::STREAM) {
+                        my_num_outstanding_stream_pkts[outstanding_pkt->maaIDs[i]]--;
+                        streamAccessUnits[outstanding_pkt->maaIDs[i]].readPacketSent(outstanding_pkt->paddr);
                     } else {
                         panic("Invalid func unit type\n");
                     }
                 }
-                my_outstanding_pkt_map[paddr].sent = true;
-                it = my_outstanding_stream_cache_read_pkts[core].erase(it);
+                outstanding_pkt->sent = true;
+                my_outstanding_stream_cache_read_pkts[core].pop_front();
                 stats.port_cache_RD_packets += 1;
             }
         }
         if (all_indirect_empty) {
             if (cache_bus_blocked[core])
                 continue;
-            for (auto it = my_outstanding_stream_mem_write_pkts[core].begin(); it != my_outstanding_stream_mem_write_pkts[core].end();) {
-                if (it->tick > curTick()) {
-                    DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+            while (my_outstanding_stream_mem_write_pkts[core].empty() == false) {
+                OutstandingPacket *outstanding_pkt = my_outstanding_stream_mem_write_pkts[core].front();
+                if (outstanding_pkt->tick > curTick()) {
+                    DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                     packet_remaining = true;
                     break;
                 }
-                DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, it->packet->print());
-                if (sendPacketCache(it->packet) == false) {
+                DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, outstanding_pkt->packet->print());
+                if (sendPacketCache(outstanding_pkt->packet) == false) {
                     DPRINTF(MAAPort, "%s: send failed for bus %d\n", __func__, core);
                     cache_bus_blocked[core] = true;
                     break;
                 } else {
-                    Addr paddr = it->paddr;
-                    panic_if(it->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, it->packet->print());
-                    OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
+                    Addr paddr = outstanding_pkt->paddr;
+                    panic_if(outstanding_pkt->packet->needsResponse(), "%s write packet %s needs response!\n", __func__, outstanding_pkt->packet->print());
                     my_outstanding_pkt_map.erase(paddr);
-                    panic_if(tmp.maaIDs.size() != 1, "%s multiple write packes coalesced into one!\n", __func__);
-                    panic_if(tmp.funcUnits[0] != FuncUnitType::STREAM, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)tmp.funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::STREAM]);
-                    my_num_outstanding_stream_pkts[tmp.maaIDs[0]]--;
-                    streamAccessUnits[tmp.maaIDs[0]].writePacketSent(it->paddr);
-                    it = my_outstanding_stream_mem_write_pkts[core].erase(it);
+                    panic_if(outstanding_pkt->num_units != 1, "%s multiple write packes coalesced into one!\n", __func__);
+                    panic_if(outstanding_pkt->funcUnits[0] != FuncUnitType::STREAM, "%s: func unit type %d does not match with %d\n", __func__, func_unit_names[(uint8_t)outstanding_pkt->funcUnits[0]], func_unit_names[(uint8_t)FuncUnitType::STREAM]);
+                    my_num_outstanding_stream_pkts[outstanding_pkt->maaIDs[0]]--;
+                    streamAccessUnits[outstanding_pkt->maaIDs[0]].writePacketSent(outstanding_pkt->paddr);
+                    my_outstanding_stream_mem_write_pkts[core].pop_front();
+                    releaseOutstandingPacket(outstanding_pkt);
                     stats.port_cache_WR_packets += 1;
                 }
             }
             if (cache_bus_blocked[core])
                 continue;
-            for (auto it = my_outstanding_stream_mem_read_pkts[core].begin(); it != my_outstanding_stream_mem_read_pkts[core].end();) {
-                if (it->tick > curTick()) {
-                    DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(it->tick - curTick()), it->packet->print());
+            while (my_outstanding_stream_mem_read_pkts[core].empty() == false) {
+                OutstandingPacket *outstanding_pkt = my_outstanding_stream_mem_read_pkts[core].front();
+                if (outstanding_pkt->tick > curTick()) {
+                    DPRINTF(MAAPort, "%s: waiting for %d cycles to send %s to cache\n", __func__, getTicksToCycles(outstanding_pkt->tick - curTick()), outstanding_pkt->packet->print());
                     packet_remaining = true;
                     break;
                 }
-                DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, it->packet->print());
-                if (sendPacketCache(it->packet) == false) {
+                DPRINTF(MAAPort, "%s: trying sending %s to cache\n", __func__, outstanding_pkt->packet->print());
+                if (sendPacketCache(outstanding_pkt->packet) == false) {
                     DPRINTF(MAAPort, "%s: send failed for bus %d\n", __func__, core);
                     cache_bus_blocked[core] = true;
                     break;
                 } else {
-                    Addr paddr = it->paddr;
-                    OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
-                    for (int i = 0; i < tmp.maaIDs.size(); i++) {
-                        if (tmp.funcUnits[i] == FuncUnitType::INDIRECT) {
-                            my_num_outstanding_indirect_pkts[tmp.maaIDs[i]]--;
-                            indirectAccessUnits[tmp.maaIDs[i]].cacheReadPacketSent(it->paddr);
-                        } else if (tmp.funcUnits[i] == FuncUnitType::STREAM) {
-                            my_num_outstanding_stream_pkts[tmp.maaIDs[i]]--;
-                            streamAccessUnits[tmp.maaIDs[i]].readPacketSent(it->paddr);
+                    for (int i = 0; i < outstanding_pkt->num_units; i++) {
+                        if (outstanding_pkt->funcUnits[i] == FuncUnitType::INDIRECT) {
+                            my_num_outstanding_indirect_pkts[outstanding_pkt->maaIDs[i]]--;
+                            indirectAccessUnits[outstanding_pkt->maaIDs[i]].cacheReadPacketSent(outstanding_pkt->paddr);
+                        } else if (outstanding_pkt->funcUnits[i] == FuncUnitType::STREAM) {
+                            my_num_outstanding_stream_pkts[outstanding_pkt->maaIDs[i]]--;
+                            streamAccessUnits[outstanding_pkt->maaIDs[i]].readPacketSent(outstanding_pkt->paddr);
                         } else {
                             panic("Invalid func unit type\n");
                         }
                     }
-                    my_outstanding_pkt_map[paddr].sent = true;
-                    it = my_outstanding_stream_mem_read_pkts[core].erase(it);
+                    outstanding_pkt->sent = true;
+                    my_outstanding_stream_mem_read_pkts[core].pop_front();
                     stats.port_cache_RD_packets += 1;
                 }
             }
@@ -564,20 +611,23 @@ void MAA::recvTimingResp(PacketPtr pkt, bool cached) {
     panic_if(pkt->cmd.toInt() != MemCmd::ReadExResp && pkt->cmd.toInt() != MemCmd::ReadResp, "%s received an unknown response: %s\n", __func__, pkt->print());
     assert(pkt->getSize() == 64);
     Addr paddr = pkt->req->getPaddr();
-    panic_if(my_outstanding_pkt_map.find(paddr) == my_outstanding_pkt_map.end(), "%s: response for packet %s not found in my_outstanding_pkt_map\n", __func__, pkt->print());
-    OutstandingPacket tmp = my_outstanding_pkt_map[paddr];
-    panic_if(tmp.sent == false, "%s received response %s for an unsent packet!\n", pkt->cmdString(), pkt->getSize());
-    panic_if(cached != tmp.cached, "%s: response %s cached %d does not match with outstanding packet cached %d\n", __func__, pkt->print(), cached, tmp.cached);
-    my_outstanding_pkt_map.erase(paddr);
-    for (int i = 0; i < tmp.maaIDs.size(); i++) {
-        if (tmp.funcUnits[i] == FuncUnitType::INDIRECT) {
-            panic_if(indirectAccessUnits[tmp.maaIDs[i]].recvData(pkt->getAddr(), pkt->getPtr<uint8_t>(), tmp.cached) == false, "%s: received %s but rejected from indirectAccessUnits[%d]\n", __func__, pkt->print(), tmp.maaIDs[i]);
-        } else if (tmp.funcUnits[i] == FuncUnitType::STREAM) {
-            panic_if(streamAccessUnits[tmp.maaIDs[i]].recvData(pkt->getAddr(), pkt->getPtr<uint8_t>()) == false, "%s: received %s but rejected from streamAccessUnits[%d]\n", __func__, pkt->print(), tmp.maaIDs[i]);
+    auto map_it = my_outstanding_pkt_map.find(paddr);
+    panic_if(map_it == my_outstanding_pkt_map.end(), "%s: response for packet %s not found in my_outstanding_pkt_map\n", __func__, pkt->print());
+    OutstandingPacket *outstanding_pkt = map_it->second;
+    panic_if(outstanding_pkt->sent == false, "%s received response %s for an unsent packet!\n", pkt->cmdString(), pkt->getSize());
+    panic_if(cached != outstanding_pkt->cached, "%s: response %s cached %d does not match with outstanding packet cached %d\n", __func__, pkt->print(), cached, outstanding_pkt->cached);
+    my_outstanding_pkt_map.erase(map_it);
+    for (int i = 0; i < outstanding_pkt->num_units; i++) {
+        if (outstanding_pkt->funcUnits[i] == FuncUnitType::INDIRECT) {
+            panic_if(indirectAccessUnits[outstanding_pkt->maaIDs[i]].recvData(pkt->getAddr(), pkt->getPtr<uint8_t>(), outstanding_pkt->cached) == false, "%s: received %s but rejected from indirectAccessUnits[%d]\n", __func__, pkt->print(), outstanding_pkt->maaIDs[i]);
+        } else if (outstanding_pkt->funcUnits[i] == FuncUnitType::STREAM) {
+            panic_if(streamAccessUnits[outstanding_pkt->maaIDs[i]].recvData(pkt->getAddr(), pkt->getPtr<uint8_t>()) == false, "%s: received %s but rejected from streamAccessUnits[%d]\n", __func__, pkt->print(), outstanding_pkt->maaIDs[i]);
         } else {
             panic("Invalid func unit type\n");
         }
     }
+    // Released after the loop, recvData may allocate new outstanding packets
+    releaseOutstandingPacket(outstanding_pkt);
 }
 void MAA::scheduleSendCacheEvent(int latency) {
     DPRINTF(MAAPort, "%s: scheduling send cache packet in the next %d cycles!\n", __func__, latency);
@@ -87,6 +87,7 @@ void RangeFuserUnit::executeInstruction() {
         my_min_tile = my_instruction->src1SpdID;
         my_max_tile = my_instruction->src2SpdID;
         my_last_i = maa->rf->getData<int>(my_instruction->dst1RegID);
+        my_ready_end = my_last_i;
         my_last_j = maa->rf->getData<int>(my_instruction->dst2RegID);
         my_stride = maa->rf->getData<int>(my_instruction->src1RegID);
         my_max_i = -1;
@@ -171,19 +172,31 @@ void RangeFuserUnit::executeInstruction() {
             //     DPRINTF(MAARangeFuser, "R[%d] %s: my_last_i (%d) >= num_tile_elements (%d), finished!\n", __func__, my_last_i, num_tile_elements);
             //     break;
             // }
-            bool cond_ready = my_cond_tile == -1 || maa->spd->getElementFinished(my_cond_tile, my_last_i, 4, (uint8_t)FuncUnitType::RANGE, my_range_id);
-            bool min_ready = cond_ready && maa->spd->getElementFinished(my_min_tile, my_last_i, 4, (uint8_t)FuncUnitType::RANGE, my_range_id);
-            bool max_ready = min_ready && maa->spd->getElementFinished(my_max_tile, my_last_i, 4, (uint8_t)FuncUnitType::RANGE, my_range_id);
-            if (cond_ready == false) {
-                DPRINTF(MAARangeFuser, "R[%d] %s: cond tile[%d] element[%d] not ready, returning!\n", my_range_id, __func__, my_cond_tile, my_last_i);
-            } else if (min_ready == false) {
-                DPRINTF(MAARangeFuser, "R[%d] %s: min tile[%d] element[%d] not ready, returning!\n", my_range_id, __func__, my_min_tile, my_last_i);
-            } else if (max_ready == false) {
-                DPRINTF(MAARangeFuser, "R[%d] %s: max tile[%d] element[%d] not ready, returning!\n", my_range_id, __func__, my_max_tile, my_last_i);
+            if (my_last_i >= my_ready_end) {
+                // Finding the run of ready elements starting from my_last_i
+                my_ready_end = my_max_i == -1 ? num_tile_elements : my_max_i;
+                if (my_cond_tile != -1) {
+                    my_ready_end = maa->spd->getFirstUnfinished(my_cond_tile, my_last_i, my_ready_end, 4);
+                }
+                my_ready_end = maa->spd->getFirstUnfinished(my_min_tile, my_last_i, my_ready_end, 4);
+                my_ready_end = maa->spd->getFirstUnfinished(my_max_tile, my_last_i, my_ready_end, 4);
             }
-            if (cond_ready == false || min_ready == false || max_ready == false) {
-                updateLatency(num_spd_read_accesses, num_spd_write_accesses, num_computed_words);
-                return;
+            if (my_last_i >= my_ready_end) {
+                // Registering for the callback of the first tile that is not ready
+                bool cond_ready = my_cond_tile == -1 || maa->spd->getElementFinished(my_cond_tile, my_last_i, 4, (uint8_t)FuncUnitType::RANGE, my_range_id);
+                bool min_ready = cond_ready && maa->spd->getElementFinished(my_min_tile, my_last_i, 4, (uint8_t)FuncUnitType::RANGE, my_range_id);
+                bool max_ready = min_ready && maa->spd->getElementFinished(my_max_tile, my_last_i, 4, (uint8_t)FuncUnitType::RANGE, my_range_id);
+                if (cond_ready == false) {
+                    DPRINTF(MAARangeFuser, "R[%d] %s: cond tile[%d] element[%d] not ready, returning!\n", my_range_id, __func__, my_cond_tile, my_last_i);
+                } else if (min_ready == false) {
+                    DPRINTF(MAARangeFuser, "R[%d] %s: min tile[%d] element[%d] not ready, returning!\n", my_range_id, __func__, my_min_tile, my_last_i);
+                } else if (max_ready == false) {
+                    DPRINTF(MAARangeFuser, "R[%d] %s: max tile[%d] element[%d] not ready, returning!\n", my_range_id, __func__, my_max_tile, my_last_i);
+                }
+                if (cond_ready == false || min_ready == false || max_ready == false) {
+                    updateLatency(num_spd_read_accesses, num_spd_write_accesses, num_computed_words);
+                    return;
+                }
             }
             if (my_cond_tile != -1) {
                 num_spd_read_accesses++;
@@ -197,12 +210,19 @@ void RangeFuserUnit::executeInstruction() {
                 uint32_t my_max_j = maa->spd->getData<uint32_t>(my_max_tile, my_last_i);
                 num_spd_read_accesses++;
                 num_computed_words++;
+                int start_idx_j = my_idx_j;
+                int *dst_i_data = (int *)maa->spd->getTileDataPtr(my_dst_i_tile, 4);
+                int *dst_j_data = (int *)maa->spd->getTileDataPtr(my_dst_j_tile, 4);
                 for (; my_last_j < my_max_j && my_idx_j < num_tile_elements; my_last_j += my_stride, my_idx_j++) {
-                    maa->spd->setData(my_dst_i_tile, my_idx_j, my_last_i);
-                    maa->spd->setData(my_dst_j_tile, my_idx_j, my_last_j);
-                    num_spd_write_accesses++;
+                    dst_i_data[my_idx_j] = my_last_i;
+                    dst_j_data[my_idx_j] = my_last_j;
                     DPRINTF(MAARangeFuser, "R[%d] %s: [%d-%d-%d][%d-%d-%d] inserted!\n", my_range_id, __func__, 0, my_last_i, my_max_i, my_min_j, my_last_j, my_max_j);
                 }
+                if (my_idx_j > start_idx_j) {
+                    maa->spd->setElementsFinished(my_dst_i_tile, start_idx_j, my_idx_j, 4);
+                    maa->spd->setElementsFinished(my_dst_j_tile, start_idx_j, my_idx_j, 4);
+                    num_spd_write_accesses += my_idx_j - start_idx_j;
+                }
                 if (my_last_j >= my_max_j) {
                     my_last_j = -1;
                 } else if (my_idx_j == num_tile_elements) {
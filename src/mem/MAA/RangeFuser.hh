@@ -51,6 +51,7 @@ protected:
     bool my_cond_tile_ready, my_min_tile_ready, my_max_tile_ready;
     int my_last_i, my_last_j, my_stride;
     int my_max_i, my_idx_j;
+    int my_ready_end;
     unsigned int num_tile_elements;
     Tick my_SPD_read_finish_tick;
     Tick my_SPD_write_finish_tick;
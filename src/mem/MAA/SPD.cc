@@ -6,10 +6,13 @@
 #include "mem/MAA/ALU.hh"
 #include "mem/MAA/RangeFuser.hh"
 #include "mem/MAA/IndirectAccess.hh"
+#include "base/bitfield.hh"
 #include "base/types.hh"
 #include "debug/SPD.hh"
 #include "sim/cur_tick.hh"
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cstring>
 
 #ifndef TRACING_ON
@@ -68,7 +71,6 @@ Cycles SPD::setDataLatency(int tile_id, int num_accesses) {
              "Scheduled write at %lu, but current tick is %lu!\n",
              write_port_busy_until[min_busy_port], curTick());
     DPRINTF(SPD, "%s: write_port_busy_until[%d] = %lu\n", __func__, min_busy_port, write_port_busy_until[min_busy_port]);
-    wakeup_waiting_units(tile_id);
     return maa->getTicksToCycles(write_port_busy_until[min_busy_port] - curTick());
 }
 SPD::TileStatus SPD::getTileStatus(int tile_id) {
@@ -81,9 +83,9 @@ void SPD::setTileIdle(int tile_id, int word_size) {
     if (word_size == 8) {
         tiles_status[tile_id + 1] = SPD::TileStatus::Idle;
     }
-    for (int i = 0; i < num_tile_elements * word_size / 4; i++) {
-        element_finished[tile_id * num_tile_elements + i] = false;
-    }
+    // Clearing every byte of the tile, sub-word elements may leave stale bits behind
+    int first_bit = getElementBit(tile_id, 0, word_size);
+    setElementsFinishedBits(first_bit, first_bit + num_tile_elements * std::max(word_size, 4), 1, false);
 }
 void SPD::setTileFinished(int tile_id, int word_size) {
     check_tile_id(tile_id, sizeof(uint32_t));
@@ -143,47 +145,139 @@ bool SPD::getElementFinished(int tile_id, int element_id, int word_size, uint8_t
     if (element_id >= num_tile_elements) {
         is_element_finished = false;
     } else {
-        int tile_element_id = tile_id * num_tile_elements + element_id * word_size / 4;
-        is_element_finished = element_finished[tile_element_id];
+        int tile_element_id = getElementBit(tile_id, element_id, word_size);
+        is_element_finished = isElementFinished(tile_element_id);
     }
-    if (is_element_finished == false &&
-        (std::find(waiting_units_ids[tile_id].begin(), waiting_units_ids[tile_id].end(), id) == waiting_units_ids[tile_id].end() ||
-         std::find(waiting_units_funcs[tile_id].begin(), waiting_units_funcs[tile_id].end(), func) == waiting_units_funcs[tile_id].end())) {
-        DPRINTF(SPD, "%s: adding %s[%d] to waiting list tile[%d]\n", __func__, func_unit_names[func], id, tile_id);
-        waiting_units_funcs[tile_id].push_back(func);
-        waiting_units_ids[tile_id].push_back(id);
+    if (is_element_finished == false) {
+        subscribe(tile_id, element_id, word_size, func, id);
     }
     return is_element_finished;
 }
-void SPD::wakeup_waiting_units(int tile_id) {
-    for (int i = 0; i < waiting_units_funcs[tile_id].size(); i++) {
-        int waiting_units_id = waiting_units_ids[tile_id][i];
-        switch (waiting_units_funcs[tile_id][i]) {
-        case (uint8_t)FuncUnitType::ALU: {
-            assert(maa->aluUnits[waiting_units_id].getState() == ALUUnit::Status::Work);
-            maa->aluUnits[waiting_units_id].scheduleNextExecution(true);
-            break;
-        }
-        case (uint8_t)FuncUnitType::STREAM: {
-            assert(maa->streamAccessUnits[waiting_units_id].getState() == StreamAccessUnit::Status::Request);
-            maa->streamAccessUnits[waiting_units_id].scheduleNextExecution(true);
+void SPD::subscribe(int tile_id, int element_id, int word_size, uint8_t func, int id) {
+    check_tile_id(tile_id, sizeof(uint32_t));
+    // Elements beyond the tile are never finished, wait for the tile to become ready
+    int tile_element_id = element_id >= num_tile_elements ? INT_MAX : getElementBit(tile_id, element_id, word_size);
+    // A unit keeps a single subscription per tile, at its earliest watermark
+    bool found = false;
+    for (auto &subscription : tiles_subscriptions[tile_id]) {
+        if (subscription.func == func && subscription.id == id) {
+            subscription.tile_element_id = std::min(subscription.tile_element_id, tile_element_id);
+            found = true;
             break;
         }
-        case (uint8_t)FuncUnitType::INDIRECT: {
-            assert(maa->indirectAccessUnits[waiting_units_id].getState() == IndirectAccessUnit::Status::Fill ||
-                   maa->indirectAccessUnits[waiting_units_id].getState() == IndirectAccessUnit::Status::Request);
-            maa->indirectAccessUnits[waiting_units_id].scheduleNextExecution(true);
-            break;
+    }
+    if (found == false) {
+        tiles_subscriptions[tile_id].push_back({func, id, tile_element_id});
+    }
+    tiles_min_subscription[tile_id] = std::min(tiles_min_subscription[tile_id], tile_element_id);
+    DPRINTF(SPD, "%s: %s[%d] subscribed to tile[%d] element[%d]\n", __func__, func_unit_names[func], id, tile_id, element_id);
+}
+uint64_t SPD::getElementsMask(int word, int first_bit, int last_bit, int word_size) const {
+    // Elements are tracked by every word_size-th bit, starting from first_bit
+    uint64_t mask = word_size == 1   ? ~((uint64_t)0)
+                    : word_size == 2 ? 0x5555555555555555
+                    : word_size == 4 ? 0x1111111111111111
+                                     : 0x0101010101010101;
+    mask <<= first_bit & (word_size - 1);
+    if (word == (first_bit >> 6)) {
+        mask &= ~((uint64_t)0) << (first_bit & 63);
+    }
+    if (word == ((last_bit - 1) >> 6)) {
+        mask &= ~((uint64_t)0) >> (63 - ((last_bit - 1) & 63));
+    }
+    return mask;
+}
+void SPD::setElementsFinishedBits(int first_bit, int last_bit, int word_size, bool finished) {
+    if (first_bit >= last_bit) {
+        return;
+    }
+    for (int word = first_bit >> 6; word <= ((last_bit - 1) >> 6); word++) {
+        uint64_t mask = getElementsMask(word, first_bit, last_bit, word_size);
+        if (finished) {
+            element_finished[word] |= mask;
+        } else {
+            element_finished[word] &= ~mask;
         }
-        case (uint8_t)FuncUnitType::RANGE: {
-            assert(maa->rangeUnits[waiting_units_id].getState() == RangeFuserUnit::Status::Work);
-            maa->rangeUnits[waiting_units_id].scheduleNextExecution(true);
-            break;
+    }
+}
+void SPD::setElementsFinished(int tile_id, int start_element_id, int end_element_id, int word_size) {
+    check_tile_element_range(tile_id, start_element_id, end_element_id - start_element_id, word_size);
+    int first_bit = getElementBit(tile_id, start_element_id, word_size);
+    int last_bit = getElementBit(tile_id, end_element_id, word_size);
+    setElementsFinishedBits(first_bit, last_bit, word_size, true);
+    DPRINTF(SPD, "%s: tile[%d] elements[%d-%d) finished\n", __func__, tile_id, start_element_id, end_element_id);
+    checkSubscriptions(tile_id, last_bit);
+}
+int SPD::getFirstUnfinished(int tile_id, int start_element_id, int end_element_id, int word_size) {
+    check_tile_id(tile_id, word_size);
+    // Elements beyond the tile are never finished
+    if (end_element_id > num_tile_elements) {
+        end_element_id = num_tile_elements;
+    }
+    if (start_element_id >= end_element_id) {
+        return start_element_id;
+    }
+    int tile_first_bit = getElementBit(tile_id, 0, word_size);
+    int first_bit = tile_first_bit + start_element_id * word_size;
+    int last_bit = tile_first_bit + end_element_id * word_size;
+    for (int word = first_bit >> 6; word <= ((last_bit - 1) >> 6); word++) {
+        uint64_t unfinished = ~element_finished[word] & getElementsMask(word, first_bit, last_bit, word_size);
+        if (unfinished != 0) {
+            return ((word << 6) + ctz64(unfinished) - tile_first_bit) / word_size;
         }
+    }
+    return end_element_id;
+}
+void SPD::wakeupUnit(uint8_t func, int id) {
+    switch (func) {
+    case (uint8_t)FuncUnitType::ALU: {
+        assert(maa->aluUnits[id].getState() == ALUUnit::Status::Work);
+        maa->aluUnits[id].scheduleNextExecution(true);
+        break;
+    }
+    case (uint8_t)FuncUnitType::STREAM: {
+        assert(maa->streamAccessUnits[id].getState() == StreamAccessUnit::Status::Request);
+        maa->streamAccessUnits[id].scheduleNextExecution(true);
+        break;
+    }
+    case (uint8_t)FuncUnitType::INDIRECT: {
+        assert(maa->indirectAccessUnits[id].getState() == IndirectAccessUnit::Status::Fill ||
+               maa->indirectAccessUnits[id].getState() == IndirectAccessUnit::Status::Request);
+        maa->indirectAccessUnits[id].scheduleNextExecution(true);
+        break;
+    }
+    case (uint8_t)FuncUnitType::RANGE: {
+        assert(maa->rangeUnits[id].getState() == RangeFuserUnit::Status::Work);
+        maa->rangeUnits[id].scheduleNextExecution(true);
+        break;
+    }
+    }
+}
+void SPD::wakeupFinishedSubscriptions(int tile_id) {
+    // Wakes the units whose element has finished and keeps the rest in order
+    std::vector<Subscription> &subscriptions = tiles_subscriptions[tile_id];
+    int min_subscription = INT_MAX;
+    int num_remaining = 0;
+    for (int i = 0; i < subscriptions.size(); i++) {
+        int tile_element_id = subscriptions[i].tile_element_id;
+        if (tile_element_id != INT_MAX && isElementFinished(tile_element_id)) {
+            DPRINTF(SPD, "%s: waking up %s[%d] for tile[%d] tile_element[%d]\n", __func__, func_unit_names[subscriptions[i].func], subscriptions[i].id, tile_id, tile_element_id);
+            wakeupUnit(subscriptions[i].func, subscriptions[i].id);
+        } else {
+            subscriptions[num_remaining++] = subscriptions[i];
+            min_subscription = std::min(min_subscription, tile_element_id);
         }
     }
-    waiting_units_funcs[tile_id].clear();
-    waiting_units_ids[tile_id].clear();
+    subscriptions.resize(num_remaining);
+    tiles_min_subscription[tile_id] = min_subscription;
+}
+void SPD::wakeup_waiting_units(int tile_id) {
+    for (const auto &subscription : tiles_subscriptions[tile_id]) {
+        DPRINTF(SPD, "%s: waking up %s[%d] for tile[%d]\n", __func__, func_unit_names[subscription.func], subscription.id, tile_id);
+        wakeupUnit(subscription.func, subscription.id);
+    }
+    tiles_subscriptions[tile_id].clear();
+    tiles_min_subscription[tile_id] = INT_MAX;
 }
 uint16_t SPD::getSize(int tile_id) {
     check_tile_id(tile_id, sizeof(uint32_t));
@@ -222,12 +316,16 @@ SPD::SPD(MAA *_maa,
         tiles_dirty[i] = false;
         tiles_ready[i] = 0;
     }
-    element_finished = new bool[num_tiles * num_tile_elements];
-    for (int i = 0; i < num_tiles * num_tile_elements; i++) {
-        element_finished[i] = true;
+    num_element_finished_words = getCeiling(num_tiles * num_tile_elements * 4, 64);
+    element_finished = new uint64_t[num_element_finished_words];
+    for (int i = 0; i < num_element_finished_words; i++) {
+        element_finished[i] = ~((uint64_t)0);
+    }
+    tiles_subscriptions = new std::vector<Subscription>[num_tiles];
+    tiles_min_subscription = new int[num_tiles];
+    for (int i = 0; i < num_tiles; i++) {
+        tiles_min_subscription[i] = INT_MAX;
     }
-    waiting_units_funcs = new std::vector<uint8_t>[num_tiles];
-    waiting_units_ids = new std::vector<int>[num_tiles];
     memset(tiles_data, 0, num_tiles * num_tile_elements * sizeof(uint32_t));
     read_port_busy_until = new Tick[num_read_ports];
     write_port_busy_until = new Tick[num_write_ports];
@@ -251,6 +349,10 @@ SPD::~SPD() {
     delete[] write_port_busy_until;
     assert(element_finished != nullptr);
     delete[] element_finished;
+    assert(tiles_subscriptions != nullptr);
+    delete[] tiles_subscriptions;
+    assert(tiles_min_subscription != nullptr);
+    delete[] tiles_min_subscription;
 }
 
 ///////////////
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
@@ -32,9 +33,20 @@ protected:
     bool *tiles_dirty;
     uint8_t *tiles_ready;
     uint16_t *tiles_size;
-    bool *element_finished;
-    std::vector<uint8_t> *waiting_units_funcs;
-    std::vector<int> *waiting_units_ids;
+    // Bitmap of finished tile bytes, an element is tracked by its first byte so
+    // that packed 1- and 2-byte elements sharing a 4-byte slot finish separately
+    uint64_t *element_finished;
+    int num_element_finished_words;
+    // A unit waiting for the tile element at tile_element_id to finish, or
+    // for the tile to become ready when the element is beyond the tile
+    struct Subscription {
+        uint8_t func;
+        int id;
+        int tile_element_id;
+    };
+    std::vector<Subscription> *tiles_subscriptions;
+    // Smallest subscribed tile_element_id of each tile, INT_MAX if none
+    int *tiles_min_subscription;
     unsigned int num_tiles;
     unsigned int num_tile_elements;
     Tick *read_port_busy_until;
@@ -43,44 +55,108 @@ protected:
     const int num_read_ports, num_write_ports;
     MAA *maa;
 
+    int getElementBit(int tile_id, int element_id, int word_size) const {
+        return tile_id * num_tile_elements * 4 + element_id * word_size;
+    }
+    bool isElementFinished(int tile_element_id) const {
+        return (element_finished[tile_element_id >> 6] >> (tile_element_id & 63)) & 1;
+    }
+    void setElementFinished(int tile_element_id) {
+        element_finished[tile_element_id >> 6] |= (uint64_t)1 << (tile_element_id & 63);
+    }
+    uint64_t getElementsMask(int word, int first_bit, int last_bit, int word_size) const;
+    void setElementsFinishedBits(int first_bit, int last_bit, int word_size, bool finished);
+    void wakeupUnit(uint8_t func, int id);
+    void wakeupFinishedSubscriptions(int tile_id);
+    void checkSubscriptions(int tile_id, int last_bit) {
+        if (tiles_min_subscription[tile_id] < last_bit) {
+            wakeupFinishedSubscriptions(tile_id);
+        }
+    }
+
 public:
     void check_tile_id(int tile_id, int word_size) {
         panic_if(tile_id < 0 || tile_id >= num_tiles, "Invalid tile_id: %d\n", tile_id);
-        panic_if(word_size != 4 && word_size != 8, "Invalid data type size: %d\n", word_size);
+        panic_if(word_size != 1 && word_size != 2 && word_size != 4 && word_size != 8, "Invalid data type size: %d\n", word_size);
         panic_if(word_size == 8 && tile_id >= num_tiles - 1, "Invalid tile_id for 8-byte data type: %d\n", tile_id);
     }
     void check_tile_element_id(int tile_id, int element_id, int word_size) {
         check_tile_id(tile_id, word_size);
         panic_if(element_id < 0 || element_id >= num_tile_elements, "Invalid element_id: %d\n", element_id);
     }
+    void check_tile_element_range(int tile_id, int element_id, int num_elements, int word_size) {
+        check_tile_id(tile_id, word_size);
+        panic_if(element_id < 0 || num_elements < 0 || element_id + num_elements > num_tile_elements, "Invalid element range: [%d-%d)\n", element_id, element_id + num_elements);
+    }
     template <typename T>
     T getData(int tile_id, int element_id) {
         check_tile_element_id(tile_id, element_id, sizeof(T));
         return *((T *)(tiles_data + tile_id * num_tile_elements * 4 + element_id * sizeof(T)));
     }
+    template <typename T>
+    void getData(int tile_id, int element_id, int num_elements, T *_data) {
+        check_tile_element_range(tile_id, element_id, num_elements, sizeof(T));
+        std::memcpy(_data, tiles_data + tile_id * num_tile_elements * 4 + element_id * sizeof(T), num_elements * sizeof(T));
+    }
     uint8_t *getDataPtr(int tile_id, int element_id) {
         check_tile_element_id(tile_id, element_id, sizeof(uint32_t));
         return (uint8_t *)(tiles_data + tile_id * num_tile_elements * 4 + element_id * 4);
     }
+    uint8_t *getTileDataPtr(int tile_id, int word_size) {
+        check_tile_id(tile_id, word_size);
+        return (uint8_t *)(tiles_data + tile_id * num_tile_elements * 4);
+    }
     template <typename T>
     void setData(int tile_id, int element_id, T _data) {
         check_tile_element_id(tile_id, element_id, sizeof(T));
         *((T *)(tiles_data + tile_id * num_tile_elements * 4 + element_id * sizeof(T))) = _data;
-        int tile_element_id = tile_id * num_tile_elements + element_id * sizeof(T) / 4;
-        element_finished[tile_element_id] = true;
+        int tile_element_id = getElementBit(tile_id, element_id, sizeof(T));
+        setElementFinished(tile_element_id);
+        DPRINTF(SPD, "%s: tile[%d] element[%d] tile_element[%d] finished\n", __func__, tile_id, element_id, tile_element_id);
+        checkSubscriptions(tile_id, tile_element_id + 1);
+    }
+    template <typename T>
+    void setData(int tile_id, int element_id, int num_elements, const T *_data) {
+        check_tile_element_range(tile_id, element_id, num_elements, sizeof(T));
+        std::memcpy(tiles_data + tile_id * num_tile_elements * 4 + element_id * sizeof(T), _data, num_elements * sizeof(T));
+        setElementsFinished(tile_id, element_id, element_id + num_elements, sizeof(T));
+    }
+    // Untyped accesses to a single element, for units that only move words
+    void getWord(int tile_id, int element_id, int word_size, uint8_t *_data) {
+        check_tile_element_id(tile_id, element_id, word_size);
+        std::memcpy(_data, tiles_data + tile_id * num_tile_elements * 4 + element_id * word_size, word_size);
+    }
+    void setWord(int tile_id, int element_id, int word_size, const uint8_t *_data) {
+        check_tile_element_id(tile_id, element_id, word_size);
+        std::memcpy(tiles_data + tile_id * num_tile_elements * 4 + element_id * word_size, _data, word_size);
+        int tile_element_id = getElementBit(tile_id, element_id, word_size);
+        setElementFinished(tile_element_id);
         DPRINTF(SPD, "%s: tile[%d] element[%d] tile_element[%d] finished\n", __func__, tile_id, element_id, tile_element_id);
+        checkSubscriptions(tile_id, tile_element_id + 1);
+    }
+    // Bitmap elements share a byte, so writing a bit does not finish it. The
+    // producer finishes the bytes once all of their bits are written
+    void setBit(int tile_id, int element_id, bool _data) {
+        check_tile_element_id(tile_id, element_id >> 3, 1);
+        uint8_t *byte = tiles_data + tile_id * num_tile_elements * 4 + (element_id >> 3);
+        uint8_t mask = 1 << (element_id & 7);
+        *byte = _data ? (*byte | mask) : (*byte & ~mask);
     }
+    void setElementsFinished(int tile_id, int start_element_id, int end_element_id, int word_size);
+    int getFirstUnfinished(int tile_id, int start_element_id, int end_element_id, int word_size);
     void setFakeData(int tile_id, int element_id, int word_size) {
         check_tile_element_id(tile_id, element_id, word_size);
-        int tile_element_id = tile_id * num_tile_elements + element_id * word_size / 4;
-        element_finished[tile_element_id] = true;
+        int tile_element_id = getElementBit(tile_id, element_id, word_size);
+        setElementFinished(tile_element_id);
         DPRINTF(SPD, "%s: tile[%d] element[%d] tile_element[%d] fake finished\n", __func__, tile_id, element_id, tile_element_id);
+        checkSubscriptions(tile_id, tile_element_id + 1);
     }
     void wakeup_waiting_units(int tile_id);
     Cycles getDataLatency(int num_accesses);
     Cycles setDataLatency(int tile_id, int num_accesses);
     TileStatus getTileStatus(int tile_id);
     bool getElementFinished(int tile_id, int element_id, int word_size, uint8_t func, int id);
+    void subscribe(int tile_id, int element_id, int word_size, uint8_t func, int id);
     void setTileIdle(int tile_id, int word_size);
     void setTileService(int tile_id, int word_size);
     void setTileFinished(int tile_id, int word_size);
@@ -124,7 +200,7 @@ public:
     template <typename T>
     void check_reg_id(int reg_id) {
         panic_if(reg_id < 0 || reg_id >= num_regs, "Invalid reg_id: %d\n", reg_id);
-        panic_if(sizeof(T) != 4 && sizeof(T) != 8, "Invalid data type size: %d\n", sizeof(T));
+        panic_if(sizeof(T) != 1 && sizeof(T) != 2 && sizeof(T) != 4 && sizeof(T) != 8, "Invalid data type size: %d\n", sizeof(T));
         panic_if(sizeof(T) == 8 && reg_id >= num_regs - 1, "Invalid reg_id for 8-byte data type: %d\n", reg_id);
     }
     template <typename T>
@@ -34,6 +34,7 @@ void StreamAccessUnit::allocate(int _my_stream_id, unsigned int _num_request_tab
     maa = _maa;
     dst_tile_id = -1;
     request_table = new RequestTable(maa, num_request_table_addresses, num_request_table_entries_per_address, my_stream_id, true);
+    my_TLB.allocate(maa->num_tlb_entries, maa->tlb_associativity, maa->tlb_page_size, maa->tlb_hit_latency, maa->tlb_page_table_size, FuncUnitType::STREAM, my_stream_id, maa);
     my_translation_done = false;
     my_instruction = nullptr;
 }
@@ -90,6 +91,21 @@ StreamAccessUnit::PageInfo StreamAccessUnit::getPageInfo(int i, Addr base_addr,
     Addr word_vaddr = base_addr + word_size * i;
     Addr block_vaddr = addrBlockAligner(word_vaddr, block_size);
     Addr block_paddr = translatePacket(block_vaddr);
+    if (my_TLB.isEnabled()) {
+        // The TLB is looked up once per page, the request stage waits for the walks of the
+        // missed pages and reuses the page translations. A page that is already being walked
+        // counts as a hit
+        Tick ready_tick;
+        TranslationBuffer::Lookup result = my_TLB.lookup(block_vaddr, ready_tick);
+        if (result == TranslationBuffer::Lookup::Miss) {
+            (*maa->stats.STR_TLBMisses[my_stream_id])++;
+        } else {
+            (*maa->stats.STR_TLBHits[my_stream_id])++;
+            if (result == TranslationBuffer::Lookup::Hit) {
+                my_translation_finish_tick = std::max(my_translation_finish_tick, ready_tick);
+            }
+        }
+    }
     Addr word_paddr = block_paddr + (word_vaddr - block_vaddr);
     Addr page_paddr = addrBlockAligner(block_paddr, page_size);
     assert(word_paddr >= page_paddr);
@@ -101,7 +117,7 @@ StreamAccessUnit::PageInfo StreamAccessUnit::getPageInfo(int i, Addr base_addr,
     int min_idx = min_itr == min ? 0 : ((int)((min_itr - min - 1) / stride)) + 1;
     // We find the minimum itr based on the minimum idx which is stride aligned
     min_itr = min_idx * stride + min;
-    std::vector<int> addr_vec = maa->map_addr(page_paddr);
+    DramCoord addr_vec = maa->map_addr(page_paddr);
     Addr gbg_addr = getGBGAddr(addr_vec[ADDR_CHANNEL_LEVEL], addr_vec[ADDR_RANK_LEVEL], addr_vec[ADDR_BANKGROUP_LEVEL]);
     DPRINTF(MAAStream, "S[%d] %s: word[%d] wordPaddr[0x%lx] blockPaddr[0x%lx] pagePaddr[0x%lx] minItr[%d] minIdx[%d] GBG[%d]\n", my_stream_id, __func__, i, word_paddr, block_paddr, page_paddr, min_itr, min_idx, gbg_addr);
     return StreamAccessUnit::PageInfo(min_itr, min_idx, gbg_addr);
@@ -136,6 +152,7 @@ void StreamAccessUnit::executeInstruction() {
         DPRINTF(MAAStream, "S[%d] %s: decoding %s!\n", my_stream_id, __func__, my_instruction->print());
 
         // Decoding the instruction
+        my_translation_memo.reset();
         my_base_addr = my_instruction->baseAddr;
         my_dst_tile = my_instruction->dst1SpdID;
         my_src_tile = my_instruction->src1SpdID;
@@ -154,6 +171,12 @@ void StreamAccessUnit::executeInstruction() {
         }
         my_words_per_cl = block_size / my_word_size;
         my_words_per_page = page_size / my_word_size;
+        // Every word of a line is a separate request table entry of the line
+        panic_if(getCeiling(my_words_per_cl, my_stride) > (int)num_request_table_entries_per_address,
+                 "S[%d] %s: %d-byte words with stride %d need %d request table entries per address, but only %d are configured! "
+                 "Raise num_request_table_entries_per_address (--maa_num_request_table_entries_per_address) to at least %d for 1- and 2-byte streams.\n",
+                 my_stream_id, __func__, my_word_size, my_stride, getCeiling(my_words_per_cl, my_stride), num_request_table_entries_per_address,
+                 getCeiling(my_words_per_cl, my_stride));
         (*maa->stats.STR_NumInsts[my_stream_id])++;
         if (my_instruction->opcode == Instruction::OpcodeType::STREAM_LD) {
             my_is_load = true;
@@ -166,6 +189,7 @@ void StreamAccessUnit::executeInstruction() {
         }
         maa->stats.numInst++;
         std::vector<PageInfo> all_page_info;
+        my_translation_finish_tick = curTick();
         for (int i = my_min; i < my_max; i += my_words_per_page) {
             StreamAccessUnit::PageInfo page_info = getPageInfo(i, my_base_addr, my_word_size, my_min, my_stride);
             if (page_info.curr_idx >= maa->num_tile_elements) {
@@ -198,12 +222,16 @@ void StreamAccessUnit::executeInstruction() {
         // Setting the state of the instruction and stream unit
         my_instruction->state = Instruction::Status::Service;
         state = Status::Request;
-        scheduleExecuteInstructionEvent(Cycles(my_all_page_info.size() * 2));
+        Cycles decode_latency = Cycles(my_all_page_info.size() * 2);
+        if (my_translation_finish_tick > maa->getClockEdge(decode_latency)) {
+            decode_latency = maa->getTicksToCycles(my_translation_finish_tick - curTick());
+        }
+        scheduleExecuteInstructionEvent(decode_latency);
         break;
     }
     case Status::Request: {
         DPRINTF(MAAStream, "S[%d] %s: requesting %s!\n", my_stream_id, __func__, my_instruction->print());
-        if (scheduleNextExecution() || request_table->is_full()) {
+        if (scheduleNextExecution() || request_table->is_full() || my_TLB.isWalking()) {
             break;
         }
         if (my_request_start_tick == 0) {
@@ -219,24 +247,39 @@ void StreamAccessUnit::executeInstruction() {
                 DPRINTF(MAAStream, "S[%d] %s: operating on page %s!\n", my_stream_id, __func__, page_it->print());
                 std::fill(channel_sent, channel_sent + maa->m_org[ADDR_CHANNEL_LEVEL], false);
                 broken = false;
+                // Finding the run of ready elements of this page
+                int ready_end = std::min(page_it->curr_idx + getCeiling(page_it->max_itr - page_it->curr_itr, my_stride), (int)maa->num_tile_elements);
+                if (my_cond_tile != -1) {
+                    ready_end = maa->spd->getFirstUnfinished(my_cond_tile, page_it->curr_idx, ready_end, 4);
+                }
+                if (my_src_tile != -1) {
+                    ready_end = maa->spd->getFirstUnfinished(my_src_tile, page_it->curr_idx, ready_end, my_word_size);
+                }
                 for (; page_it->curr_itr < page_it->max_itr && page_it->curr_idx < maa->num_tile_elements; page_it->curr_itr += my_stride, page_it->curr_idx++) {
-                    if (my_cond_tile != -1) {
-                        if (maa->spd->getElementFinished(my_cond_tile, page_it->curr_idx, 4, (uint8_t)FuncUnitType::STREAM, my_stream_id) == false) {
-                            DPRINTF(MAAStream, "%s: cond tile[%d] element[%d] not ready, moving page %s to all!\n", __func__, my_cond_tile, page_it->curr_idx, page_it->print());
-                            my_all_page_info.insert(*page_it);
-                            page_it = my_current_page_info.erase(page_it);
-                            broken = true;
-                            break;
+                    if (page_it->curr_idx < ready_end) {
+                        if (my_cond_tile != -1) {
+                            num_spd_condread_accesses++;
                         }
-                        num_spd_condread_accesses++;
-                    }
-                    if (my_src_tile != -1) {
-                        if (maa->spd->getElementFinished(my_src_tile, page_it->curr_idx, my_word_size, (uint8_t)FuncUnitType::STREAM, my_stream_id) == false) {
-                            DPRINTF(MAAStream, "%s: src tile[%d] element[%d] not ready, moving page %s to all!\n", __func__, my_src_tile, page_it->curr_idx, page_it->print());
-                            my_all_page_info.insert(*page_it);
-                            page_it = my_current_page_info.erase(page_it);
-                            broken = true;
-                            break;
+                    } else {
+                        // Registering for the callback of the first tile that is not ready
+                        if (my_cond_tile != -1) {
+                            if (maa->spd->getElementFinished(my_cond_tile, page_it->curr_idx, 4, (uint8_t)FuncUnitType::STREAM, my_stream_id) == false) {
+                                DPRINTF(MAAStream, "%s: cond tile[%d] element[%d] not ready, moving page %s to all!\n", __func__, my_cond_tile, page_it->curr_idx, page_it->print());
+                                my_all_page_info.insert(*page_it);
+                                page_it = my_current_page_info.erase(page_it);
+                                broken = true;
+                                break;
+                            }
+                            num_spd_condread_accesses++;
+                        }
+                        if (my_src_tile != -1) {
+                            if (maa->spd->getElementFinished(my_src_tile, page_it->curr_idx, my_word_size, (uint8_t)FuncUnitType::STREAM, my_stream_id) == false) {
+                                DPRINTF(MAAStream, "%s: src tile[%d] element[%d] not ready, moving page %s to all!\n", __func__, my_src_tile, page_it->curr_idx, page_it->print());
+                                my_all_page_info.insert(*page_it);
+                                page_it = my_current_page_info.erase(page_it);
+                                broken = true;
+                                break;
+                            }
                         }
                     }
                     if (my_cond_tile == -1 || maa->spd->getData<uint32_t>(my_cond_tile, page_it->curr_idx) != 0) {
@@ -246,7 +289,7 @@ void StreamAccessUnit::executeInstruction() {
                         if (block_vaddr != page_it->last_block_vaddr) {
                             if (page_it->last_block_vaddr != 0) {
                                 Addr paddr = translatePacket(page_it->last_block_vaddr);
-                                std::vector<int> addr_vec = maa->map_addr(paddr);
+                                DramCoord addr_vec = maa->map_addr(paddr);
                                 panic_if(channel_sent[addr_vec[ADDR_CHANNEL_LEVEL]], "S[%d] %s: channel %d already sent for page %s!\n", my_stream_id, __func__, addr_vec[ADDR_CHANNEL_LEVEL], page_it->print());
                                 my_sent_requests++;
                                 num_request_table_cacheline_accesses++;
@@ -256,7 +299,7 @@ void StreamAccessUnit::executeInstruction() {
                             page_it->last_block_vaddr = block_vaddr;
                         }
                         Addr paddr = translatePacket(block_vaddr);
-                        std::vector<int> addr_vec = maa->map_addr(paddr);
+                        DramCoord addr_vec = maa->map_addr(paddr);
                         if (channel_sent[addr_vec[ADDR_CHANNEL_LEVEL]]) {
                             DPRINTF(MAAStream, "S[%d] RequestTable: entry %d not added because channel already pushed! paddr=0x%lx\n", my_stream_id, page_it->curr_idx, paddr);
                             page_it++;
@@ -377,6 +420,19 @@ void StreamAccessUnit::writePacketSent(Addr addr) {
     }
 }
 bool StreamAccessUnit::recvData(const Addr addr, uint8_t *dataptr) {
+    bool walk_finished;
+    Cycles walk_cycles;
+    if (my_TLB.recvData(addr, walk_finished, walk_cycles)) {
+        if (walk_finished) {
+            DPRINTF(MAAStream, "S[%d] %s: page walk finished in %lu cycles, calling execution again in state %s!\n", my_stream_id, __func__, (uint64_t)walk_cycles, status_names[(int)state]);
+            (*maa->stats.STR_CyclesTLBWalk[my_stream_id]) += walk_cycles;
+            // An execution that is already scheduled, e.g., at the end of the decode, rechecks the walks
+            if (executeInstructionEvent.scheduled() == false) {
+                scheduleNextExecution(true);
+            }
+        }
+        return true;
+    }
     bool was_request_table_full = request_table->is_full();
     std::vector<RequestTableEntry> entries = request_table->get_entries(addr);
     if (entries.empty()) {
@@ -396,9 +452,12 @@ bool StreamAccessUnit::recvData(const Addr addr, uint8_t *dataptr) {
             if (my_word_size == 4) {
                 DPRINTF(MAAStream, "S[%d] %s: SPD[%d][%d] = %u\n", my_stream_id, __func__, my_dst_tile, itr, dataptr_u32_typed[wid]);
                 maa->spd->setData<uint32_t>(my_dst_tile, itr, dataptr_u32_typed[wid]);
-            } else {
+            } else if (my_word_size == 8) {
                 DPRINTF(MAAStream, "S[%d] %s: SPD[%d][%d] = %lu\n", my_stream_id, __func__, my_dst_tile, itr, dataptr_u64_typed[wid]);
                 maa->spd->setData<uint64_t>(my_dst_tile, itr, dataptr_u64_typed[wid]);
+            } else {
+                DPRINTF(MAAStream, "S[%d] %s: SPD[%d][%d] = %d-byte word %d of the line\n", my_stream_id, __func__, my_dst_tile, itr, my_word_size, wid);
+                maa->spd->setWord(my_dst_tile, itr, my_word_size, dataptr + wid * my_word_size);
             }
             break;
         }
@@ -406,9 +465,12 @@ bool StreamAccessUnit::recvData(const Addr addr, uint8_t *dataptr) {
             if (my_word_size == 4) {
                 ((uint32_t *)new_data)[wid] = maa->spd->getData<uint32_t>(my_src_tile, itr);
                 DPRINTF(MAAStream, "S[%d] %s: new_data[%d] = SPD[%d][%d] = %f!\n", my_stream_id, __func__, wid, my_src_tile, itr, ((float *)new_data)[wid]);
-            } else {
+            } else if (my_word_size == 8) {
                 ((uint64_t *)new_data)[wid] = maa->spd->getData<uint64_t>(my_src_tile, itr);
                 DPRINTF(MAAStream, "S[%d] %s: new_data[%d] = SPD[%d][%d] = %f!\n", my_stream_id, __func__, wid, my_src_tile, itr, ((double *)new_data)[wid]);
+            } else {
+                maa->spd->getWord(my_src_tile, itr, my_word_size, new_data + wid * my_word_size);
+                DPRINTF(MAAStream, "S[%d] %s: new_data[%d] = SPD[%d][%d] (%d-byte word)!\n", my_stream_id, __func__, wid, my_src_tile, itr, my_word_size);
             }
             break;
         }
@@ -442,6 +504,10 @@ bool StreamAccessUnit::recvData(const Addr addr, uint8_t *dataptr) {
     return true;
 }
 Addr StreamAccessUnit::translatePacket(Addr vaddr) {
+    Addr paddr;
+    if (my_translation_memo.find(vaddr, paddr)) {
+        return paddr;
+    }
     /**** Address translation ****/
     RequestPtr translation_req = std::make_shared<Request>(vaddr, block_size, flags, maa->requestorId, my_instruction->PC, my_instruction->CID);
     ThreadContext *tc = maa->system->threads[my_instruction->CID];
@@ -449,6 +515,7 @@ Addr StreamAccessUnit::translatePacket(Addr vaddr) {
     // The above function immediately does the translation and calls the finish function
     assert(my_translation_done);
     my_translation_done = false;
+    my_translation_memo.insert(vaddr, my_translated_addr);
     return my_translated_addr;
 }
 void StreamAccessUnit::finish(const Fault &fault, const RequestPtr &req, ThreadContext *tc, BaseMMU::Mode mode) {
@@ -86,6 +86,7 @@ public:
     Status getState() const { return state; }
 
     void setInstruction(Instruction *_instruction);
+    void flushTLB() { my_TLB.flush(); }
 
     Cycles updateLatency(int num_spd_condread_accesses,
                          int num_spd_srcread_accesses,
@@ -125,6 +126,9 @@ protected:
 
     Addr my_translated_addr;
     bool my_translation_done;
+    TranslationMemo my_translation_memo;
+    TranslationBuffer my_TLB;
+    Tick my_translation_finish_tick;
 
     void createReadPacket(Addr addr, int latency);
     Addr translatePacket(Addr vaddr);
@@ -11,6 +11,353 @@
 
 namespace gem5 {
 
+///////////////
+//
+// TABLE INDEX
+//
+///////////////
+void TableIndex::allocate(int _num_keys) {
+    // Keep the load factor below 0.5 so that probe chains stay short
+    num_slots = 1;
+    while (num_slots < 2 * _num_keys) {
+        num_slots <<= 1;
+    }
+    mask = num_slots - 1;
+    slots = new Slot[num_slots];
+    for (int i = 0; i < num_slots; i++) {
+        slots[i].row = -1;
+    }
+    size = 0;
+}
+int TableIndex::hash(Addr tag, Addr addr) {
+    uint64_t key = (addr >> 6) * 0x9E3779B97F4A7C15ULL;
+    key ^= (tag + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+    key ^= key >> 29;
+    return (int)(key & mask);
+}
+int TableIndex::find(Addr tag, Addr addr, int pos) {
+    pos = (pos == -1) ? hash(tag, addr) : ((pos + 1) & mask);
+    while (slots[pos].row != -1) {
+        if (slots[pos].tag == tag && slots[pos].addr == addr) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+void TableIndex::insert(Addr tag, Addr addr, int row, int col) {
+    panic_if(size >= num_slots / 2, "Table index is full: %d/%d!\n", size, num_slots);
+    int pos = hash(tag, addr);
+    while (slots[pos].row != -1) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos].tag = tag;
+    slots[pos].addr = addr;
+    slots[pos].row = row;
+    slots[pos].col = col;
+    size++;
+}
+void TableIndex::remove(int pos) {
+    assert(slots[pos].row != -1);
+    size--;
+    // Backward-shift the rest of the probe chain into the hole
+    int next_pos = pos;
+    while (true) {
+        slots[pos].row = -1;
+        while (true) {
+            next_pos = (next_pos + 1) & mask;
+            if (slots[next_pos].row == -1) {
+                return;
+            }
+            int home = hash(slots[next_pos].tag, slots[next_pos].addr);
+            bool stays = (pos <= next_pos) ? (pos < home && home <= next_pos) : (pos < home || home <= next_pos);
+            if (stays == false) {
+                break;
+            }
+        }
+        slots[pos] = slots[next_pos];
+        pos = next_pos;
+    }
+}
+void TableIndex::reset() {
+    if (size != 0) {
+        for (int i = 0; i < num_slots; i++) {
+            slots[i].row = -1;
+        }
+        size = 0;
+    }
+}
+
+///////////////
+//
+// ADDRESS TABLE
+//
+///////////////
+template <typename T>
+void AddrValueTable<T>::allocate(int _num_keys) {
+    num_slots = 1;
+    while (num_slots < 2 * _num_keys) {
+        num_slots <<= 1;
+    }
+    mask = num_slots - 1;
+    slots = new Slot[num_slots];
+    for (int i = 0; i < num_slots; i++) {
+        slots[i].state = SlotState::Empty;
+    }
+    size = 0;
+    num_used_slots = 0;
+}
+template <typename T>
+int AddrValueTable<T>::hash(Addr addr) {
+    uint64_t key = addr * 0x9E3779B97F4A7C15ULL;
+    key ^= key >> 32;
+    return (int)(key & mask);
+}
+template <typename T>
+int AddrValueTable<T>::find_slot(Addr addr) {
+    int pos = hash(addr);
+    while (slots[pos].state != SlotState::Empty) {
+        if (slots[pos].state == SlotState::Valid && slots[pos].addr == addr) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+template <typename T>
+bool AddrValueTable<T>::insert(Addr addr, T value) {
+    int pos = hash(addr);
+    int free_pos = -1;
+    while (slots[pos].state != SlotState::Empty) {
+        if (slots[pos].state == SlotState::Valid && slots[pos].addr == addr) {
+            slots[pos].value = value;
+            return false;
+        } else if (slots[pos].state == SlotState::Erased && free_pos == -1) {
+            free_pos = pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    if (free_pos == -1) {
+        if (num_used_slots + 1 > num_slots / 2) {
+            // Too many tombstones, drop them and look for a slot again
+            rehash();
+            return insert(addr, value);
+        }
+        free_pos = pos;
+        num_used_slots++;
+    }
+    slots[free_pos].addr = addr;
+    slots[free_pos].value = value;
+    slots[free_pos].state = SlotState::Valid;
+    size++;
+    return true;
+}
+template <typename T>
+bool AddrValueTable<T>::find(Addr addr, T &value) {
+    int pos = find_slot(addr);
+    if (pos == -1) {
+        return false;
+    }
+    value = slots[pos].value;
+    return true;
+}
+template <typename T>
+bool AddrValueTable<T>::erase(Addr addr) {
+    int pos = find_slot(addr);
+    if (pos == -1) {
+        return false;
+    }
+    slots[pos].state = SlotState::Erased;
+    size--;
+    return true;
+}
+template <typename T>
+void AddrValueTable<T>::rehash() {
+    panic_if(size + 1 > num_slots / 2, "Address table is full: %d/%d!\n", size, num_slots);
+    Slot *old_slots = slots;
+    slots = new Slot[num_slots];
+    for (int i = 0; i < num_slots; i++) {
+        slots[i].state = SlotState::Empty;
+    }
+    size = 0;
+    num_used_slots = 0;
+    for (int i = 0; i < num_slots; i++) {
+        if (old_slots[i].state == SlotState::Valid) {
+            insert(old_slots[i].addr, old_slots[i].value);
+        }
+    }
+    delete[] old_slots;
+}
+template <typename T>
+void AddrValueTable<T>::reset() {
+    if (num_used_slots != 0) {
+        for (int i = 0; i < num_slots; i++) {
+            slots[i].state = SlotState::Empty;
+        }
+        size = 0;
+        num_used_slots = 0;
+    }
+}
+template class AddrValueTable<Tick>;
+template class AddrValueTable<int>;
+
+///////////////
+//
+// TRANSLATION MEMO
+//
+///////////////
+bool TranslationMemo::find(Addr vaddr, Addr &paddr) {
+    Addr vpn = vaddr / page_size;
+    Entry &entry = entries[vpn % num_entries];
+    if (entry.valid == false || entry.vpn != vpn) {
+        return false;
+    }
+    paddr = entry.ppn * page_size + vaddr % page_size;
+    return true;
+}
+void TranslationMemo::insert(Addr vaddr, Addr paddr) {
+    Addr vpn = vaddr / page_size;
+    Entry &entry = entries[vpn % num_entries];
+    entry.vpn = vpn;
+    entry.ppn = paddr / page_size;
+    entry.valid = true;
+}
+void TranslationMemo::reset() {
+    for (int i = 0; i < num_entries; i++) {
+        entries[i].valid = false;
+    }
+}
+
+///////////////
+//
+// TRANSLATION BUFFER
+//
+///////////////
+TranslationBuffer::~TranslationBuffer() {
+    if (entries != nullptr) {
+        delete[] entries;
+    }
+}
+void TranslationBuffer::allocate(int _num_entries, int _associativity, Addr _page_size, Cycles _hit_latency, Addr _page_table_size, FuncUnitType _unit_type, int _unit_id, MAA *_maa) {
+    num_entries = _num_entries;
+    maa = _maa;
+    if (num_entries == 0) {
+        return;
+    }
+    associativity = _associativity;
+    panic_if(associativity <= 0 || num_entries % associativity != 0, "TLB entries %d is not a multiple of the associativity %d!\n", num_entries, associativity);
+    num_sets = num_entries / associativity;
+    page_size = _page_size;
+    if (page_size == 4096) {
+        num_walk_levels = 4;
+    } else if (page_size == 2 * 1024 * 1024) {
+        num_walk_levels = 3;
+    } else if (page_size == 1024 * 1024 * 1024) {
+        num_walk_levels = 2;
+    } else {
+        panic("TLB page size %lu is not 4KiB, 2MiB, or 1GiB!\n", page_size);
+    }
+    hit_latency = _hit_latency;
+    // The page table takes the top of the (SE mode, zero-based) physical memory,
+    // each level gets an equal, cache line aligned part of it
+    Addr mem_size = maa->system->memSize();
+    panic_if(_page_table_size > mem_size, "TLB page table size %lu is larger than the memory size %lu!\n", _page_table_size, mem_size);
+    page_table_addr = mem_size - _page_table_size;
+    level_table_size = addrBlockAligner(_page_table_size / num_walk_levels, block_size);
+    panic_if(level_table_size == 0, "TLB page table size %lu is too small for %d levels!\n", _page_table_size, num_walk_levels);
+    unit_type = _unit_type;
+    unit_id = _unit_id;
+    walks.clear();
+    walk_level = 0;
+    walk_addr = 0;
+    entries = new Entry[num_entries];
+    flush();
+}
+Addr TranslationBuffer::getPTEAddr(Addr vpn, int level) {
+    // Every level translates 9 bits of the virtual page number, the root level the top ones
+    Addr index = vpn >> (9 * (num_walk_levels - 1 - level));
+    Addr offset = (index * 8) % level_table_size;
+    return addrBlockAligner(page_table_addr + level * level_table_size + offset, block_size);
+}
+void TranslationBuffer::sendWalkPacket(Tick tick) {
+    walk_addr = getPTEAddr(walks.front().vpn, walk_level);
+    Request::Flags flags = 0;
+    RequestPtr real_req = std::make_shared<Request>(walk_addr, block_size, flags, maa->requestorId);
+    PacketPtr read_pkt = new Packet(real_req, MemCmd::ReadReq);
+    read_pkt->headerDelay = read_pkt->payloadDelay = 0;
+    read_pkt->allocate();
+    // PTEs are read through the caches like the page walker of a core
+    maa->sendPacket(unit_type, unit_id, read_pkt, tick, true);
+}
+void TranslationBuffer::fill(Addr vpn) {
+    Entry *set = &entries[(vpn % num_sets) * associativity];
+    Entry *victim = &set[0];
+    for (int way = 0; way < associativity; way++) {
+        if (set[way].valid == false || (victim->valid && set[way].last_used < victim->last_used)) {
+            victim = &set[way];
+        }
+    }
+    victim->vpn = vpn;
+    victim->last_used = ++num_lookups;
+    victim->valid = true;
+}
+TranslationBuffer::Lookup TranslationBuffer::lookup(Addr vaddr, Tick &ready_tick) {
+    assert(num_entries != 0);
+    Addr vpn = vaddr / page_size;
+    Entry *set = &entries[(vpn % num_sets) * associativity];
+    num_lookups++;
+    for (int way = 0; way < associativity; way++) {
+        if (set[way].valid && set[way].vpn == vpn) {
+            set[way].last_used = num_lookups;
+            ready_tick = maa->getClockEdge(hit_latency);
+            return Lookup::Hit;
+        }
+    }
+    for (const Walk &walk : walks) {
+        if (walk.vpn == vpn) {
+            return Lookup::Pending;
+        }
+    }
+    walks.push_back({vpn, curTick()});
+    if (walks.size() == 1) {
+        // The walk starts once the lookup has missed
+        walk_level = 0;
+        sendWalkPacket(maa->getClockEdge(hit_latency));
+    }
+    return Lookup::Miss;
+}
+bool TranslationBuffer::isWalkAddr(Addr addr) const {
+    return walks.empty() == false && addr == walk_addr;
+}
+bool TranslationBuffer::recvData(Addr addr, bool &walk_finished, Cycles &walk_cycles) {
+    walk_finished = false;
+    if (isWalkAddr(addr) == false) {
+        return false;
+    }
+    if (walk_level < num_walk_levels - 1) {
+        // The next level is read with the PTE of this one
+        walk_level++;
+        sendWalkPacket(maa->getClockEdge(Cycles(0)));
+        return true;
+    }
+    Walk walk = walks.front();
+    walks.erase(walks.begin());
+    fill(walk.vpn);
+    walk_finished = true;
+    walk_cycles = maa->getTicksToCycles(curTick() - walk.miss_tick);
+    if (walks.empty() == false) {
+        walk_level = 0;
+        sendWalkPacket(maa->getClockEdge(Cycles(0)));
+    }
+    return true;
+}
+void TranslationBuffer::flush() {
+    for (int i = 0; i < num_entries; i++) {
+        entries[i].valid = false;
+    }
+    num_lookups = 0;
+}
+
 ///////////////
 // REQUEST TABLE
 ///////////////
@@ -21,10 +368,12 @@ RequestTable::RequestTable(MAA *_maa, unsigned int _num_addresses, unsigned int
     my_unit_id = _my_unit_id;
     entries = new RequestTableEntry *[num_addresses];
     entries_valid = new bool *[num_addresses];
+    num_entries = new int[num_addresses];
     is_stream = _is_stream;
     for (int i = 0; i < num_addresses; i++) {
         entries[i] = new RequestTableEntry[num_entries_per_address];
         entries_valid[i] = new bool[num_entries_per_address];
+        num_entries[i] = 0;
         for (int j = 0; j < num_entries_per_address; j++) {
             entries_valid[i][j] = false;
         }
@@ -34,6 +383,12 @@ RequestTable::RequestTable(MAA *_maa, unsigned int _num_addresses, unsigned int
     for (int i = 0; i < num_addresses; i++) {
         addresses_valid[i] = false;
     }
+    address_index.allocate(num_addresses);
+    free_addresses = new int[num_addresses];
+    num_free_addresses = 0;
+    for (int i = num_addresses - 1; i >= 0; i--) {
+        free_addresses[num_free_addresses++] = i;
+    }
 }
 RequestTable::~RequestTable() {
     for (int i = 0; i < num_addresses; i++) {
@@ -42,46 +397,48 @@ RequestTable::~RequestTable() {
     }
     delete[] entries;
     delete[] entries_valid;
+    delete[] num_entries;
     delete[] addresses;
     delete[] addresses_valid;
+    delete[] free_addresses;
 }
 std::vector<RequestTableEntry> RequestTable::get_entries(Addr base_addr) {
     std::vector<RequestTableEntry> result;
-    for (int i = 0; i < num_addresses; i++) {
-        if (addresses_valid[i] == true && addresses[i] == base_addr) {
-            for (int j = 0; j < num_entries_per_address; j++) {
-                if (entries_valid[i][j] == true) {
-                    result.push_back(entries[i][j]);
-                    entries_valid[i][j] = false;
-                }
-            }
-            addresses_valid[i] = false;
-            break;
-        }
-    }
+    int pos = address_index.find(0, base_addr);
+    if (pos == -1) {
+        return result;
+    }
+    int i = address_index.slots[pos].row;
+    assert(addresses_valid[i] == true && addresses[i] == base_addr);
+    // Entries of an address are always filled in order and freed together
+    result.reserve(num_entries[i]);
+    for (int j = 0; j < num_entries[i]; j++) {
+        assert(entries_valid[i][j] == true);
+        result.push_back(entries[i][j]);
+        entries_valid[i][j] = false;
+    }
+    num_entries[i] = 0;
+    addresses_valid[i] = false;
+    address_index.remove(pos);
+    free_addresses[num_free_addresses++] = i;
     return result;
 }
 bool RequestTable::add_entry(int itr, Addr base_addr, uint16_t wid) {
     int address_itr = -1;
-    int free_address_itr = -1;
-    for (int i = 0; i < num_addresses; i++) {
-        if (addresses_valid[i] == true) {
-            if (addresses[i] == base_addr) {
-                // Duplicate should not be allowed
-                assert(address_itr == -1);
-                address_itr = i;
-            }
-        } else if (free_address_itr == -1) {
-            free_address_itr = i;
-        }
-    }
-    if (address_itr == -1) {
-        if (free_address_itr == -1) {
+    int pos = address_index.find(0, base_addr);
+    if (pos != -1) {
+        address_itr = address_index.slots[pos].row;
+        // Duplicate should not be allowed
+        assert(address_index.find(0, base_addr, pos) == -1);
+    } else {
+        if (num_free_addresses == 0) {
             return false;
         } else {
-            addresses[free_address_itr] = base_addr;
-            addresses_valid[free_address_itr] = true;
-            address_itr = free_address_itr;
+            address_itr = free_addresses[--num_free_addresses];
+            assert(addresses_valid[address_itr] == false);
+            addresses[address_itr] = base_addr;
+            addresses_valid[address_itr] = true;
+            address_index.insert(0, base_addr, address_itr, -1);
             if (is_stream) {
                 (*maa->stats.STR_NumCacheLineInserted[my_unit_id])++;
             } else {
@@ -89,16 +446,12 @@ bool RequestTable::add_entry(int itr, Addr base_addr, uint16_t wid) {
             }
         }
     }
-    int free_entry_itr = -1;
-    for (int i = 0; i < num_entries_per_address; i++) {
-        if (entries_valid[address_itr][i] == false) {
-            free_entry_itr = i;
-            break;
-        }
-    }
-    assert(free_entry_itr != -1);
+    int free_entry_itr = num_entries[address_itr];
+    assert(free_entry_itr < num_entries_per_address);
+    assert(entries_valid[address_itr][free_entry_itr] == false);
     entries[address_itr][free_entry_itr] = RequestTableEntry(itr, wid);
     entries_valid[address_itr][free_entry_itr] = true;
+    num_entries[address_itr]++;
     if (is_stream) {
         (*maa->stats.STR_NumWordsInserted[my_unit_id])++;
     } else {
@@ -113,22 +466,25 @@ void RequestTable::check_reset() {
             panic_if(entries_valid[i][j], "Entry %d is valid: itr(%u) wid(%u)!\n", j, entries[i][j].itr, entries[i][j].wid);
         }
     }
+    panic_if(num_free_addresses != num_addresses, "%d addresses are not freed!\n", num_addresses - num_free_addresses);
+    panic_if(address_index.size != 0, "Address index is not empty: %d!\n", address_index.size);
 }
 void RequestTable::reset() {
     for (int i = 0; i < num_addresses; i++) {
         addresses_valid[i] = false;
+        num_entries[i] = 0;
         for (int j = 0; j < num_entries_per_address; j++) {
             entries_valid[i][j] = false;
         }
     }
+    address_index.reset();
+    num_free_addresses = 0;
+    for (int i = num_addresses - 1; i >= 0; i--) {
+        free_addresses[num_free_addresses++] = i;
+    }
 }
 bool RequestTable::is_full() {
-    for (int i = 0; i < num_addresses; i++) {
-        if (addresses_valid[i] == false) {
-            return false;
-        }
-    }
-    return true;
+    return num_free_addresses == 0;
 }
 
 ///////////////
@@ -166,22 +522,16 @@ void OffsetTable::insert(int itr, int wid, int last_itr) {
         (*maa->stats.IND_NumWordsInserted[my_unit_id])++;
     }
 }
-std::vector<OffsetTableEntry> OffsetTable::get_entry_recv(int first_itr) {
-    std::vector<OffsetTableEntry> result;
-    assert(first_itr != -1);
-    int itr = first_itr;
-    int prev_itr = itr;
-    while (itr != -1) {
-        result.push_back(entries[itr]);
-        panic_if(entries_valid[itr] == false, "Entry %d is invalid!\n", itr);
-        prev_itr = itr;
-        itr = entries[itr].next_itr;
-        // Invalidate the previous itr
-        entries_valid[prev_itr] = false;
-        entries[prev_itr].wid = -1;
-        entries[prev_itr].next_itr = -1;
-    }
-    return result;
+int OffsetTable::get_entry_recv(int itr, int &wid) {
+    assert(itr != -1);
+    panic_if(entries_valid[itr] == false, "Entry %d is invalid!\n", itr);
+    wid = entries[itr].wid;
+    int next_itr = entries[itr].next_itr;
+    // Invalidate the itr
+    entries_valid[itr] = false;
+    entries[itr].wid = -1;
+    entries[itr].next_itr = -1;
+    return next_itr;
 }
 void OffsetTable::check_reset() {
     for (int i = 0; i < num_tile_elements; i++) {
@@ -223,38 +573,35 @@ void RowTableEntry::allocate(int _my_unit_id,
     entries = new Entry[num_RT_entries_per_row];
     entries_valid = new bool[num_RT_entries_per_row];
     last_sent_entry_id = 0;
+    num_valid_entries = 0;
     for (int i = 0; i < num_RT_entries_per_row; i++) {
         entries_valid[i] = false;
     }
 }
-bool RowTableEntry::find_addr(Addr addr) {
-    for (int i = 0; i < num_RT_entries_per_row; i++) {
-        if (entries_valid[i] == true && entries[i].addr == addr) {
-            return true;
-        }
-    }
-    return false;
+void RowTableEntry::insert(int entry_id, int itr, int wid) {
+    assert(entries_valid[entry_id] == true);
+    offset_table->insert(itr, wid, entries[entry_id].last_itr);
+    entries[entry_id].last_itr = itr;
+    DPRINTF(MAARowTable, "ROT[%d] ROW[%d] %s: entry[%d] inserted!\n",
+            my_table_id, my_table_row_id, __func__, entry_id);
 }
-bool RowTableEntry::insert(Addr addr, int itr, int wid) {
+int RowTableEntry::insert_new(Addr addr, int itr, int wid) {
+    if (num_valid_entries == num_RT_entries_per_row) {
+        return -1;
+    }
     int free_entry_id = -1;
     for (int i = 0; i < num_RT_entries_per_row; i++) {
-        if (entries_valid[i] == true && entries[i].addr == addr) {
-            offset_table->insert(itr, wid, entries[i].last_itr);
-            entries[i].last_itr = itr;
-            DPRINTF(MAARowTable, "ROT[%d] ROW[%d] %s: entry[%d] inserted!\n",
-                    my_table_id, my_table_row_id, __func__, i);
-            return true;
-        } else if (entries_valid[i] == false && free_entry_id == -1) {
+        if (entries_valid[i] == false) {
             free_entry_id = i;
+            break;
         }
     }
-    if (free_entry_id == -1) {
-        return false;
-    }
+    assert(free_entry_id != -1);
     entries[free_entry_id].addr = addr;
     entries[free_entry_id].first_itr = itr;
     entries[free_entry_id].last_itr = itr;
     entries_valid[free_entry_id] = true;
+    num_valid_entries++;
     offset_table->insert(itr, wid, -1);
     DPRINTF(MAARowTable, "ROT[%d] ROW[%d] %s: new entry[%d] addr[0x%lx] inserted!\n",
             my_table_id, my_table_row_id, __func__, free_entry_id, addr);
@@ -263,19 +610,21 @@ bool RowTableEntry::insert(Addr addr, int itr, int wid) {
     } else {
         (*maa->stats.IND_NumCacheLineInserted[my_unit_id])++;
     }
-    return true;
+    return free_entry_id;
 }
 void RowTableEntry::check_reset() {
     for (int i = 0; i < num_RT_entries_per_row; i++) {
         panic_if(entries_valid[i], "Entry %d is valid: addr(0x%lx)!\n", i, entries[i].addr);
     }
     panic_if(last_sent_entry_id != 0, "Last sent entry id is not 0: %d!\n", last_sent_entry_id);
+    panic_if(num_valid_entries != 0, "Number of valid entries is not 0: %d!\n", num_valid_entries);
 }
 void RowTableEntry::reset() {
     for (int i = 0; i < num_RT_entries_per_row; i++) {
         entries_valid[i] = false;
     }
     last_sent_entry_id = 0;
+    num_valid_entries = 0;
 }
 bool RowTableEntry::get_entry_send(Addr &addr) {
     assert(last_sent_entry_id <= num_RT_entries_per_row);
@@ -291,23 +640,18 @@ bool RowTableEntry::get_entry_send(Addr &addr) {
     }
     return false;
 }
-std::vector<OffsetTableEntry> RowTableEntry::get_entry_recv(Addr addr) {
-    for (int i = 0; i < num_RT_entries_per_row; i++) {
-        if (entries_valid[i] == true && entries[i].addr == addr) {
-            entries_valid[i] = false;
-            DPRINTF(MAARowTable, "ROT[%d] ROW[%d] %s: entry[%d] addr[0x%lx] received, setting to invalid!\n",
-                    my_table_id, my_table_row_id, __func__, i, addr);
-            return offset_table->get_entry_recv(entries[i].first_itr);
-        }
-    }
-    return std::vector<OffsetTableEntry>();
+int RowTableEntry::get_entry_recv(int entry_id) {
+    assert(entries_valid[entry_id] == true);
+    entries_valid[entry_id] = false;
+    num_valid_entries--;
+    DPRINTF(MAARowTable, "ROT[%d] ROW[%d] %s: entry[%d] addr[0x%lx] received, setting to invalid!\n",
+            my_table_id, my_table_row_id, __func__, entry_id, entries[entry_id].addr);
+    return entries[entry_id].first_itr;
 }
 
 bool RowTableEntry::all_entries_received() {
-    for (int i = 0; i < num_RT_entries_per_row; i++) {
-        if (entries_valid[i] == true) {
-            return false;
-        }
+    if (num_valid_entries != 0) {
+        return false;
     }
     last_sent_entry_id = 0;
     return true;
@@ -338,7 +682,21 @@ void RowTableSlice::allocate(int _my_unit_id,
     last_sent_grow_addr = 0;
     last_sent_rowid = 0;
     last_sent_grow_rowid = 0;
+    // The bank group and bank above the slice bits, see IndirectAccessUnit::getGrowAddr
+    num_banks = maa->m_org[ADDR_BANKGROUP_LEVEL] * maa->m_org[ADDR_BANK_LEVEL];
+    bank_inflight = new int[num_banks];
+    std::fill(bank_inflight, bank_inflight + num_banks, 0);
+    last_sent_bank = -1;
+    last_picked_grow_addr = 0;
+    CL_index.allocate(num_RT_rows_per_slice * num_RT_entries_per_row);
+    row_index.allocate(num_RT_rows_per_slice);
+    num_rows_free_words = (num_RT_rows_per_slice + 63) / 64;
+    rows_free = new uint64_t[num_rows_free_words];
+    std::fill(rows_free, rows_free + num_rows_free_words, 0);
+    num_valid_rows = 0;
+    num_valid_entries = 0;
     for (int i = 0; i < num_RT_rows_per_slice; i++) {
+        set_row_free(i, true);
         entries[i].allocate(my_unit_id,
                             my_table_id,
                             i,
@@ -350,47 +708,71 @@ void RowTableSlice::allocate(int _my_unit_id,
         entries_sent[i] = false;
     }
 }
+void RowTableSlice::set_row_free(int rowid, bool free) {
+    if (free) {
+        rows_free[rowid / 64] |= (1ULL << (rowid % 64));
+    } else {
+        rows_free[rowid / 64] &= ~(1ULL << (rowid % 64));
+    }
+}
+int RowTableSlice::get_free_rowid() {
+    for (int i = 0; i < num_rows_free_words; i++) {
+        if (rows_free[i] != 0) {
+            return i * 64 + __builtin_ctzll(rows_free[i]);
+        }
+    }
+    return -1;
+}
 bool RowTableSlice::insert(Addr grow_addr, Addr addr, int itr, int wid, bool &first_CL_access) {
     first_CL_access = false;
     // 1. Check if the (Row, CL) pair exists
-    for (int i = 0; i < num_RT_rows_per_slice; i++) {
-        if (entries_valid[i] == true && entries_sent[i] == false && entries[i].grow_addr == grow_addr && entries[i].find_addr(addr)) {
+    for (int pos = CL_index.find(grow_addr, addr); pos != -1; pos = CL_index.find(grow_addr, addr, pos)) {
+        int i = CL_index.slots[pos].row;
+        if (entries_sent[i] == false) {
             DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] addr[0x%lx] found in R[%d]!\n", my_table_id, __func__, grow_addr, addr, i);
-            assert(entries[i].insert(addr, itr, wid));
+            entries[i].insert(CL_index.slots[pos].col, itr, wid);
             return true;
         }
     }
     first_CL_access = true;
     // 2. Check if (Row) exists and can insert the new CL
-    // 2.1 At the same time, look for a free row
-    int free_row_id = -1;
-    int num_free_entries = 0;
-    for (int i = 0; i < num_RT_rows_per_slice; i++) {
-        if (entries_valid[i] == true && entries_sent[i] == false && entries[i].grow_addr == grow_addr) {
-            if (entries[i].insert(addr, itr, wid)) {
-                DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] R[%d] inserted new addr[0x%lx]!\n", my_table_id, __func__, grow_addr, i, addr);
-                return true;
-            }
-        } else if (entries_valid[i] == false) {
-            panic_if(entries_sent[i] == true, "Row[%d] is already sent: grow_addr(0x%lx)!\n", i, entries[i].grow_addr);
-            num_free_entries++;
-            if (free_row_id == -1) {
-                free_row_id = i;
-            }
+    // Among the rows of this grow, the lowest one with a free column is used
+    int row_id = -1;
+    for (int pos = row_index.find(grow_addr, 0); pos != -1; pos = row_index.find(grow_addr, 0, pos)) {
+        int i = row_index.slots[pos].row;
+        if (entries_sent[i] == false && entries[i].num_valid_entries < num_RT_entries_per_row && (row_id == -1 || i < row_id)) {
+            row_id = i;
         }
     }
+    if (row_id != -1) {
+        int col_id = entries[row_id].insert_new(addr, itr, wid);
+        assert(col_id != -1);
+        CL_index.insert(grow_addr, addr, row_id, col_id);
+        num_valid_entries++;
+        DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] R[%d] inserted new addr[0x%lx]!\n", my_table_id, __func__, grow_addr, row_id, addr);
+        return true;
+    }
     // 3. Check if we can insert the new Row or we need drain
+    int free_row_id = get_free_rowid();
     if (free_row_id == -1) {
         DPRINTF(MAARowTable, "ROT[%d] %s: no entry exists or available for grow[0x%lx] and addr[0x%lx], requires drain. Avg CL/Row: %d!\n", my_table_id, __func__, grow_addr, addr, getAverageEntriesPerRow());
         return false;
     }
+    panic_if(entries_valid[free_row_id] == true, "Row[%d] is free but valid: grow_addr(0x%lx)!\n", free_row_id, entries[free_row_id].grow_addr);
+    panic_if(entries_sent[free_row_id] == true, "Row[%d] is already sent: grow_addr(0x%lx)!\n", free_row_id, entries[free_row_id].grow_addr);
     // 4. Add new (Row), add new (CL)
     DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] adding to new R[%d]!\n", my_table_id, __func__, grow_addr, free_row_id);
     entries[free_row_id].grow_addr = grow_addr;
-    assert(entries[free_row_id].insert(addr, itr, wid) == true);
+    int col_id = entries[free_row_id].insert_new(addr, itr, wid);
+    assert(col_id != -1);
+    CL_index.insert(grow_addr, addr, free_row_id, col_id);
+    row_index.insert(grow_addr, 0, free_row_id, -1);
+    num_valid_entries++;
+    num_valid_rows++;
+    set_row_free(free_row_id, false);
     entries_valid[free_row_id] = true;
     entries_sent[free_row_id] = false;
-    if (num_free_entries == 1) {
+    if (num_valid_rows == num_RT_rows_per_slice) {
         DPRINTF(MAARowTable, "ROT[%d] %s: R[%d] grow[0x%lx] set to full!\n", my_table_id, __func__, free_row_id, grow_addr);
     }
     if (is_stream == false) {
@@ -399,15 +781,7 @@ bool RowTableSlice::insert(Addr grow_addr, Addr addr, int itr, int wid, bool &fi
     return true;
 }
 float RowTableSlice::getAverageEntriesPerRow() {
-    float total_entries = 0.0000;
-    for (int i = 0; i < num_RT_rows_per_slice; i++) {
-        if (entries_valid[i] == true) {
-            for (int j = 0; j < num_RT_entries_per_row; j++) {
-                total_entries += entries[i].entries_valid[j] ? 1 : 0;
-            }
-        }
-    }
-    return total_entries / num_RT_rows_per_slice;
+    return ((float)num_valid_entries) / num_RT_rows_per_slice;
 }
 void RowTableSlice::check_reset() {
     for (int i = 0; i < num_RT_rows_per_slice; i++) {
@@ -415,31 +789,84 @@ void RowTableSlice::check_reset() {
         panic_if(entries_valid[i], "Row[%d] is valid: grow_addr(0x%lx)!\n", i, entries[i].grow_addr);
     }
     panic_if(last_sent_rowid != 0, "Last sent row id is not 0: %d!\n", last_sent_rowid);
+    panic_if(num_valid_rows != 0, "Number of valid rows is not 0: %d!\n", num_valid_rows);
+    panic_if(CL_index.size != 0 || row_index.size != 0, "Row table index is not empty: CLs(%d) rows(%d)!\n", CL_index.size, row_index.size);
 }
 void RowTableSlice::reset() {
     for (int i = 0; i < num_RT_rows_per_slice; i++) {
         entries[i].reset();
         entries_valid[i] = false;
         entries_sent[i] = false;
+        set_row_free(i, true);
     }
+    CL_index.reset();
+    row_index.reset();
+    num_valid_rows = 0;
+    num_valid_entries = 0;
     last_sent_rowid = 0;
     last_sent_grow_rowid = 0;
     last_sent_grow_addr = 0;
+    std::fill(bank_inflight, bank_inflight + num_banks, 0);
+    last_sent_bank = -1;
+    last_picked_grow_addr = 0;
+}
+int RowTableSlice::get_bank(Addr grow_addr) {
+    return grow_addr / maa->m_org[ADDR_ROW_LEVEL];
 }
 bool RowTableSlice::find_next_grow_addr() {
-    for (; last_sent_rowid < num_RT_rows_per_slice; last_sent_rowid++) {
-        if (entries_valid[last_sent_rowid] == true && entries_sent[last_sent_rowid] == false) {
-            last_sent_grow_rowid = last_sent_rowid;
-            last_sent_grow_addr = entries[last_sent_rowid].grow_addr;
-            return true;
+    // Round-robin from the last sent row, preferring the DRAM row of the last
+    // picked rows (a row hit), then another bank than the last sent row, and
+    // then the bank with the fewest requests in flight
+    int best_rowid = -1;
+    int best_rank = 0;
+    int best_inflight = 0;
+    int first_rank = 0;
+    for (int i = 0; i < num_RT_rows_per_slice; i++) {
+        int rowid = (last_sent_rowid + i) % num_RT_rows_per_slice;
+        if (entries_valid[rowid] == false || entries_sent[rowid] == true) {
+            continue;
+        }
+        Addr grow_addr = entries[rowid].grow_addr;
+        int bank = get_bank(grow_addr);
+        // 0: same DRAM row, 1: another bank, 2: another row of the same bank
+        int rank = grow_addr == last_picked_grow_addr ? 0 : (bank == last_sent_bank ? 2 : 1);
+        if (best_rowid == -1) {
+            first_rank = rank;
+        } else if (rank > best_rank || (rank == best_rank && bank_inflight[bank] >= best_inflight)) {
+            continue;
+        }
+        best_rowid = rowid;
+        best_rank = rank;
+        best_inflight = bank_inflight[bank];
+        if (rank == 0 || (rank == 1 && best_inflight == 0)) {
+            break;
         }
     }
-    last_sent_rowid = 0;
-    return false;
+    if (best_rowid == -1) {
+        last_sent_rowid = 0;
+        return false;
+    }
+    if (best_rank == 2) {
+        (*maa->stats.IND_NumSameBankRowSwitches[my_unit_id])++;
+    } else if (best_rank == 1 && first_rank == 2) {
+        (*maa->stats.IND_NumBankConflictsAvoided[my_unit_id])++;
+    }
+    last_sent_rowid = best_rowid;
+    last_sent_grow_addr = entries[best_rowid].grow_addr;
+    last_picked_grow_addr = last_sent_grow_addr;
+    last_sent_bank = get_bank(last_sent_grow_addr);
+    // Send all rows of the DRAM row back to back, starting from the lowest one
+    last_sent_grow_rowid = 0;
+    get_send_grow_rowid();
+    DPRINTF(MAARowTable, "ROT[%d] %s: ROW[%d] grow[0x%lx] of bank[%d] with %d in flight picked!\n", my_table_id, __func__, last_sent_grow_rowid, last_sent_grow_addr, last_sent_bank, best_inflight);
+    return true;
 }
 void RowTableSlice::get_send_grow_rowid() {
-    for (; last_sent_grow_rowid < num_RT_rows_per_slice; last_sent_grow_rowid++) {
-        if (entries_valid[last_sent_grow_rowid] == true && entries_sent[last_sent_grow_rowid] == false && entries[last_sent_grow_rowid].grow_addr == last_sent_grow_addr) {
+    // Rows of the DRAM row inserted while sending can take any free row, so wrap around
+    for (int i = 0; i < num_RT_rows_per_slice; i++) {
+        int rowid = (last_sent_grow_rowid + i) % num_RT_rows_per_slice;
+        if (entries_valid[rowid] == true && entries_sent[rowid] == false && entries[rowid].grow_addr == last_sent_grow_addr) {
+            last_sent_grow_rowid = rowid;
             return;
         }
     }
@@ -456,6 +883,7 @@ bool RowTableSlice::get_entry_send(Addr &addr, bool drain) {
         panic_if(entries_sent[last_sent_grow_rowid] == true, "Row[%d] is already sent: grow_addr(0x%lx)!\n", last_sent_grow_rowid, last_sent_grow_addr);
         if (entries[last_sent_grow_rowid].get_entry_send(addr)) {
             DPRINTF(MAARowTable, "ROT[%d] %s: ROW[%d] retuned!\n", my_table_id, __func__, last_sent_grow_rowid);
+            bank_inflight[last_sent_bank]++;
             return true;
         } else {
             DPRINTF(MAARowTable, "ROT[%d] %s: ROW[%d] finished!\n", my_table_id, __func__, last_sent_grow_rowid);
@@ -465,37 +893,50 @@ bool RowTableSlice::get_entry_send(Addr &addr, bool drain) {
     }
     return false;
 }
-std::vector<OffsetTableEntry> RowTableSlice::get_entry_recv(Addr grow_addr, Addr addr, bool check_sent) {
-    std::vector<OffsetTableEntry> results;
-    for (int i = 0; i < num_RT_rows_per_slice; i++) {
-        if (entries_valid[i] == true && (check_sent == false || entries_sent[i] == true) && entries[i].grow_addr == grow_addr) {
-            std::vector<OffsetTableEntry> result = entries[i].get_entry_recv(addr);
-            if (result.size() == 0) {
-                DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] addr[0x%lx] hit with ROW[%d] but no CLs returned!\n", my_table_id, __func__, grow_addr, addr, i);
-                continue;
-            }
-            DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] addr[0x%lx] hit with ROW[%d], %d entries returned!\n", my_table_id, __func__, grow_addr, addr, i, result.size());
-            panic_if(results.size() != 0, "ROT[%d] %s: duplicate entry is not allowed!\n", my_table_id, __func__);
-            results.insert(results.begin(), result.begin(), result.end());
-            if (entries[i].all_entries_received()) {
-                DPRINTF(MAARowTable, "ROT[%d] %s: all ROW[%d] entries received, setting to invalid!\n", my_table_id, __func__, i);
-                entries_valid[i] = false;
-                entries_sent[i] = false;
-                entries[i].check_reset();
-            }
+int RowTableSlice::find_entry_recv(Addr grow_addr, Addr addr, bool check_sent) {
+    for (int pos = CL_index.find(grow_addr, addr); pos != -1; pos = CL_index.find(grow_addr, addr, pos)) {
+        if (check_sent == false || entries_sent[CL_index.slots[pos].row] == true) {
+            return pos;
         }
     }
-    std::sort(results.begin(), results.end(), [](const OffsetTableEntry& a, const OffsetTableEntry& b) {
-        return a.itr < b.itr;
-    });
-    return results;
+    return -1;
 }
-bool RowTableSlice::is_full() {
-    for (int i = 0; i < num_RT_rows_per_slice; i++) {
-        if (entries_valid[i] == false) {
-            return false;
+int RowTableSlice::get_entry_recv(Addr grow_addr, Addr addr, bool check_sent) {
+    int pos = find_entry_recv(grow_addr, addr, check_sent);
+    if (pos == -1) {
+        return -1;
+    }
+    int i = CL_index.slots[pos].row;
+    int col_id = CL_index.slots[pos].col;
+    assert(entries_valid[i] == true);
+    if (check_sent) {
+        // Only requests sent by get_entry_send are counted in flight
+        int bank = get_bank(grow_addr);
+        assert(bank_inflight[bank] > 0);
+        bank_inflight[bank]--;
+    }
+    CL_index.remove(pos);
+    num_valid_entries--;
+    int first_itr = entries[i].get_entry_recv(col_id);
+    DPRINTF(MAARowTable, "ROT[%d] %s: grow[0x%lx] addr[0x%lx] hit with ROW[%d], first itr[%d] returned!\n", my_table_id, __func__, grow_addr, addr, i, first_itr);
+    if (entries[i].all_entries_received()) {
+        DPRINTF(MAARowTable, "ROT[%d] %s: all ROW[%d] entries received, setting to invalid!\n", my_table_id, __func__, i);
+        for (int row_pos = row_index.find(grow_addr, 0); row_pos != -1; row_pos = row_index.find(grow_addr, 0, row_pos)) {
+            if (row_index.slots[row_pos].row == i) {
+                row_index.remove(row_pos);
+                break;
+            }
         }
+        entries_valid[i] = false;
+        entries_sent[i] = false;
+        set_row_free(i, true);
+        num_valid_rows--;
+        entries[i].check_reset();
     }
-    return true;
+    panic_if(find_entry_recv(grow_addr, addr, check_sent) != -1, "ROT[%d] %s: duplicate entry is not allowed!\n", my_table_id, __func__);
+    return first_itr;
+}
+bool RowTableSlice::is_full() {
+    return num_valid_rows == num_RT_rows_per_slice;
 }
 } // namespace gem5
\ No newline at end of file
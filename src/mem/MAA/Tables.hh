@@ -7,11 +7,184 @@
 #include <vector>
 
 #include "base/types.hh"
+#include "mem/MAA/IF.hh"
 
 namespace gem5 {
 
 class MAA;
 
+// Simulator-side index (not modeled in timing) from a (tag, addr) key to the
+// (row, column) of a table. It is an open-addressed table with linear probing
+// and backward-shift deletion. Duplicate keys are allowed, e.g., a sent and a
+// not-yet-sent row of a row table slice may hold the same cache line.
+class TableIndex {
+public:
+    struct Slot {
+        Addr tag;
+        Addr addr;
+        int row;
+        int col;
+    };
+    TableIndex() {
+        slots = nullptr;
+    }
+    ~TableIndex() {
+        if (slots != nullptr) {
+            delete[] slots;
+        }
+    }
+    void allocate(int _num_keys);
+    // Returns the next slot matching the key after pos (-1: from the start)
+    int find(Addr tag, Addr addr, int pos = -1);
+    void insert(Addr tag, Addr addr, int row, int col);
+    void remove(int pos);
+    void reset();
+    Slot *slots;
+    int num_slots;
+    int mask;
+    int size;
+
+protected:
+    int hash(Addr tag, Addr addr);
+};
+
+// Bounded open-addressed map from an address to a value, used for the
+// per-instruction bookkeeping of the functional units (unique addresses,
+// latency histories, and element indices). Erased keys leave a tombstone that
+// is reused by later insertions; the table is expected to be reset once per
+// instruction.
+template <typename T>
+class AddrValueTable {
+public:
+    AddrValueTable() {
+        slots = nullptr;
+    }
+    ~AddrValueTable() {
+        if (slots != nullptr) {
+            delete[] slots;
+        }
+    }
+    void allocate(int _num_keys);
+    // Inserts or overwrites addr, returns true if addr did not exist
+    bool insert(Addr addr, T value = 0);
+    bool find(Addr addr, T &value);
+    bool erase(Addr addr);
+    void reset();
+    int size;
+
+protected:
+    enum class SlotState : uint8_t {
+        Empty = 0,
+        Valid = 1,
+        Erased = 2
+    };
+    struct Slot {
+        Addr addr;
+        T value;
+        SlotState state;
+    };
+    Slot *slots;
+    int num_slots;
+    int mask;
+    int num_used_slots;
+    int hash(Addr addr);
+    int find_slot(Addr addr);
+    void rehash();
+};
+// Addresses to ticks
+using AddrTable = AddrValueTable<Tick>;
+
+// Simulator-side memo (not modeled in timing) of the page translations of a
+// function unit, direct-mapped on the virtual page number. It only holds the
+// translations of the current instruction and is reset when the unit decodes
+// the next one, so a context switch, a region clear, or a TLB flush between
+// instructions is never observed stale.
+class TranslationMemo {
+public:
+    static const int num_entries = 64;
+    static const Addr page_size = 4096;
+    TranslationMemo() {
+        reset();
+    }
+    // Returns true and sets paddr if the page of vaddr is memoized
+    bool find(Addr vaddr, Addr &paddr);
+    void insert(Addr vaddr, Addr paddr);
+    void reset();
+
+protected:
+    struct Entry {
+        Addr vpn;
+        Addr ppn;
+        bool valid;
+    };
+    Entry entries[num_entries];
+};
+
+// Timing model of the TLB of a function unit (the translation itself is done
+// by the MMU). It is set-associative with LRU replacement, and all data is
+// assumed to be mapped by pages of page_size. A miss is walked by reading one
+// PTE per page table level over the cache side port: 4 levels for 4KiB, 3 for
+// 2MiB, and 2 for 1GiB pages. SE mode keeps no radix page table in memory, so
+// each level reads a synthetic PTE in its own part of the top page_table_size
+// bytes of physical memory, indexed like a radix table so that neighbouring
+// pages share PTE lines. A single walker serves the misses in order, the unit
+// waits for the walk of a missed page and is woken up when it finishes.
+class TranslationBuffer {
+public:
+    enum class Lookup : uint8_t {
+        Hit = 0,
+        Miss = 1,
+        Pending = 2
+    };
+    TranslationBuffer() : entries(nullptr), num_entries(0) {}
+    ~TranslationBuffer();
+    void allocate(int _num_entries, int _associativity, Addr _page_size, Cycles _hit_latency, Addr _page_table_size, FuncUnitType _unit_type, int _unit_id, MAA *_maa);
+    bool isEnabled() const { return num_entries != 0; }
+    // Hit: the translation is ready at ready_tick. Miss: a walk is queued for
+    // the page. Pending: the page is already being walked.
+    Lookup lookup(Addr vaddr, Tick &ready_tick);
+    bool isWalking() const { return walks.empty() == false; }
+    // Returns true if addr is the PTE line the walker waits for
+    bool isWalkAddr(Addr addr) const;
+    // Returns true if the response is consumed by the walker, walk_finished is
+    // set with the cycles from the miss if it was the last level of the walk
+    bool recvData(Addr addr, bool &walk_finished, Cycles &walk_cycles);
+    // In-flight walks are kept, their PTE reads are already outstanding
+    void flush();
+
+protected:
+    struct Entry {
+        Addr vpn;
+        uint64_t last_used;
+        bool valid;
+    };
+    struct Walk {
+        Addr vpn;
+        Tick miss_tick;
+    };
+    Entry *entries;
+    int num_entries;
+    int num_sets;
+    int associativity;
+    int num_walk_levels;
+    Addr page_size;
+    Cycles hit_latency;
+    Addr page_table_addr;
+    Addr level_table_size;
+    FuncUnitType unit_type;
+    int unit_id;
+    // walks[0] is in flight, reading the PTE of walk_level at walk_addr
+    std::vector<Walk> walks;
+    int walk_level;
+    Addr walk_addr;
+    uint64_t num_lookups;
+    const Addr block_size = 64;
+    MAA *maa;
+    Addr getPTEAddr(Addr vpn, int level);
+    void sendWalkPacket(Tick tick);
+    void fill(Addr vpn);
+};
+
 struct RequestTableEntry {
     RequestTableEntry() : itr(0), wid(0) {}
     RequestTableEntry(int _itr, uint16_t _wid) : itr(_itr), wid(_wid) {}
@@ -35,8 +208,14 @@ protected:
     unsigned int num_entries_per_address;
     RequestTableEntry **entries;
     bool **entries_valid;
+    int *num_entries;
     Addr *addresses;
     bool *addresses_valid;
+    // base_addr -> address slot of all valid addresses
+    TableIndex address_index;
+    // stack of the free address slots
+    int *free_addresses;
+    int num_free_addresses;
     MAA *maa;
     int my_unit_id;
     bool is_stream;
@@ -65,7 +244,8 @@ public:
                   MAA *_maa,
                   bool _is_stream = false);
     void insert(int itr, int wid, int last_itr);
-    std::vector<OffsetTableEntry> get_entry_recv(int first_itr);
+    // Returns the next itr of the chain after reading and invalidating itr
+    int get_entry_recv(int itr, int &wid);
     void reset();
     void check_reset();
     OffsetTableEntry *entries;
@@ -101,18 +281,19 @@ public:
                   OffsetTable *_offset_table,
                   MAA *_maa,
                   bool _is_stream = false);
-    bool insert(Addr addr, int itr, int wid);
-    bool find_addr(Addr addr);
+    void insert(int entry_id, int itr, int wid);
+    int insert_new(Addr addr, int itr, int wid);
     void reset();
     void check_reset();
     bool get_entry_send(Addr &addr);
-    std::vector<OffsetTableEntry> get_entry_recv(Addr addr);
+    int get_entry_recv(int entry_id);
     bool all_entries_received();
     OffsetTable *offset_table;
     Addr grow_addr;
     Entry *entries;
     bool *entries_valid;
     int num_RT_entries_per_row;
+    int num_valid_entries;
     int last_sent_entry_id;
     MAA *maa;
     int my_unit_id, my_table_id, my_table_row_id;
@@ -124,6 +305,8 @@ public:
         entries = nullptr;
         entries_valid = nullptr;
         entries_sent = nullptr;
+        rows_free = nullptr;
+        bank_inflight = nullptr;
         // entries_full = nullptr;
     }
     ~RowTableSlice() {
@@ -133,6 +316,10 @@ public:
             delete[] entries_valid;
             assert(entries_sent != nullptr);
             delete[] entries_sent;
+            assert(rows_free != nullptr);
+            delete[] rows_free;
+            assert(bank_inflight != nullptr);
+            delete[] bank_inflight;
             // assert(entries_full != nullptr);
             // delete[] entries_full;
         }
@@ -149,8 +336,11 @@ public:
     bool find_next_grow_addr();
     bool is_full();
     void get_send_grow_rowid();
-    std::vector<OffsetTableEntry>
-    get_entry_recv(Addr grow_addr, Addr addr, bool check_sent);
+    int get_free_rowid();
+    int find_entry_recv(Addr grow_addr, Addr addr, bool check_sent);
+    void set_row_free(int rowid, bool free);
+    // Returns the first itr of the received CL chain, -1 if not found
+    int get_entry_recv(Addr grow_addr, Addr addr, bool check_sent);
 
     void reset();
     void check_reset();
@@ -160,12 +350,29 @@ public:
     bool *entries_valid;
     bool *entries_sent;
     // bool *entries_full;
+    // (grow_addr, CL addr) -> (row, column) of all valid columns
+    TableIndex CL_index;
+    // (grow_addr, 0) -> row of all valid rows
+    TableIndex row_index;
+    // 1 bit per row, set when the row is free
+    uint64_t *rows_free;
+    int num_rows_free_words;
+    int num_valid_rows;
+    int num_valid_entries;
     int num_RT_rows_per_slice;
     int num_RT_entries_per_row;
     // int last_sent_row_id;
     Addr last_sent_grow_addr;
     int last_sent_rowid;
     int last_sent_grow_rowid;
+    // Sent and not yet received requests per bank of the slice, the next row
+    // to send is picked from the least busy bank other than the last one
+    int num_banks;
+    int *bank_inflight;
+    int last_sent_bank;
+    // DRAM row of the last picked rows, a later row of it is a row hit
+    Addr last_picked_grow_addr;
+    int get_bank(Addr grow_addr);
     MAA *maa;
     int my_unit_id, my_table_id;
     bool is_stream;